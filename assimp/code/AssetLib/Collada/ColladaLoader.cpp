@@ -45,6 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ColladaLoader.h"
 #include "ColladaParser.h"
+#include "Common/ParallelFor.h"
 #include <assimp/ColladaMetaData.h>
 #include <assimp/CreateAnimMesh.h>
 #include <assimp/ParsingUtils.h>
@@ -95,6 +96,9 @@ ColladaLoader::ColladaLoader() :
         removeEmptyBones(false),
         ignoreUpDirection(false),
         useColladaName(false),
+        streaming(false),
+        numThreads(1),
+        mDeferMeshData(false),
         mNodeNameCounter(0) {
     // empty
 }
@@ -122,6 +126,8 @@ void ColladaLoader::SetupProperties(const Importer *pImp) {
     removeEmptyBones = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_REMOVE_EMPTY_BONES, true) != 0;
     ignoreUpDirection = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_COLLADA_IGNORE_UP_DIRECTION, 0) != 0;
     useColladaName = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_COLLADA_USE_COLLADA_NAMES, 0) != 0;
+    streaming = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_COLLADA_STREAMING, 0) != 0;
+    numThreads = GetNumWorkerThreads(pImp->GetPropertyInteger(AI_CONFIG_IMPORT_COLLADA_NUM_THREADS, 1));
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -143,20 +149,32 @@ void ColladaLoader::InternReadFile(const std::string &pFile, aiScene *pScene, IO
     newMats.clear();
     mTextures.clear();
     mAnims.clear();
+    mDeferredMeshes.clear();
 
     // parse the input file
-    ColladaParser parser(pIOHandler, pFile);
+    ColladaParser parser(pIOHandler, pFile, streaming);
 
     // reserve some storage to avoid unnecessary reallocs
     newMats.reserve(parser.mMaterialLibrary.size() * 2u);
     mMeshes.reserve(parser.mMeshLibrary.size() * 2u);
 
+    // morph targets are looked up among the meshes already created, so their data must be complete
+    mDeferMeshData = numThreads > 1;
+    for (const auto &controller : parser.mControllerLibrary) {
+        if (controller.second.mType == Collada::Morph) {
+            mDeferMeshData = false;
+        }
+    }
+
     // create the materials first, for the meshes to find
     BuildMaterials(parser, pScene);
 
     // build the node hierarchy from it
     pScene->mRootNode = BuildHierarchy(parser, parser.mRootNode);
 
+    // ... then fill the meshes it references
+    CreateDeferredMeshData();
+
     // ... then fill the materials with the now adjusted settings
     FillMaterials(parser, pScene);
 
@@ -454,58 +472,13 @@ aiMesh *ColladaLoader::CreateMesh(const ColladaParser &pParser, const Mesh *pSrc
     // count the vertices addressed by its faces
     const size_t numVertices = std::accumulate(pSrcMesh->mFaceSize.begin() + pStartFace,
             pSrcMesh->mFaceSize.begin() + pStartFace + pSubMesh.mNumFaces, size_t(0));
-
-    // copy positions
     dstMesh->mNumVertices = static_cast<unsigned int>(numVertices);
-    dstMesh->mVertices = new aiVector3D[numVertices];
-    std::copy(pSrcMesh->mPositions.begin() + pStartVertex, pSrcMesh->mPositions.begin() + pStartVertex + numVertices, dstMesh->mVertices);
-
-    // normals, if given. HACK: (thom) Due to the glorious Collada spec we never
-    // know if we have the same number of normals as there are positions. So we
-    // also ignore any vertex attribute if it has a different count
-    if (pSrcMesh->mNormals.size() >= pStartVertex + numVertices) {
-        dstMesh->mNormals = new aiVector3D[numVertices];
-        std::copy(pSrcMesh->mNormals.begin() + pStartVertex, pSrcMesh->mNormals.begin() + pStartVertex + numVertices, dstMesh->mNormals);
-    }
 
-    // tangents, if given.
-    if (pSrcMesh->mTangents.size() >= pStartVertex + numVertices) {
-        dstMesh->mTangents = new aiVector3D[numVertices];
-        std::copy(pSrcMesh->mTangents.begin() + pStartVertex, pSrcMesh->mTangents.begin() + pStartVertex + numVertices, dstMesh->mTangents);
-    }
-
-    // bitangents, if given.
-    if (pSrcMesh->mBitangents.size() >= pStartVertex + numVertices) {
-        dstMesh->mBitangents = new aiVector3D[numVertices];
-        std::copy(pSrcMesh->mBitangents.begin() + pStartVertex, pSrcMesh->mBitangents.begin() + pStartVertex + numVertices, dstMesh->mBitangents);
-    }
-
-    // same for texture coords, as many as we have
-    // empty slots are not allowed, need to pack and adjust UV indexes accordingly
-    for (size_t a = 0, real = 0; a < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++a) {
-        if (pSrcMesh->mTexCoords[a].size() >= pStartVertex + numVertices) {
-            dstMesh->mTextureCoords[real] = new aiVector3D[numVertices];
-            for (size_t b = 0; b < numVertices; ++b) {
-                dstMesh->mTextureCoords[real][b] = pSrcMesh->mTexCoords[a][pStartVertex + b];
-            }
-
-            dstMesh->mNumUVComponents[real] = pSrcMesh->mNumUVComponents[a];
-            ++real;
-        }
-    }
-
-    // create faces. Due to the fact that each face uses unique vertices, we can simply count up on each vertex
-    size_t vertex = 0;
-    dstMesh->mNumFaces = static_cast<unsigned int>(pSubMesh.mNumFaces);
-    dstMesh->mFaces = new aiFace[dstMesh->mNumFaces];
-    for (size_t a = 0; a < dstMesh->mNumFaces; ++a) {
-        size_t s = pSrcMesh->mFaceSize[pStartFace + a];
-        aiFace &face = dstMesh->mFaces[a];
-        face.mNumIndices = static_cast<unsigned int>(s);
-        face.mIndices = new unsigned int[s];
-        for (size_t b = 0; b < s; ++b) {
-            face.mIndices[b] = static_cast<unsigned int>(vertex++);
-        }
+    if (mDeferMeshData) {
+        DeferredMesh deferred = { dstMesh.get(), pSrcMesh, &pSubMesh, pStartVertex, pStartFace };
+        mDeferredMeshes.push_back(deferred);
+    } else {
+        CreateMeshData(dstMesh.get(), pSrcMesh, pSubMesh, pStartVertex, pStartFace);
     }
 
     // create morph target meshes if any
@@ -697,6 +670,75 @@ aiMesh *ColladaLoader::CreateMesh(const ColladaParser &pParser, const Mesh *pSrc
     return dstMesh.release();
 }
 
+// ------------------------------------------------------------------------------------------------
+// Copies the vertices and faces of the given ColladaMesh face subset
+void ColladaLoader::CreateMeshData(aiMesh *pDstMesh, const Mesh *pSrcMesh, const SubMesh &pSubMesh,
+        size_t pStartVertex, size_t pStartFace) {
+    const size_t numVertices = pDstMesh->mNumVertices;
+
+    // copy positions
+    pDstMesh->mVertices = new aiVector3D[numVertices];
+    std::copy(pSrcMesh->mPositions.begin() + pStartVertex, pSrcMesh->mPositions.begin() + pStartVertex + numVertices, pDstMesh->mVertices);
+
+    // normals, if given. HACK: (thom) Due to the glorious Collada spec we never
+    // know if we have the same number of normals as there are positions. So we
+    // also ignore any vertex attribute if it has a different count
+    if (pSrcMesh->mNormals.size() >= pStartVertex + numVertices) {
+        pDstMesh->mNormals = new aiVector3D[numVertices];
+        std::copy(pSrcMesh->mNormals.begin() + pStartVertex, pSrcMesh->mNormals.begin() + pStartVertex + numVertices, pDstMesh->mNormals);
+    }
+
+    // tangents, if given.
+    if (pSrcMesh->mTangents.size() >= pStartVertex + numVertices) {
+        pDstMesh->mTangents = new aiVector3D[numVertices];
+        std::copy(pSrcMesh->mTangents.begin() + pStartVertex, pSrcMesh->mTangents.begin() + pStartVertex + numVertices, pDstMesh->mTangents);
+    }
+
+    // bitangents, if given.
+    if (pSrcMesh->mBitangents.size() >= pStartVertex + numVertices) {
+        pDstMesh->mBitangents = new aiVector3D[numVertices];
+        std::copy(pSrcMesh->mBitangents.begin() + pStartVertex, pSrcMesh->mBitangents.begin() + pStartVertex + numVertices, pDstMesh->mBitangents);
+    }
+
+    // same for texture coords, as many as we have
+    // empty slots are not allowed, need to pack and adjust UV indexes accordingly
+    for (size_t a = 0, real = 0; a < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++a) {
+        if (pSrcMesh->mTexCoords[a].size() >= pStartVertex + numVertices) {
+            pDstMesh->mTextureCoords[real] = new aiVector3D[numVertices];
+            for (size_t b = 0; b < numVertices; ++b) {
+                pDstMesh->mTextureCoords[real][b] = pSrcMesh->mTexCoords[a][pStartVertex + b];
+            }
+
+            pDstMesh->mNumUVComponents[real] = pSrcMesh->mNumUVComponents[a];
+            ++real;
+        }
+    }
+
+    // create faces. Due to the fact that each face uses unique vertices, we can simply count up on each vertex
+    size_t vertex = 0;
+    pDstMesh->mNumFaces = static_cast<unsigned int>(pSubMesh.mNumFaces);
+    pDstMesh->mFaces = new aiFace[pDstMesh->mNumFaces];
+    for (size_t a = 0; a < pDstMesh->mNumFaces; ++a) {
+        size_t s = pSrcMesh->mFaceSize[pStartFace + a];
+        aiFace &face = pDstMesh->mFaces[a];
+        face.mNumIndices = static_cast<unsigned int>(s);
+        face.mIndices = new unsigned int[s];
+        for (size_t b = 0; b < s; ++b) {
+            face.mIndices[b] = static_cast<unsigned int>(vertex++);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Fills the deferred meshes, each of them is written by exactly one task
+void ColladaLoader::CreateDeferredMeshData() {
+    ParallelFor(mDeferredMeshes.size(), numThreads, [this](size_t i) {
+        const DeferredMesh &deferred = mDeferredMeshes[i];
+        CreateMeshData(deferred.mDstMesh, deferred.mSrcMesh, *deferred.mSubMesh, deferred.mStartVertex, deferred.mStartFace);
+    });
+    mDeferredMeshes.clear();
+}
+
 // ------------------------------------------------------------------------------------------------
 // Stores all meshes in the given scene
 void ColladaLoader::StoreSceneMeshes(aiScene *pScene) {
@@ -893,10 +935,12 @@ void ColladaLoader::CreateAnimation(aiScene *pScene, const ColladaParser &pParse
     std::vector<const aiNode *> nodes;
     CollectNodes(pScene->mRootNode, nodes);
 
-    std::vector<aiNodeAnim *> anims;
-    std::vector<aiMeshMorphAnim *> morphAnims;
+    // the channels of each node are resampled independently, one slot per node keeps their order
+    std::vector<aiNodeAnim *> nodeAnims(nodes.size(), nullptr);
+    std::vector<aiMeshMorphAnim *> nodeMorphAnims(nodes.size(), nullptr);
 
-    for (auto node : nodes) {
+    ParallelFor(nodes.size(), numThreads, [&](size_t n) {
+        const aiNode *node = nodes[n];
         // find all the collada anim channels which refer to the current node
         std::vector<ChannelEntry> entries;
         std::string nodeName = node->mName.data;
@@ -904,7 +948,7 @@ void ColladaLoader::CreateAnimation(aiScene *pScene, const ColladaParser &pParse
         // find the collada node corresponding to the aiNode
         const Node *srcNode = FindNode(pParser.mRootNode, nodeName);
         if (!srcNode) {
-            continue;
+            return;
         }
 
         // now check all channels if they affect the current node
@@ -1027,7 +1071,7 @@ void ColladaLoader::CreateAnimation(aiScene *pScene, const ColladaParser &pParse
 
         // if there's no channel affecting the current node, we skip it
         if (entries.empty()) {
-            continue;
+            return;
         }
 
         // resolve the data pointers for all anim channels. Find the minimum time while we're at it
@@ -1165,7 +1209,7 @@ void ColladaLoader::CreateAnimation(aiScene *pScene, const ColladaParser &pParse
                 mat.Decompose(dstAnim->mScalingKeys[a].mValue, dstAnim->mRotationKeys[a].mValue, dstAnim->mPositionKeys[a].mValue);
             }
 
-            anims.push_back(dstAnim);
+            nodeAnims[n] = dstAnim;
         }
 
         if (!entries.empty() && entries.front().mTimeAccessor->mCount > 0) {
@@ -1222,9 +1266,20 @@ void ColladaLoader::CreateAnimation(aiScene *pScene, const ColladaParser &pParse
                     }
                 }
 
-                morphAnims.push_back(morphAnim);
+                nodeMorphAnims[n] = morphAnim;
             }
         }
+    });
+
+    std::vector<aiNodeAnim *> anims;
+    std::vector<aiMeshMorphAnim *> morphAnims;
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        if (nodeAnims[n]) {
+            anims.push_back(nodeAnims[n]);
+        }
+        if (nodeMorphAnims[n]) {
+            morphAnims.push_back(nodeMorphAnims[n]);
+        }
     }
 
     if (!anims.empty() || !morphAnims.empty()) {
@@ -116,6 +116,13 @@ protected:
     aiMesh *CreateMesh(const ColladaParser &pParser, const Collada::Mesh *pSrcMesh, const Collada::SubMesh &pSubMesh,
             const Collada::Controller *pSrcController, size_t pStartVertex, size_t pStartFace);
 
+    /** Copies the vertices and faces of the given ColladaMesh face subset into a mesh created by CreateMesh() */
+    static void CreateMeshData(aiMesh *pDstMesh, const Collada::Mesh *pSrcMesh, const Collada::SubMesh &pSubMesh,
+            size_t pStartVertex, size_t pStartFace);
+
+    /** Fills the meshes whose vertex data was deferred by CreateMesh(), using all worker threads */
+    void CreateDeferredMeshData();
+
     /** Stores all meshes in the given scene */
     void StoreSceneMeshes(aiScene *pScene);
 
@@ -217,6 +224,21 @@ protected:
     bool removeEmptyBones;
     bool ignoreUpDirection;
     bool useColladaName;
+    bool streaming;
+    unsigned int numThreads;
+
+    /** Mesh whose vertex data is filled after the node hierarchy was built */
+    struct DeferredMesh {
+        aiMesh *mDstMesh;
+        const Collada::Mesh *mSrcMesh;
+        const Collada::SubMesh *mSubMesh;
+        size_t mStartVertex;
+        size_t mStartFace;
+    };
+
+    /** Whether CreateMesh() defers the vertex data, see CreateDeferredMeshData() */
+    bool mDeferMeshData;
+    std::vector<DeferredMesh> mDeferredMeshes;
 
     /** Used by FindNameForNode() to generate unique node names */
     unsigned int mNodeNameCounter;
@@ -46,12 +46,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ASSIMP_BUILD_NO_COLLADA_IMPORTER
 
 #include "ColladaParser.h"
+#include "Common/FastAtofArray.h"
 #include <assimp/ParsingUtils.h>
 #include <assimp/StringUtils.h>
 #include <assimp/ZipArchiveIOSystem.h>
 #include <assimp/commonMetaData.h>
 #include <assimp/fast_atof.h>
 #include <assimp/IOSystem.hpp>
+#include <assimp/MemoryIOWrapper.h>
+#include <cstring>
 #include <memory>
 #include <utility>
 
@@ -80,9 +83,167 @@ static void readUrlAttribute(XmlNode &node, std::string &url) {
     url = url.c_str() + 1;
 }
 
+// ------------------------------------------------------------------------------------------------
+// Parses the text content of a <float_array>, <Name_array> or <IDREF_array> into the given data array
+static void ParseDataArray(Collada::Data &data, bool isStringArray, unsigned int count, std::string &v) {
+    v = ai_trim(v);
+    const char *content = v.c_str();
+
+    data.mIsStringArray = isStringArray;
+
+    // some exporters write empty data arrays, but we need to conserve them anyways because others might reference them
+    if (content) {
+        if (isStringArray) {
+            data.mStrings.reserve(count);
+            std::string s;
+
+            for (unsigned int a = 0; a < count; a++) {
+
+                s.clear();
+                while (!IsSpaceOrNewLine(*content))
+                    s += *content++;
+                data.mStrings.push_back(s);
+
+                SkipSpacesAndLineEnd(&content);
+            }
+        } else {
+            // read all numbers at once
+            data.mValues.resize(count);
+            if (count > 0) {
+                fast_atoreal_array<ai_real>(content, v.c_str() + v.size(), &data.mValues[0], count);
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Parses a list of whitespace separated integers, negative values are clamped to zero
+static void ParseIndexList(const std::string &text, std::vector<unsigned int> &values) {
+    size_t count = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (!IsSpaceOrNewLine(text[i]) && (i == 0 || IsSpaceOrNewLine(text[i - 1]))) {
+            ++count;
+        }
+    }
+    values.reserve(count);
+
+    const char *content = text.c_str();
+    SkipSpacesAndLineEnd(&content);
+    while (*content != 0) {
+        const char *start = content;
+        values.push_back(static_cast<unsigned int>(std::max(0, strtol10(content, &content))));
+        if (content == start || !IsSpaceOrNewLine(*content)) {
+            throw DeadlyImportError("Collada: Expected an index, found \"", std::string(start, std::min<size_t>(strcspn(start, " \t\r\n"), 32)), "\"");
+        }
+        SkipSpacesAndLineEnd(&content);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns the end of the markup starting at buffer[lt], npos if it is not complete yet
+static size_t FindMarkupEnd(const std::string &buffer, size_t lt) {
+    static const size_t npos = std::string::npos;
+
+    // enough to tell comments and CDATA sections from tags
+    if (buffer.size() - lt < 9) {
+        return npos;
+    }
+
+    size_t end = npos;
+    if (buffer.compare(lt, 4, "<!--") == 0) {
+        end = buffer.find("-->", lt + 4);
+        return end == npos ? npos : end + 3;
+    }
+    if (buffer.compare(lt, 9, "<![CDATA[") == 0) {
+        end = buffer.find("]]>", lt + 9);
+        return end == npos ? npos : end + 3;
+    }
+    if (buffer.compare(lt, 2, "<?") == 0) {
+        end = buffer.find("?>", lt + 2);
+        return end == npos ? npos : end + 2;
+    }
+
+    // tags and declarations, '>' may appear in quoted values and internal DTD subsets
+    char quote = 0;
+    int depth = 0;
+    for (size_t i = lt + 1; i < buffer.size(); ++i) {
+        const char c = buffer[i];
+        if (quote) {
+            if (c == quote) {
+                quote = 0;
+            }
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '[') {
+            ++depth;
+        } else if (c == ']') {
+            --depth;
+        } else if (c == '>' && depth <= 0) {
+            return i + 1;
+        }
+    }
+
+    return npos;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns the element name of the markup [lt, end) if it is a start tag whose content the streaming reader parses
+static bool IsStreamedStartTag(const std::string &buffer, size_t lt, size_t end, std::string &name) {
+    const char first = buffer[lt + 1];
+    if (first == '/' || first == '!' || first == '?' || buffer[end - 2] == '/') {
+        return false;
+    }
+
+    size_t nameEnd = lt + 1;
+    while (nameEnd < end && !IsSpaceOrNewLine(buffer[nameEnd]) && buffer[nameEnd] != '>' && buffer[nameEnd] != '/') {
+        ++nameEnd;
+    }
+    name.assign(buffer, lt + 1, nameEnd - lt - 1);
+
+    return name == "float_array" || name == "Name_array" || name == "IDREF_array" ||
+           name == "p" || name == "vcount" || name == "v";
+}
+
+// ------------------------------------------------------------------------------------------------
+// Checks whether the markup [lt, gt] is the end tag of the given element
+static bool IsEndTag(const std::string &buffer, size_t lt, size_t gt, const std::string &name) {
+    if (buffer[lt + 1] != '/' || buffer.compare(lt + 2, name.size(), name) != 0) {
+        return false;
+    }
+    for (size_t i = lt + 2 + name.size(); i < gt; ++i) {
+        if (!IsSpaceOrNewLine(buffer[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Reads an unsigned attribute from the text of a start tag
+static unsigned int GetTagUIntAttribute(const std::string &tag, const char *name) {
+    const size_t length = strlen(name);
+    for (size_t at = tag.find(name); at != std::string::npos; at = tag.find(name, at + length)) {
+        if (at == 0 || !IsSpaceOrNewLine(tag[at - 1])) {
+            continue;
+        }
+
+        const char *c = tag.c_str() + at + length;
+        SkipSpacesAndLineEnd(&c);
+        if (*c++ != '=') {
+            continue;
+        }
+        SkipSpacesAndLineEnd(&c);
+        if (*c == '"' || *c == '\'') {
+            ++c;
+        }
+        return strtoul10(c);
+    }
+    return 0;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
-ColladaParser::ColladaParser(IOSystem *pIOHandler, const std::string &pFile) :
+ColladaParser::ColladaParser(IOSystem *pIOHandler, const std::string &pFile, bool streaming) :
         mFileName(pFile),
         mXmlParser(),
         mDataLibrary(),
@@ -97,7 +258,10 @@ ColladaParser::ColladaParser(IOSystem *pIOHandler, const std::string &pFile) :
         mAnims(),
         mUnitSize(1.0f),
         mUpDirection(UP_Y),
-        mFormat(FV_1_5_n) {
+        mFormat(FV_1_5_n),
+        mStreamedData(),
+        mStreamedIndices(),
+        mStreamedElements() {
 
     std::unique_ptr<IOStream> daefile;
     std::unique_ptr<ZipArchiveIOSystem> zip_archive;
@@ -119,7 +283,9 @@ ColladaParser::ColladaParser(IOSystem *pIOHandler, const std::string &pFile) :
     }
 
     // generate a XML reader for it
-    if (!mXmlParser.parse(daefile.get())) {
+    if (!streaming || !ReadStreamed(daefile.get())) {
+        if (!mXmlParser.parse(daefile.get())) {
+        }
     }
     // start reading
     XmlNode node = mXmlParser.getRootNode();
@@ -146,6 +312,153 @@ ColladaParser::~ColladaParser() {
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// Reads the file in chunks, leaving the contents of the bulk arrays out of the DOM
+bool ColladaParser::ReadStreamed(IOStream *stream) {
+    static const size_t ChunkSize = 1024 * 1024;
+    static const size_t npos = std::string::npos;
+
+    if (stream == nullptr) {
+        return false;
+    }
+
+    std::vector<char> chunk(ChunkSize);
+    size_t read = stream->Read(chunk.data(), 1, chunk.size());
+
+    // the scanner works on ASCII compatible encodings only
+    if (read == 0 || memchr(chunk.data(), 0, read) != nullptr) {
+        stream->Seek(0, aiOrigin_SET);
+        return false;
+    }
+
+    std::string buffer(chunk.data(), read);
+    std::string skeleton;
+    std::string startTag, name, text;
+    bool inElement = false;
+    size_t pos = 0;
+
+    // drops the consumed input and appends the next chunk, false at the end of the file
+    auto readMore = [&]() {
+        buffer.erase(0, pos);
+        pos = 0;
+        read = stream->Read(chunk.data(), 1, chunk.size());
+        buffer.append(chunk.data(), read);
+        return read > 0;
+    };
+
+    for (;;) {
+        const size_t lt = buffer.find('<', pos);
+        if (!inElement) {
+            // plain markup and text, copied over to the DOM
+            if (lt == npos) {
+                skeleton.append(buffer, pos, npos);
+                pos = buffer.size();
+                if (!readMore()) {
+                    break;
+                }
+                continue;
+            }
+
+            skeleton.append(buffer, pos, lt - pos);
+            pos = lt;
+
+            const size_t end = FindMarkupEnd(buffer, lt);
+            if (end == npos) {
+                if (!readMore()) {
+                    skeleton.append(buffer, pos, npos);
+                    break;
+                }
+                continue;
+            }
+
+            if (IsStreamedStartTag(buffer, lt, end, name)) {
+                startTag.assign(buffer, lt, end - lt);
+                text.clear();
+                inElement = true;
+            } else {
+                skeleton.append(buffer, lt, end - lt);
+            }
+            pos = end;
+            continue;
+        }
+
+        // content of a bulk element, collected up to its end tag
+        if (lt == npos) {
+            text.append(buffer, pos, npos);
+            pos = buffer.size();
+            if (!readMore()) {
+                skeleton += startTag;
+                skeleton += text;
+                break;
+            }
+            continue;
+        }
+
+        text.append(buffer, pos, lt - pos);
+        pos = lt;
+
+        const size_t gt = buffer.find('>', lt);
+        if (gt == npos) {
+            if (!readMore()) {
+                skeleton += startTag;
+                skeleton += text;
+                skeleton.append(buffer, pos, npos);
+                break;
+            }
+            continue;
+        }
+
+        inElement = false;
+        if (!IsEndTag(buffer, lt, gt, name) || text.find('&') != npos) {
+            // nested markup or entities, leave it to the XML parser
+            skeleton += startTag;
+            skeleton += text;
+            continue;
+        }
+        pos = gt + 1;
+
+        unsigned int index = 0;
+        if (name == "p" || name == "vcount" || name == "v") {
+            index = static_cast<unsigned int>(mStreamedIndices.size());
+            mStreamedIndices.emplace_back();
+            ParseIndexList(text, mStreamedIndices.back());
+        } else {
+            index = static_cast<unsigned int>(mStreamedData.size());
+            mStreamedData.emplace_back();
+            ParseDataArray(mStreamedData.back(), name != "float_array", GetTagUIntAttribute(startTag, "count"), text);
+        }
+
+        // keep the element and its attributes without the text. The DOM node is found by the
+        // position of its name in the markup, which the input file has no control over.
+        mStreamedElements[static_cast<ptrdiff_t>(skeleton.size() + 1)] = index;
+        skeleton += startTag;
+        skeleton += "</" + name + ">";
+    }
+
+    std::string().swap(buffer);
+    std::string().swap(text);
+
+    MemoryIOStream skeletonStream(reinterpret_cast<const uint8_t *>(skeleton.data()), skeleton.size());
+    if (!mXmlParser.parse(&skeletonStream)) {
+    }
+
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns the index of the streamed content of the given element
+bool ColladaParser::GetStreamedIndex(const XmlNode &node, unsigned int &index) const {
+    if (mStreamedElements.empty()) {
+        return false;
+    }
+    const auto it = mStreamedElements.find(node.offset_debug());
+    if (it == mStreamedElements.end()) {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Read a ZAE manifest and return the filename to attempt to open
 std::string ColladaParser::ReadZaeManifest(ZipArchiveIOSystem &zip_archive) {
@@ -683,6 +996,19 @@ void ColladaParser::ReadControllerWeights(XmlNode &node, Collada::Controller &pC
                 pController.mWeightInputWeights = channel;
             }
         } else if (currentName == "vcount" && vertexCount > 0) {
+            unsigned int streamed = 0;
+            if (GetStreamedIndex(currentNode, streamed) && streamed < mStreamedIndices.size()) {
+                std::vector<unsigned int> &values = mStreamedIndices[streamed];
+                size_t numWeights = 0;
+                for (size_t i = 0; i < pController.mWeightCounts.size(); ++i) {
+                    pController.mWeightCounts[i] = i < values.size() ? values[i] : 0;
+                    numWeights += pController.mWeightCounts[i];
+                }
+                pController.mWeights.resize(numWeights);
+                std::vector<unsigned int>().swap(values);
+                continue;
+            }
+
             const char *text = currentNode.text().as_string();
             size_t numWeights = 0;
             for (std::vector<size_t>::iterator it = pController.mWeightCounts.begin(); it != pController.mWeightCounts.end(); ++it) {
@@ -695,6 +1021,17 @@ void ColladaParser::ReadControllerWeights(XmlNode &node, Collada::Controller &pC
             pController.mWeights.resize(numWeights);
         } else if (currentName == "v" && vertexCount > 0) {
             // read JointIndex - WeightIndex pairs
+            unsigned int streamed = 0;
+            if (GetStreamedIndex(currentNode, streamed) && streamed < mStreamedIndices.size()) {
+                std::vector<unsigned int> &values = mStreamedIndices[streamed];
+                for (size_t i = 0; i < pController.mWeights.size(); ++i) {
+                    pController.mWeights[i].first = 2 * i < values.size() ? values[2 * i] : 0;
+                    pController.mWeights[i].second = 2 * i + 1 < values.size() ? values[2 * i + 1] : 0;
+                }
+                std::vector<unsigned int>().swap(values);
+                continue;
+            }
+
             std::string stdText;
             XmlParser::getValueAsString(currentNode, stdText);
             const char *text = stdText.c_str();
@@ -1213,45 +1550,20 @@ void ColladaParser::ReadDataArray(XmlNode &node) {
     XmlParser::getStdStrAttribute(node, "id", id);
     unsigned int count = 0;
     XmlParser::getUIntAttribute(node, "count", count);
+
+    // already parsed by the streaming reader
+    unsigned int streamed = 0;
+    if (GetStreamedIndex(node, streamed) && streamed < mStreamedData.size()) {
+        mDataLibrary[id] = std::move(mStreamedData[streamed]);
+        return;
+    }
+
     std::string v;
     XmlParser::getValueAsString(node, v);
-    v = ai_trim(v);
-    const char *content = v.c_str();
 
     // read values and store inside an array in the data library
     mDataLibrary[id] = Data();
-    Data &data = mDataLibrary[id];
-    data.mIsStringArray = isStringArray;
-
-    // some exporters write empty data arrays, but we need to conserve them anyways because others might reference them
-    if (content) {
-        if (isStringArray) {
-            data.mStrings.reserve(count);
-            std::string s;
-
-            for (unsigned int a = 0; a < count; a++) {
-
-                s.clear();
-                while (!IsSpaceOrNewLine(*content))
-                    s += *content++;
-                data.mStrings.push_back(s);
-
-                SkipSpacesAndLineEnd(&content);
-            }
-        } else {
-            data.mValues.reserve(count);
-
-            for (unsigned int a = 0; a < count; a++) {
-
-                // read a number
-                ai_real value;
-                content = fast_atoreal_move<ai_real>(content, value);
-                data.mValues.push_back(value);
-                // skip whitespace after it
-                SkipSpacesAndLineEnd(&content);
-            }
-        }
-    }
+    ParseDataArray(mDataLibrary[id], isStringArray, count, v);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1404,6 +1716,15 @@ void ColladaParser::ReadIndexData(XmlNode &node, Mesh &pMesh) {
                 if (numPrimitives) // It is possible to define a mesh without any primitives
                 {
                     // case <polylist> - specifies the number of indices for each polygon
+                    unsigned int streamed = 0;
+                    if (GetStreamedIndex(currentNode, streamed) && streamed < mStreamedIndices.size()) {
+                        std::vector<unsigned int> &values = mStreamedIndices[streamed];
+                        vcount.assign(values.begin(), values.begin() + std::min<size_t>(values.size(), numPrimitives));
+                        vcount.resize(numPrimitives, 0);
+                        std::vector<unsigned int>().swap(values);
+                        continue;
+                    }
+
                     std::string v;
                     XmlParser::getValueAsString(currentNode, v);
                     const char *content = v.c_str();
@@ -1508,7 +1829,12 @@ size_t ColladaParser::ReadPrimitives(XmlNode &node, Mesh &pMesh, std::vector<Inp
     }
 
     // It is possible to not contain any indices
-    if (pNumPrimitives > 0) {
+    unsigned int streamed = 0;
+    if (pNumPrimitives > 0 && GetStreamedIndex(node, streamed) && streamed < mStreamedIndices.size()) {
+        std::vector<unsigned int> &values = mStreamedIndices[streamed];
+        indices.assign(values.begin(), values.end());
+        std::vector<unsigned int>().swap(values);
+    } else if (pNumPrimitives > 0) {
         std::string v;
         XmlParser::getValueAsString(node, v);
         const char *content = v.c_str();
@@ -1516,7 +1842,11 @@ size_t ColladaParser::ReadPrimitives(XmlNode &node, Mesh &pMesh, std::vector<Inp
         while (*content != 0) {
             // read a value.
             // Hack: (thom) Some exporters put negative indices sometimes. We just try to carry on anyways.
+            const char *start = content;
             int value = std::max(0, strtol10(content, &content));
+            if (content == start || !IsSpaceOrNewLine(*content)) {
+                throw DeadlyImportError("Collada: Expected an index, found \"", std::string(start, std::min<size_t>(strcspn(start, " \t\r\n"), 32)), "\"");
+            }
             indices.push_back(size_t(value));
             // skip whitespace after it
             SkipSpacesAndLineEnd(&content);
@@ -51,7 +51,9 @@
 #include <assimp/TinyFormatter.h>
 #include <assimp/XmlParser.h>
 
+#include <cstddef>
 #include <map>
+#include <unordered_map>
 
 namespace Assimp {
 
@@ -73,8 +75,9 @@ protected:
     /** Map for generic metadata as aiString */
     typedef std::map<std::string, aiString> StringMetaData;
 
-    /** Constructor from XML file */
-    ColladaParser(IOSystem *pIOHandler, const std::string &pFile);
+    /** Constructor from XML file. In streaming mode the bulk arrays are parsed
+     *  while the file is read in chunks and are left out of the XML DOM. */
+    ColladaParser(IOSystem *pIOHandler, const std::string &pFile, bool streaming = false);
 
     /** Destructor */
     ~ColladaParser();
@@ -82,6 +85,15 @@ protected:
     /** Attempts to read the ZAE manifest and returns the DAE to open */
     static std::string ReadZaeManifest(ZipArchiveIOSystem &zip_archive);
 
+    /** Reads the file in chunks, parses the contents of the bulk array elements right away
+     *  and builds the XML DOM from the remaining markup only. Returns false if the file
+     *  cannot be streamed, the stream is rewound in that case. */
+    bool ReadStreamed(IOStream *stream);
+
+    /** Returns the index of the bulk content the streaming reader stored for the given
+     *  element, false if the element was read into the DOM as usual. */
+    bool GetStreamedIndex(const XmlNode &node, unsigned int &index) const;
+
     /** Reads the contents of the file */
     void ReadContents(XmlNode &node);
 
@@ -309,6 +321,15 @@ protected:
 
     /** Collada file format version */
     Collada::FormatVersion mFormat;
+
+    /** Data arrays and index lists parsed by the streaming reader, in order of
+     *  appearance. Their elements refer to them by index and are released once read. */
+    std::vector<Collada::Data> mStreamedData;
+    std::vector<std::vector<unsigned int>> mStreamedIndices;
+
+    /** Index of the streamed content of each placeholder element, keyed by the offset of
+     *  the element name in the markup handed to the XML parser. */
+    std::unordered_map<ptrdiff_t, unsigned int> mStreamedElements;
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -71,14 +71,15 @@ AnimationCurve::AnimationCurve(uint64_t id, const Element &element, const std::s
 
     }
 
+    // key attributes are rarely needed, they are decoded on first access
     const Element *KeyAttrDataFloat = sc["KeyAttrDataFloat"];
     if (KeyAttrDataFloat) {
-        ParseVectorDataArray(attributes, *KeyAttrDataFloat);
+        attributes.Set(*KeyAttrDataFloat);
     }
 
     const Element *KeyAttrFlags = sc["KeyAttrFlags"];
     if (KeyAttrFlags) {
-        ParseVectorDataArray(flags, *KeyAttrFlags);
+        flags.Set(*KeyAttrFlags);
     }
 }
 
@@ -52,6 +52,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FBXProperties.h"
 #include "FBXUtil.h"
 
+#include "Common/ParallelFor.h"
+
 #include <assimp/MathFunctions.h>
 #include <assimp/StringComparison.h>
 
@@ -100,6 +102,7 @@ FBXConverter::FBXConverter(aiScene *out, const Document &doc, bool removeEmptyBo
         ConvertOrphanedEmbeddedTextures();
     }
     ConvertRootNode();
+    ConvertDeferredMeshData();
 
     if (doc.Settings().readAllMaterials) {
         // unfortunately this means we have to evaluate all objects
@@ -882,11 +885,29 @@ static aiSkeleton *createAiSkeleton(SkeletonBoneContainer &sbc) {
     return skeleton;
 }
 
-unsigned int FBXConverter::ConvertMeshSingleMaterial(const MeshGeometry &mesh, const Model &model, const aiMatrix4x4 &absolute_transform,
-        aiNode *parent, aiNode *) {
-    const MatIndexArray &mindices = mesh.GetMaterialIndices();
-    aiMesh *const out_mesh = SetupEmptyMesh(mesh, parent);
+bool FBXConverter::CanDeferMeshData(const MeshGeometry &mesh) const {
+    // weights and blend shapes are resolved against the output vertices right away
+    if (doc.Settings().numThreads <= 1 || mesh.GetBlendShapes().size() > 0) {
+        return false;
+    }
+    return !doc.Settings().readWeights || mesh.DeformerSkin() == nullptr;
+}
 
+void FBXConverter::ConvertDeferredMeshData() {
+    // every task writes to its own, already registered aiMesh, so the
+    // order of mMeshes is the same as with the serial conversion
+    ParallelFor(mDeferredMeshes.size(), doc.Settings().numThreads, [this](size_t i) {
+        const DeferredMesh &deferred = mDeferredMeshes[i];
+        if (deferred.separateMaterials) {
+            ConvertMeshDataMultiMaterial(deferred.out, *deferred.mesh, deferred.materialIndex, nullptr, nullptr);
+        } else {
+            ConvertMeshData(deferred.out, *deferred.mesh);
+        }
+    });
+    mDeferredMeshes.clear();
+}
+
+void FBXConverter::ConvertMeshData(aiMesh *out_mesh, const MeshGeometry &mesh) {
     const std::vector<aiVector3D> &vertices = mesh.GetVertices();
     const std::vector<unsigned int> &faces = mesh.GetFaceIndexCounts();
 
@@ -978,6 +999,18 @@ unsigned int FBXConverter::ConvertMeshSingleMaterial(const MeshGeometry &mesh, c
 
         out_mesh->mNumUVComponents[i] = 2;
     }
+}
+
+unsigned int FBXConverter::ConvertMeshSingleMaterial(const MeshGeometry &mesh, const Model &model, const aiMatrix4x4 &absolute_transform,
+        aiNode *parent, aiNode *) {
+    const MatIndexArray &mindices = mesh.GetMaterialIndices();
+    aiMesh *const out_mesh = SetupEmptyMesh(mesh, parent);
+
+    if (CanDeferMeshData(mesh)) {
+        mDeferredMeshes.push_back({ out_mesh, &mesh, 0, false });
+    } else {
+        ConvertMeshData(out_mesh, mesh);
+    }
 
     if (!doc.Settings().readMaterials || mindices.empty()) {
         out_mesh->mMaterialIndex = GetDefaultMaterial();
@@ -1066,16 +1099,12 @@ FBXConverter::ConvertMeshMultiMaterial(const MeshGeometry &mesh, const Model &mo
     return indices;
 }
 
-unsigned int FBXConverter::ConvertMeshMultiMaterial(const MeshGeometry &mesh, const Model &model, const aiMatrix4x4 &absolute_transform,
-        MatIndexArray::value_type index, aiNode *parent, aiNode *) {
-    aiMesh *const out_mesh = SetupEmptyMesh(mesh, parent);
-
+void FBXConverter::ConvertMeshDataMultiMaterial(aiMesh *out_mesh, const MeshGeometry &mesh, MatIndexArray::value_type index,
+        std::vector<unsigned int> *reverseMapping, std::map<unsigned int, unsigned int> *translateIndexMap) {
     const MatIndexArray &mindices = mesh.GetMaterialIndices();
     const std::vector<aiVector3D> &vertices = mesh.GetVertices();
     const std::vector<unsigned int> &faces = mesh.GetFaceIndexCounts();
 
-    const bool process_weights = doc.Settings().readWeights && mesh.DeformerSkin() != nullptr;
-
     unsigned int count_faces = 0;
     unsigned int count_vertices = 0;
 
@@ -1092,10 +1121,8 @@ unsigned int FBXConverter::ConvertMeshMultiMaterial(const MeshGeometry &mesh, co
     }
 
     // mapping from output indices to DOM indexing, needed to resolve weights or blendshapes
-    std::vector<unsigned int> reverseMapping;
-    std::map<unsigned int, unsigned int> translateIndexMap;
-    if (process_weights || mesh.GetBlendShapes().size() > 0) {
-        reverseMapping.resize(count_vertices);
+    if (reverseMapping) {
+        reverseMapping->resize(count_vertices);
     }
 
     // allocate output data arrays, but don't fill them yet
@@ -1181,9 +1208,9 @@ unsigned int FBXConverter::ConvertMeshMultiMaterial(const MeshGeometry &mesh, co
         for (unsigned int i = 0; i < pcount; ++i, ++cursor, ++in_cursor) {
             f.mIndices[i] = cursor;
 
-            if (reverseMapping.size()) {
-                reverseMapping[cursor] = in_cursor;
-                translateIndexMap[in_cursor] = cursor;
+            if (reverseMapping) {
+                (*reverseMapping)[cursor] = in_cursor;
+                (*translateIndexMap)[in_cursor] = cursor;
             }
 
             out_mesh->mVertices[cursor] = vertices[in_cursor];
@@ -1203,6 +1230,24 @@ unsigned int FBXConverter::ConvertMeshMultiMaterial(const MeshGeometry &mesh, co
             }
         }
     }
+}
+
+unsigned int FBXConverter::ConvertMeshMultiMaterial(const MeshGeometry &mesh, const Model &model, const aiMatrix4x4 &absolute_transform,
+        MatIndexArray::value_type index, aiNode *parent, aiNode *) {
+    aiMesh *const out_mesh = SetupEmptyMesh(mesh, parent);
+
+    const bool process_weights = doc.Settings().readWeights && mesh.DeformerSkin() != nullptr;
+
+    // mapping from output indices to DOM indexing, needed to resolve weights or blendshapes
+    std::vector<unsigned int> reverseMapping;
+    std::map<unsigned int, unsigned int> translateIndexMap;
+    if (CanDeferMeshData(mesh)) {
+        mDeferredMeshes.push_back({ out_mesh, &mesh, index, true });
+    } else if (process_weights || mesh.GetBlendShapes().size() > 0) {
+        ConvertMeshDataMultiMaterial(out_mesh, mesh, index, &reverseMapping, &translateIndexMap);
+    } else {
+        ConvertMeshDataMultiMaterial(out_mesh, mesh, index, nullptr, nullptr);
+    }
 
     ConvertMaterialForMesh(out_mesh, model, mesh, index);
 
@@ -202,6 +202,24 @@ private:
     unsigned int ConvertMeshMultiMaterial(const MeshGeometry &mesh, const Model &model, const aiMatrix4x4 &absolute_transform, MatIndexArray::value_type index,
                                           aiNode *parent, aiNode *root_node);
 
+    // ------------------------------------------------------------------------------------------------
+    // true if the vertex data of this mesh can be filled in later, concurrently with other meshes
+    bool CanDeferMeshData(const MeshGeometry &mesh) const;
+
+    // ------------------------------------------------------------------------------------------------
+    // fills the vertex data of all deferred meshes, on up to Settings().numThreads threads
+    void ConvertDeferredMeshData();
+
+    // ------------------------------------------------------------------------------------------------
+    // copies vertex data and generates faces for a mesh with a single material
+    static void ConvertMeshData(aiMesh *out_mesh, const MeshGeometry &mesh);
+
+    // ------------------------------------------------------------------------------------------------
+    // copies vertex data and faces of the given material. If reverseMapping is given it receives
+    // the DOM index of each output vertex, and translateIndexMap the inverse of that mapping.
+    static void ConvertMeshDataMultiMaterial(aiMesh *out_mesh, const MeshGeometry &mesh, MatIndexArray::value_type index,
+            std::vector<unsigned int> *reverseMapping, std::map<unsigned int, unsigned int> *translateIndexMap);
+
     // ------------------------------------------------------------------------------------------------
     static const unsigned int NO_MATERIAL_SEPARATION = /* std::numeric_limits<unsigned int>::max() */
         static_cast<unsigned int>(-1);
@@ -432,6 +450,15 @@ private:
     using MeshMap = std::fbx_unordered_map<const Geometry*, std::vector<unsigned int> >;
     MeshMap meshes_converted;
 
+    // meshes registered in mMeshes whose vertex data is filled in after all nodes are converted
+    struct DeferredMesh {
+        aiMesh *out;
+        const MeshGeometry *mesh;
+        MatIndexArray::value_type materialIndex;
+        bool separateMaterials;
+    };
+    std::vector<DeferredMesh> mDeferredMeshes;
+
     // fixed node name -> which trafo chain components have animations?
     using NodeAnimBitMap = std::fbx_unordered_map<std::string, unsigned int> ;
     NodeAnimBitMap node_anim_chain_bits;
@@ -158,7 +158,7 @@ BlendShapeChannel::BlendShapeChannel(uint64_t id, const Element& element, const
     }
     const Element* const FullWeights = sc["FullWeights"];
     if (FullWeights) {
-        ParseVectorDataArray(fullWeights, *FullWeights);
+        fullWeights.Set(*FullWeights);
     }
     const std::vector<const Connection*>& conns = doc.GetConnectionsByDestinationSequenced(ID(), "Geometry");
     shapeGeometries.reserve(conns.size());
@@ -54,6 +54,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FBXDocumentUtil.h"
 #include "FBXProperties.h"
 
+#include "Common/ParallelFor.h"
+
 #include <functional>
 #include <memory>
 #include <utility>
@@ -71,6 +73,7 @@ LazyObject::LazyObject(uint64_t id, const Element& element, const Document& doc)
 
 // ------------------------------------------------------------------------------------------------
 const Object* LazyObject::Get(bool dieOnError) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     if(IsBeingConstructed() || FailedToConstruct()) {
         return nullptr;
     }
@@ -112,7 +115,11 @@ const Object* LazyObject::Get(bool dieOnError) {
         // For debugging
         //dumpObjectClassInfo( objtype, classtag );
 
-        if (!strncmp(obtype,"Geometry",length)) {
+        if (!doc.Settings().skippedClasses.empty() &&
+                (doc.Settings().IsSkipped(classtag) || doc.Settings().IsSkipped(std::string(obtype, length)))) {
+            // skipped by the importer configuration, treated like an unsupported class
+        }
+        else if (!strncmp(obtype,"Geometry",length)) {
             if (!strcmp(classtag.c_str(),"Mesh")) {
                 object.reset(new MeshGeometry(id,element,name,doc));
             }
@@ -235,6 +242,10 @@ Document::Document(const Parser& parser, const ImportSettings& settings) :
     // though, since this may require valid connections.
     ReadObjects();
     ReadConnections();
+
+    if (settings.numThreads > 1) {
+        MaterializeObjects();
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -304,7 +315,7 @@ void Document::ReadObjects() {
     objects[0] = new LazyObject(0L, *eobjects, *this);
 
     const Scope& sobjects = *eobjects->Compound();
-    for(const ElementMap::value_type& el : sobjects.Elements()) {
+    for(const ElementMapEntry& el : sobjects.Elements()) {
 
         // extract ID
         const TokenList& tok = el.second->Tokens();
@@ -320,12 +331,33 @@ void Document::ReadObjects() {
         objects[id] = new LazyObject(id, *el.second, *this);
 
         // grab all animation stacks upfront since there is no listing of them
-        if(!strcmp(el.first.c_str(),"AnimationStack")) {
+        if(!strcmp(el.first->c_str(),"AnimationStack")) {
             animationStacks.push_back(id);
         }
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+void Document::MaterializeObjects() {
+    // geometry and animation curves hold the bulk of the data. They are built
+    // concurrently as long as their construction cannot reach other objects,
+    // which for geometry means it must not have any deformers attached.
+    std::vector<LazyObject*> independent;
+    for(const ObjectMap::value_type& v : objects) {
+        const Token& key = v.second->GetElement().KeyToken();
+        const std::string obtype(key.begin(), key.end());
+
+        if (obtype == "AnimationCurve" ||
+                (obtype == "Geometry" && GetConnectionsByDestinationSequenced(v.first, "Deformer").empty())) {
+            independent.push_back(v.second);
+        }
+    }
+
+    ParallelFor(independent.size(), settings.numThreads, [&independent](size_t i) {
+        independent[i]->Get();
+    });
+}
+
 // ------------------------------------------------------------------------------------------------
 void Document::ReadPropertyTemplates() {
     const Scope& sc = parser.GetRootScope();
@@ -45,6 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef INCLUDED_AI_FBX_DOCUMENT_H
 #define INCLUDED_AI_FBX_DOCUMENT_H
 
+#include <mutex>
 #include <numeric>
 #include <unordered_set>
 #include <stdint.h>
@@ -91,6 +92,9 @@ public:
 
     ~LazyObject() = default;
 
+    /** Constructs the object on first access. Safe to call from multiple
+     *  threads, concurrent callers wait for the construction to finish.
+     *  Recursive calls from the constructing thread return nullptr. */
     const Object* Get(bool dieOnError = false);
 
     template <typename T>
@@ -132,6 +136,7 @@ private:
     };
 
     unsigned int flags;
+    std::recursive_mutex mutex;
 };
 
 /** Base class for in-memory (DOM) representations of FBX objects */
@@ -588,18 +593,18 @@ public:
     }
 
     const std::vector<float>& GetAttributes() const {
-        return attributes;
+        return attributes.Get();
     }
 
     const std::vector<unsigned int>& GetFlags() const {
-        return flags;
+        return flags.Get();
     }
 
 private:
     KeyTimeList keys;
     KeyValueList values;
-    std::vector<float> attributes;
-    std::vector<unsigned int> flags;
+    LazyDataArray<float> attributes;
+    LazyDataArray<unsigned int> flags;
 };
 
 // property-name -> animation curve
@@ -731,7 +736,7 @@ public:
     }
 
     const WeightArray& GetFullWeights() const {
-        return fullWeights;
+        return fullWeights.Get();
     }
 
     const std::unordered_set<const ShapeGeometry*>& GetShapeGeometries() const {
@@ -740,7 +745,7 @@ public:
 
 private:
     float percent;
-    WeightArray fullWeights;
+    LazyDataArray<float> fullWeights;
     std::unordered_set<const ShapeGeometry*> shapeGeometries;
 };
 
@@ -1025,6 +1030,7 @@ private:
     void ReadPropertyTemplates();
     void ReadConnections();
     void ReadGlobalSettings();
+    void MaterializeObjects();
 
 private:
     const ImportSettings& settings;
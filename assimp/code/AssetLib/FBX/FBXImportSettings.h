@@ -45,6 +45,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef INCLUDED_AI_FBX_IMPORTSETTINGS_H
 #define INCLUDED_AI_FBX_IMPORTSETTINGS_H
 
+#include <set>
+#include <string>
+
 namespace Assimp {
 namespace FBX {
 
@@ -63,7 +66,9 @@ struct ImportSettings {
             optimizeEmptyAnimationCurves(true),
             useLegacyEmbeddedTextureNaming(false),
             removeEmptyBones(true),
-            convertToMeters(false) {
+            convertToMeters(false),
+            numThreads(1),
+            skippedClasses() {
         // empty
     }
 
@@ -148,6 +153,21 @@ struct ImportSettings {
     /** Set to true to perform a conversion from cm to meter after the import
     */
     bool convertToMeters;
+
+    /** number of threads used to import the file, one keeps
+     *  everything on the calling thread. The default value is 1. */
+    unsigned int numThreads;
+
+    /** FBX classes which are not read at all. Entries are matched
+     *  against object types (AnimationLayer), object classes
+     *  (BlendShape, Skin) and geometry layer element types
+     *  (LayerElementTangent, LayerElementColor). Empty by default. */
+    std::set<std::string> skippedClasses;
+
+    /** check whether objects or layer elements of the given class are skipped */
+    bool IsSkipped(const std::string& className) const {
+        return !skippedClasses.empty() && skippedClasses.count(className) != 0;
+    }
 };
 
 } // namespace FBX
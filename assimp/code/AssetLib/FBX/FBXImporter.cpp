@@ -52,6 +52,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FBXParser.h"
 #include "FBXTokenizer.h"
 #include "FBXUtil.h"
+#include "Common/ParallelFor.h"
 
 #include <assimp/MemoryIOWrapper.h>
 #include <assimp/StreamReader.h>
@@ -112,6 +113,17 @@ void FBXImporter::SetupProperties(const Importer *pImp) {
     mSettings.removeEmptyBones = pImp->GetPropertyBool(AI_CONFIG_IMPORT_REMOVE_EMPTY_BONES, true);
     mSettings.convertToMeters = pImp->GetPropertyBool(AI_CONFIG_FBX_CONVERT_TO_M, false);
     mSettings.useSkeleton = pImp->GetPropertyBool(AI_CONFIG_FBX_USE_SKELETON_BONE_CONTAINER, false);
+    mSettings.numThreads = GetNumWorkerThreads(pImp->GetPropertyInteger(AI_CONFIG_IMPORT_FBX_NUM_THREADS, 1));
+
+    // class names are separated by whitespace, commas or semicolons
+    mSettings.skippedClasses.clear();
+    const std::string skipped = pImp->GetPropertyString(AI_CONFIG_IMPORT_FBX_SKIP_CLASSES, "");
+    static const char *separators = " \t\r\n,;";
+    for (std::string::size_type begin = skipped.find_first_not_of(separators); begin != std::string::npos;) {
+        const std::string::size_type end = skipped.find_first_of(separators, begin);
+        mSettings.skippedClasses.insert(skipped.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+        begin = skipped.find_first_not_of(separators, end);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -135,39 +147,32 @@ void FBXImporter::InternReadFile(const std::string &pFile, aiScene *pScene, IOSy
 
 	// broad-phase tokenized pass in which we identify the core
 	// syntax elements of FBX (brackets, commas, key:value mappings)
-	TokenList tokens;
-	try {
-
-		bool is_binary = false;
-		if (!strncmp(begin, "Kaydara FBX Binary", 18)) {
-			is_binary = true;
-			TokenizeBinary(tokens, begin, contents.size());
-		} else {
-			Tokenize(tokens, begin);
-		}
-
-		// use this information to construct a very rudimentary
-		// parse-tree representing the FBX scope structure
-		Parser parser(tokens, is_binary);
-
-		// take the raw parse-tree and convert it to a FBX DOM
-		Document doc(parser, mSettings);
-
-		// convert the FBX DOM to aiScene
-		ConvertToAssimpScene(pScene, doc, mSettings.removeEmptyBones);
-
-		// size relative to cm
-		float size_relative_to_cm = doc.GlobalSettings().UnitScaleFactor();
-
-		// Set FBX file scale is relative to CM must be converted to M for
-		// assimp universal format (M)
-		SetFileScale(size_relative_to_cm * 0.01f);
-
-		std::for_each(tokens.begin(), tokens.end(), Util::delete_fun<Token>());
-	} catch (std::exception &) {
-		std::for_each(tokens.begin(), tokens.end(), Util::delete_fun<Token>());
-		throw;
+	TokenArena tokens;
+
+	bool is_binary = false;
+	if (!strncmp(begin, "Kaydara FBX Binary", 18)) {
+		is_binary = true;
+		TokenizeBinary(tokens, begin, contents.size());
+	} else {
+		Tokenize(tokens, begin);
 	}
+
+	// use this information to construct a very rudimentary
+	// parse-tree representing the FBX scope structure
+	Parser parser(tokens, is_binary, mSettings.numThreads);
+
+	// take the raw parse-tree and convert it to a FBX DOM
+	Document doc(parser, mSettings);
+
+	// convert the FBX DOM to aiScene
+	ConvertToAssimpScene(pScene, doc, mSettings.removeEmptyBones);
+
+	// size relative to cm
+	float size_relative_to_cm = doc.GlobalSettings().UnitScaleFactor();
+
+	// Set FBX file scale is relative to CM must be converted to M for
+	// assimp universal format (M)
+	SetFileScale(size_relative_to_cm * 0.01f);
 }
 
 #endif // !ASSIMP_BUILD_NO_FBX_IMPORTER
@@ -152,7 +152,7 @@ MeshGeometry::MeshGeometry(uint64_t id, const Element& element, const std::strin
 
         if(doc.Settings().readAllLayers || index == 0) {
             const Scope& layer = GetRequiredScope(*(*it).second);
-            ReadLayer(layer);
+            ReadLayer(layer, doc.Settings());
         }
     }
 }
@@ -227,24 +227,28 @@ unsigned int MeshGeometry::FaceForVertexIndex( unsigned int in_index ) const {
 }
 
 // ------------------------------------------------------------------------------------------------
-void MeshGeometry::ReadLayer(const Scope& layer)
+void MeshGeometry::ReadLayer(const Scope& layer, const ImportSettings& settings)
 {
     const ElementCollection& LayerElement = layer.GetCollection("LayerElement");
     for (ElementMap::const_iterator eit = LayerElement.first; eit != LayerElement.second; ++eit) {
         const Scope& elayer = GetRequiredScope(*(*eit).second);
 
-        ReadLayerElement(elayer);
+        ReadLayerElement(elayer, settings);
     }
 }
 
 
 // ------------------------------------------------------------------------------------------------
-void MeshGeometry::ReadLayerElement(const Scope& layerElement)
+void MeshGeometry::ReadLayerElement(const Scope& layerElement, const ImportSettings& settings)
 {
     const Element& Type = GetRequiredElement(layerElement,"Type");
     const Element& TypedIndex = GetRequiredElement(layerElement,"TypedIndex");
 
     const std::string& type = ParseTokenAsString(GetRequiredToken(Type,0));
+    if (settings.IsSkipped(type)) {
+        return;
+    }
+
     const int typedIndex = ParseTokenAsInt(GetRequiredToken(TypedIndex,0));
 
     const Scope& top = GetRequiredScope(element);
@@ -513,8 +517,8 @@ void MeshGeometry::ReadVertexDataTangents(std::vector<aiVector3D>& tangents_out,
     const std::string& MappingInformationType,
     const std::string& ReferenceInformationType)
 {
-    const char * str = source.Elements().count( "Tangents" ) > 0 ? "Tangents" : "Tangent";
-    const char * strIdx = source.Elements().count( "Tangents" ) > 0 ? TangentsIndexToken : TangentIndexToken;
+    const char * str = source["Tangents"] != nullptr ? "Tangents" : "Tangent";
+    const char * strIdx = source["Tangents"] != nullptr ? TangentsIndexToken : TangentIndexToken;
     ResolveVertexDataArray(tangents_out,source,MappingInformationType,ReferenceInformationType,
         str,
         strIdx,
@@ -532,8 +536,8 @@ void MeshGeometry::ReadVertexDataBinormals(std::vector<aiVector3D>& binormals_ou
     const std::string& MappingInformationType,
     const std::string& ReferenceInformationType)
 {
-    const char * str = source.Elements().count( "Binormals" ) > 0 ? "Binormals" : "Binormal";
-    const char * strIdx = source.Elements().count( "Binormals" ) > 0 ? BinormalsIndexToken : BinormalIndexToken;
+    const char * str = source["Binormals"] != nullptr ? "Binormals" : "Binormal";
+    const char * strIdx = source["Binormals"] != nullptr ? BinormalsIndexToken : BinormalIndexToken;
     ResolveVertexDataArray(binormals_out,source,MappingInformationType,ReferenceInformationType,
         str,
         strIdx,
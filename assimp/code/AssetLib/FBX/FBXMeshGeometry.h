@@ -144,8 +144,8 @@ public:
     unsigned int FaceForVertexIndex( unsigned int in_index ) const;
 
 private:
-    void ReadLayer( const Scope& layer );
-    void ReadLayerElement( const Scope& layerElement );
+    void ReadLayer( const Scope& layer, const ImportSettings& settings );
+    void ReadLayerElement( const Scope& layerElement, const ImportSettings& settings );
     void ReadVertexData( const std::string& type, int index, const Scope& source );
 
     void ReadVertexDataUV( std::vector<aiVector2D>& uv_out, const Scope& source,
@@ -46,6 +46,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ASSIMP_BUILD_NO_FBX_IMPORTER
 
 #include "Common/Compression.h"
+#include "Common/FastAtofArray.h"
+#include "Common/ParallelFor.h"
 
 #include "FBXTokenizer.h"
 #include "FBXParser.h"
@@ -53,6 +55,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/fast_atof.h>
 #include <assimp/ByteSwapper.h>
 
+#include <cstring>
+
 using namespace Assimp;
 using namespace Assimp::FBX;
 
@@ -70,6 +74,35 @@ namespace {
         ::memcpy(&result, data, sizeof(T));
         return result;
     }
+
+    // ------------------------------------------------------------------------------------------------
+    // size of a single value in a binary data array, 0 for array types which are never decoded
+    uint32_t GetBinaryDataArrayStride(char type) {
+        switch(type)
+        {
+            case 'f':
+            case 'i':
+                return 4;
+
+            case 'd':
+            case 'l':
+                return 8;
+        };
+        return 0;
+    }
+
+    // ------------------------------------------------------------------------------------------------
+    // check whether a token holds a zlib/deflate compressed binary data array
+    bool IsCompressedDataArray(const Token& t) {
+        // type code, element count, compression mode and compressed length
+        if (!t.IsBinary() || t.end() - t.begin() < 13 || !GetBinaryDataArrayStride(*t.begin())) {
+            return false;
+        }
+
+        BE_NCONST uint32_t encmode = SafeParse<uint32_t>(t.begin() + 5, t.end());
+        AI_SWAP4(encmode);
+        return encmode == 1;
+    }
 }
 
 namespace Assimp {
@@ -106,6 +139,11 @@ Element::Element(const Token& key_token, Parser& parser) : key_token(key_token)
         }
     }
     while(n->Type() != TokenType_KEY && n->Type() != TokenType_CLOSE_BRACKET);
+
+    // compressed arrays are inflated concurrently once the whole DOM is read
+    if (parser.numThreads > 1 && tokens.size() == 1 && IsCompressedDataArray(*tokens[0])) {
+        parser.compressedArrays.push_back(this);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -116,50 +154,93 @@ Scope::Scope(Parser& parser,bool topLevel)
     // note: empty scopes are allowed
     while(n->Type() != TokenType_CLOSE_BRACKET) {
 
-        const std::string& str = n->StringContents();
+        const std::string* key = parser.InternKey(*n);
 
-        elements.insert(ElementMap::value_type(str,new_Element(*n,parser)));
+        elements.emplace_back(key, new_Element(*n,parser));
 
         // Element() should stop at the next Key token (or right after a Close token)
         n = parser.CurrentToken();
         if (n == nullptr) {
             if (topLevel) {
-                return;
+                break;
             }
         }
     }
+
+    // stable, so that elements sharing a key stay in file order
+    std::stable_sort(elements.begin(), elements.end(), CompareKey());
 }
 
 // ------------------------------------------------------------------------------------------------
 Scope::~Scope() {
-    for(ElementMap::value_type& v : elements) {
+    for(ElementMapEntry& v : elements) {
         delete v.second;
     }
 }
 
 // ------------------------------------------------------------------------------------------------
-Parser::Parser (const TokenList& tokens, bool is_binary)
+Parser::Parser (const TokenArena& tokens, bool is_binary, unsigned int numThreads)
 : tokens(tokens)
 , last()
 , current()
-, cursor(tokens.begin())
+, cursor()
 , is_binary(is_binary)
+, numThreads(numThreads)
 {
     root.reset(new Scope(*this,true));
+    InflateDataArrays();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Parser::InflateDataArrays()
+{
+    // the arrays are independent deflate streams, the result sizes are known from their headers
+    ParallelFor(compressedArrays.size(), numThreads, [this](size_t i) {
+        Element& el = *compressedArrays[i];
+        const Token& t = *el.tokens[0];
+        const char* data = t.begin();
+
+        BE_NCONST uint32_t count = SafeParse<uint32_t>(data + 1, t.end());
+        AI_SWAP4(count);
+
+        BE_NCONST uint32_t comp_len = SafeParse<uint32_t>(data + 9, t.end());
+        AI_SWAP4(comp_len);
+
+        el.inflated.resize(static_cast<size_t>(GetBinaryDataArrayStride(*data)) * count);
+        if (el.inflated.empty()) {
+            return;
+        }
+
+        Compression compress;
+        if (compress.open(Compression::Format::Binary, Compression::FlushMode::Finish, 0)) {
+            compress.decompress(data + 13, comp_len, el.inflated);
+            compress.close();
+        }
+    });
+
+    compressedArrays.clear();
+    compressedArrays.shrink_to_fit();
 }
 
 // ------------------------------------------------------------------------------------------------
 TokenPtr Parser::AdvanceToNextToken()
 {
     last = current;
-    if (cursor == tokens.end()) {
+    if (cursor == tokens.size()) {
         current = nullptr;
     } else {
-        current = *cursor++;
+        current = &tokens[cursor++];
     }
     return current;
 }
 
+// ------------------------------------------------------------------------------------------------
+const std::string* Parser::InternKey(const Token& t)
+{
+    keyScratch.assign(t.begin(), t.end());
+    return &*keys.insert(keyScratch).first;
+}
+
 // ------------------------------------------------------------------------------------------------
 TokenPtr Parser::CurrentToken() const
 {
@@ -284,17 +365,19 @@ float ParseTokenAsFloat(const Token& t, const char*& err_out)
     // need to copy the input string to a temporary buffer
     // first - next in the fbx token stream comes ',',
     // which fast_atof could interpret as decimal point.
+    // The zero padding behind it lets the number be parsed in 16 byte windows.
 #define MAX_FLOAT_LENGTH 31
     const size_t length = static_cast<size_t>(t.end()-t.begin());
     if (length > MAX_FLOAT_LENGTH) {
         return 0.f;
     }
 
-    char temp[MAX_FLOAT_LENGTH + 1];
+    char temp[2 * (MAX_FLOAT_LENGTH + 1)] = {};
     std::copy(t.begin(), t.end(), temp);
-    temp[std::min(static_cast<size_t>(MAX_FLOAT_LENGTH),length)] = '\0';
 
-    return fast_atof(temp);
+    ai_real value(0.0);
+    fast_atoreal_move_bounded<ai_real>(temp, temp + sizeof(temp), value);
+    return value;
 }
 
 
@@ -429,9 +512,10 @@ void ReadBinaryDataArrayHead(const char*& data, const char* end, char& type, uin
 
 
 // ------------------------------------------------------------------------------------------------
-// read binary data array, assume cursor points to the 'compression mode' field (i.e. behind the header)
-void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const char* end,
-        std::vector<char>& buff, const Element& /*el*/) {
+// read binary data array, assume cursor points to the 'compression mode' field (i.e. behind the header).
+// Returns the decoded data, which is either the array inflated ahead of time by the parser or buff.
+const char *ReadBinaryDataArray(char type, uint32_t count, const char*& data, const char* end,
+        std::vector<char>& buff, const Element& el) {
     BE_NCONST uint32_t encmode = SafeParse<uint32_t>(data, end);
     AI_SWAP4(encmode);
     data += 4;
@@ -442,21 +526,14 @@ void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const cha
     data += 4;
 
     // determine the length of the uncompressed data by looking at the type signature
-    uint32_t stride = 0;
-    switch(type)
-    {
-        case 'f':
-        case 'i':
-            stride = 4;
-            break;
-
-        case 'd':
-        case 'l':
-            stride = 8;
-            break;
-    };
-
-    const uint32_t full_length = stride * count;
+    const uint32_t full_length = GetBinaryDataArrayStride(type) * count;
+
+    const std::vector<char> &inflated = el.InflatedData();
+    if (encmode == 1 && !inflated.empty() && inflated.size() == full_length) {
+        data += comp_len;
+        return inflated.data();
+    }
+
     buff.resize(full_length);
 
     if(encmode == 0) {
@@ -474,10 +551,60 @@ void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const cha
     }
 
     data += comp_len;
+    return buff.data();
 }
 
 } // !anon
 
+// ------------------------------------------------------------------------------------------------
+// check the layout of a data array without decoding it
+void CheckDataArray(const Element& el, const char* binaryTypes)
+{
+    const TokenList& tok = el.Tokens();
+    if (tok.empty()) {
+        throw DeadlyImportError("FBX: data array element has no tokens");
+    }
+
+    if (tok[0]->IsBinary()) {
+        const char* data = tok[0]->begin(), *end = tok[0]->end();
+
+        // type signature, element count, encoding and encoded length
+        if (end - data < 13) {
+            throw DeadlyImportError("FBX: binary data array is too short");
+        }
+
+        char type;
+        uint32_t count;
+        ReadBinaryDataArrayHead(data, end, type, count, el);
+        if (type == 0 || strchr(binaryTypes, type) == nullptr) {
+            throw DeadlyImportError("FBX: unexpected type of binary data array: ", type);
+        }
+
+        BE_NCONST uint32_t encmode = SafeParse<uint32_t>(data, end);
+        AI_SWAP4(encmode);
+        BE_NCONST uint32_t comp_len = SafeParse<uint32_t>(data + 4, end);
+        AI_SWAP4(comp_len);
+        data += 8;
+
+        const uint64_t full_length = static_cast<uint64_t>(GetBinaryDataArrayStride(type)) * count;
+        if (encmode > 1 || comp_len > static_cast<uint64_t>(end - data) || (encmode == 0 && comp_len != full_length)) {
+            throw DeadlyImportError("FBX: malformed binary data array");
+        }
+        return;
+    }
+
+    const char* err = nullptr;
+    ParseTokenAsDim(*tok[0], err);
+    if (nullptr != err) {
+        throw DeadlyImportError("FBX: ", err);
+    }
+
+    const Scope* scope = el.Compound();
+    if (nullptr == scope || !HasElement(*scope, "a")) {
+        throw DeadlyImportError("FBX: data array is missing its value list");
+    }
+}
+
 
 // ------------------------------------------------------------------------------------------------
 // read an array of float3 tuples
@@ -499,13 +626,13 @@ void ParseVectorDataArray(std::vector<aiVector3D>& out, const Element& el)
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char *arrayData = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         const uint32_t count3 = count / 3;
         out.reserve(count3);
 
         if (type == 'd') {
-            const double* d = reinterpret_cast<const double*>(&buff[0]);
+            const double* d = reinterpret_cast<const double*>(arrayData);
             for (unsigned int i = 0; i < count3; ++i, d += 3) {
                 out.emplace_back(static_cast<ai_real>(d[0]),
                     static_cast<ai_real>(d[1]),
@@ -520,7 +647,7 @@ void ParseVectorDataArray(std::vector<aiVector3D>& out, const Element& el)
             }*/
         }
         else if (type == 'f') {
-            const float* f = reinterpret_cast<const float*>(&buff[0]);
+            const float* f = reinterpret_cast<const float*>(arrayData);
             for (unsigned int i = 0; i < count3; ++i, f += 3) {
                 out.emplace_back(f[0],f[1],f[2]);
             }
@@ -568,13 +695,13 @@ void ParseVectorDataArray(std::vector<aiColor4D>& out, const Element& el)
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char *arrayData = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         const uint32_t count4 = count / 4;
         out.reserve(count4);
 
         if (type == 'd') {
-            const double* d = reinterpret_cast<const double*>(&buff[0]);
+            const double* d = reinterpret_cast<const double*>(arrayData);
             for (unsigned int i = 0; i < count4; ++i, d += 4) {
                 out.emplace_back(static_cast<float>(d[0]),
                     static_cast<float>(d[1]),
@@ -583,7 +710,7 @@ void ParseVectorDataArray(std::vector<aiColor4D>& out, const Element& el)
             }
         }
         else if (type == 'f') {
-            const float* f = reinterpret_cast<const float*>(&buff[0]);
+            const float* f = reinterpret_cast<const float*>(arrayData);
             for (unsigned int i = 0; i < count4; ++i, f += 4) {
                 out.emplace_back(f[0],f[1],f[2],f[3]);
             }
@@ -629,19 +756,19 @@ void ParseVectorDataArray(std::vector<aiVector2D>& out, const Element& el) {
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char *arrayData = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         const uint32_t count2 = count / 2;
         out.reserve(count2);
 
         if (type == 'd') {
-            const double* d = reinterpret_cast<const double*>(&buff[0]);
+            const double* d = reinterpret_cast<const double*>(arrayData);
             for (unsigned int i = 0; i < count2; ++i, d += 2) {
                 out.emplace_back(static_cast<float>(d[0]),
                     static_cast<float>(d[1]));
             }
         } else if (type == 'f') {
-            const float* f = reinterpret_cast<const float*>(&buff[0]);
+            const float* f = reinterpret_cast<const float*>(arrayData);
             for (unsigned int i = 0; i < count2; ++i, f += 2) {
                 out.emplace_back(f[0],f[1]);
             }
@@ -686,11 +813,11 @@ void ParseVectorDataArray(std::vector<int>& out, const Element& el) {
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char *arrayData = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         out.reserve(count);
 
-        const int32_t* ip = reinterpret_cast<const int32_t*>(&buff[0]);
+        const int32_t* ip = reinterpret_cast<const int32_t*>(arrayData);
         for (unsigned int i = 0; i < count; ++i, ++ip) {
             BE_NCONST int32_t val = *ip;
             AI_SWAP4(val);
@@ -734,16 +861,16 @@ void ParseVectorDataArray(std::vector<float>& out, const Element& el)
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char *arrayData = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         if (type == 'd') {
-            const double* d = reinterpret_cast<const double*>(&buff[0]);
+            const double* d = reinterpret_cast<const double*>(arrayData);
             for (unsigned int i = 0; i < count; ++i, ++d) {
                 out.push_back(static_cast<float>(*d));
             }
         }
         else if (type == 'f') {
-            const float* f = reinterpret_cast<const float*>(&buff[0]);
+            const float* f = reinterpret_cast<const float*>(arrayData);
             for (unsigned int i = 0; i < count; ++i, ++f) {
                 out.push_back(*f);
             }
@@ -784,11 +911,11 @@ void ParseVectorDataArray(std::vector<unsigned int>& out, const Element& el) {
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char *arrayData = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         out.reserve(count);
 
-        const int32_t* ip = reinterpret_cast<const int32_t*>(&buff[0]);
+        const int32_t* ip = reinterpret_cast<const int32_t*>(arrayData);
         for (unsigned int i = 0; i < count; ++i, ++ip) {
             BE_NCONST int32_t val = *ip;
 
@@ -834,11 +961,11 @@ void ParseVectorDataArray(std::vector<uint64_t>& out, const Element& el)
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char *arrayData = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         out.reserve(count);
 
-        const uint64_t* ip = reinterpret_cast<const uint64_t*>(&buff[0]);
+        const uint64_t* ip = reinterpret_cast<const uint64_t*>(arrayData);
         for (unsigned int i = 0; i < count; ++i, ++ip) {
             BE_NCONST uint64_t val = *ip;
             AI_SWAP8(val);
@@ -882,11 +1009,11 @@ void ParseVectorDataArray(std::vector<int64_t>& out, const Element& el)
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char *arrayData = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         out.reserve(count);
 
-        const int64_t* ip = reinterpret_cast<const int64_t*>(&buff[0]);
+        const int64_t* ip = reinterpret_cast<const int64_t*>(arrayData);
         for (unsigned int i = 0; i < count; ++i, ++ip) {
             BE_NCONST int64_t val = *ip;
             AI_SWAP8(val);
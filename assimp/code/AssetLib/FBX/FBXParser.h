@@ -46,8 +46,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define INCLUDED_AI_FBX_PARSER_H
 
 #include <stdint.h>
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
 #include <vector>
 #include <assimp/fast_atof.h>
 
@@ -67,7 +72,11 @@ class Element;
 
 // XXX should use C++11's unique_ptr - but assimp's need to keep working with 03
 typedef std::vector< Scope* > ScopeList;
-typedef std::fbx_unordered_multimap< std::string, Element* > ElementMap;
+
+/** Elements of a scope, sorted by key. Keys are interned by the #Parser,
+ *  elements sharing a key keep their order of appearance in the file. */
+typedef std::pair< const std::string*, Element* > ElementMapEntry;
+typedef std::vector< ElementMapEntry > ElementMap;
 
 typedef std::pair<ElementMap::const_iterator,ElementMap::const_iterator> ElementCollection;
 
@@ -104,10 +113,18 @@ public:
         return tokens;
     }
 
+    /** binary data array inflated ahead of time by the parser, empty otherwise */
+    const std::vector<char>& InflatedData() const {
+        return inflated;
+    }
+
 private:
+    friend class Parser;
+
     const Token& key_token;
     TokenList tokens;
     std::unique_ptr<Scope> compound;
+    std::vector<char> inflated;
 };
 
 /** FBX data entity that consists of a 'scope', a collection
@@ -128,15 +145,15 @@ public:
     ~Scope();
 
     const Element* operator[] (const std::string& index) const {
-        ElementMap::const_iterator it = elements.find(index);
-        return it == elements.end() ? nullptr : (*it).second;
+        ElementMap::const_iterator it = std::lower_bound(elements.begin(), elements.end(), index, CompareKey());
+        return it == elements.end() || *(*it).first != index ? nullptr : (*it).second;
     }
 
 	const Element* FindElementCaseInsensitive(const std::string& elementName) const {
 		const char* elementNameCStr = elementName.c_str();
 		for (auto element = elements.begin(); element != elements.end(); ++element)
 		{
-			if (!ASSIMP_strincmp(element->first.c_str(), elementNameCStr, MAXLEN)) {
+			if (!ASSIMP_strincmp(element->first->c_str(), elementNameCStr, MAXLEN)) {
 				return element->second;
 			}
 		}
@@ -144,7 +161,7 @@ public:
 	}
 
     ElementCollection GetCollection(const std::string& index) const {
-        return elements.equal_range(index);
+        return std::equal_range(elements.begin(), elements.end(), index, CompareKey());
     }
 
     const ElementMap& Elements() const  {
@@ -152,6 +169,18 @@ public:
     }
 
 private:
+    struct CompareKey {
+        bool operator()(const ElementMapEntry& a, const ElementMapEntry& b) const {
+            return a.first != b.first && *a.first < *b.first;
+        }
+        bool operator()(const ElementMapEntry& a, const std::string& b) const {
+            return *a.first < b;
+        }
+        bool operator()(const std::string& a, const ElementMapEntry& b) const {
+            return a < *b.first;
+        }
+    };
+
     ElementMap elements;
 };
 
@@ -160,9 +189,11 @@ private:
 class Parser
 {
 public:
-    /** Parse given a token list. Does not take ownership of the tokens -
-     *  the objects must persist during the entire parser lifetime */
-    Parser (const TokenList& tokens,bool is_binary);
+    /** Parse given a token arena. Does not take ownership of the tokens -
+     *  the arena must persist during the entire parser lifetime.
+     *  With more than one thread, compressed binary data arrays are
+     *  inflated concurrently right after parsing. */
+    Parser (const TokenArena& tokens,bool is_binary, unsigned int numThreads = 1);
     ~Parser() = default;
 
     const Scope& GetRootScope() const {
@@ -181,14 +212,24 @@ private:
     TokenPtr LastToken() const;
     TokenPtr CurrentToken() const;
 
+    const std::string* InternKey(const Token& t);
+    void InflateDataArrays();
+
 private:
-    const TokenList& tokens;
+    const TokenArena& tokens;
 
     TokenPtr last, current;
-    TokenList::const_iterator cursor;
+    size_t cursor;
+
+    // element keys, shared by all scopes
+    std::unordered_set<std::string> keys;
+    std::string keyScratch;
+
     std::unique_ptr<Scope> root;
 
     const bool is_binary;
+    const unsigned int numThreads;
+    std::vector<Element*> compressedArrays;
 };
 
 /* token parsing - this happens when building the DOM out of the parse-tree*/
@@ -218,6 +259,40 @@ void ParseVectorDataArray(std::vector<unsigned int>& out, const Element& el);
 void ParseVectorDataArray(std::vector<uint64_t>& out, const Element& e);
 void ParseVectorDataArray(std::vector<int64_t>& out, const Element& el);
 
+/* check the layout of a data array without decoding it, binaryTypes lists the
+ * accepted type signatures of binary arrays. Throws if the array is malformed. */
+void CheckDataArray(const Element& el, const char* binaryTypes);
+
+/** Data array which is only decoded when it is accessed for the first time.
+ *  Keeps the element holding the array until then, safe to access from
+ *  several threads. The layout of the array is checked when it is set, so
+ *  malformed arrays still fail the import. */
+template <typename T>
+class LazyDataArray
+{
+public:
+    LazyDataArray() : element() {}
+
+    void Set(const Element& el) {
+        CheckDataArray(el, std::is_same<T, float>::value ? "fd" : "i");
+        element = &el;
+    }
+
+    const std::vector<T>& Get() const {
+        std::call_once(decoded, [this]() {
+            if (element) {
+                ParseVectorDataArray(data, *element);
+            }
+        });
+        return data;
+    }
+
+private:
+    const Element* element;
+    mutable std::once_flag decoded;
+    mutable std::vector<T> data;
+};
+
 bool HasElement( const Scope& sc, const std::string& index );
 
 // extract a required element from a scope, abort if the element cannot be found
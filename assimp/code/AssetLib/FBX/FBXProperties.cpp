@@ -146,8 +146,8 @@ PropertyTable::PropertyTable()
 PropertyTable::PropertyTable(const Element &element, std::shared_ptr<const PropertyTable> templateProps) :
         templateProps(std::move(templateProps)), element(&element) {
     const Scope& scope = GetRequiredScope(element);
-    for(const ElementMap::value_type& v : scope.Elements()) {
-        if(v.first != "P") {
+    for(const ElementMapEntry& v : scope.Elements()) {
+        if(*v.first != "P") {
             continue;
         }
 
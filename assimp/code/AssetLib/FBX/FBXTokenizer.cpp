@@ -60,9 +60,9 @@ namespace FBX {
 Token::Token(const char* sbegin, const char* send, TokenType type, unsigned int line, unsigned int column)
     :
     sbegin(sbegin)
-    , send(send)
-    , type(type)
+    , length(static_cast<size_t>(send - sbegin))
     , line(line)
+    , type(type)
     , column(column)
 {
 }
@@ -74,7 +74,7 @@ namespace {
 
 // process a potential data token up to 'cur', adding it to 'output_tokens'.
 // ------------------------------------------------------------------------------------------------
-void ProcessDataToken( TokenList& output_tokens, const char*& start, const char*& end,
+void ProcessDataToken( TokenArena& output_tokens, const char*& start, const char*& end,
                       unsigned int line,
                       unsigned int column,
                       TokenType type = TokenType_DATA,
@@ -91,7 +91,7 @@ void ProcessDataToken( TokenList& output_tokens, const char*& start, const char*
             }
         }
 
-        output_tokens.push_back(new_Token(start,end + 1,type,line,column));
+        output_tokens.emplace_back(start,end + 1,type,line,column);
     }
 
     start = end = nullptr;
@@ -100,7 +100,7 @@ void ProcessDataToken( TokenList& output_tokens, const char*& start, const char*
 }
 
 // ------------------------------------------------------------------------------------------------
-void Tokenize(TokenList& output_tokens, const char* input)
+void Tokenize(TokenArena& output_tokens, const char* input)
 {
     // line and column numbers numbers are one-based
     unsigned int line = 1;
@@ -150,19 +150,19 @@ void Tokenize(TokenList& output_tokens, const char* input)
 
         case '{':
             ProcessDataToken(output_tokens,token_begin,token_end, line, column);
-            output_tokens.push_back(new_Token(cur,cur+1,TokenType_OPEN_BRACKET,line,column));
+            output_tokens.emplace_back(cur,cur+1,TokenType_OPEN_BRACKET,line,column);
             continue;
 
         case '}':
             ProcessDataToken(output_tokens,token_begin,token_end,line,column);
-            output_tokens.push_back(new_Token(cur,cur+1,TokenType_CLOSE_BRACKET,line,column));
+            output_tokens.emplace_back(cur,cur+1,TokenType_CLOSE_BRACKET,line,column);
             continue;
 
         case ',':
             if (pending_data_token) {
                 ProcessDataToken(output_tokens,token_begin,token_end,line,column,TokenType_DATA,true);
             }
-            output_tokens.push_back(new_Token(cur,cur+1,TokenType_COMMA,line,column));
+            output_tokens.emplace_back(cur,cur+1,TokenType_COMMA,line,column);
             continue;
 
         case ':':
@@ -48,8 +48,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "FBXCompileConfig.h"
 #include <assimp/defs.h>
-#include <vector>
+#include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace Assimp::FBX {
 
@@ -81,7 +83,8 @@ enum TokenType
 /** Represents a single token in a FBX file. Tokens are
  *  classified by the #TokenType enumerated types.
  *
- *  Offers iterator protocol. Tokens are immutable. */
+ *  Tokens are small POD records referencing the input buffer, they
+ *  are stored by value in a #TokenArena. Tokens are immutable. */
 class Token
 {
 private:
@@ -110,7 +113,7 @@ public:
     }
 
     const char* end() const {
-        return send;
+        return sbegin + length;
     }
 
     TokenType Type() const {
@@ -130,29 +133,62 @@ public:
     }
 
 private:
-
-#ifdef DEBUG
-    // full string copy for the sole purpose that it nicely appears
-    // in msvc's debugger window.
-    const std::string contents;
-#endif
-
-
-    const char* const sbegin;
-    const char* const send;
-    const TokenType type;
+    const char* sbegin;
+    size_t length;
 
     union {
         size_t line;
         size_t offset;
     };
-    const unsigned int column;
+    TokenType type;
+    unsigned int column;
 };
 
 typedef const Token* TokenPtr;
 typedef std::vector< TokenPtr > TokenList;
 
-#define new_Token new Token
+
+/** Owns all tokens of a file. Tokens are allocated in fixed size blocks
+ *  of contiguous storage, so they are never reallocated individually and
+ *  their addresses stay valid while the arena grows. */
+class TokenArena
+{
+public:
+    TokenArena() = default;
+    ~TokenArena() = default;
+
+    TokenArena(const TokenArena&) = delete;
+    TokenArena& operator=(const TokenArena&) = delete;
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        if (blocks.empty() || blocks.back().size() == BLOCK_SIZE) {
+            blocks.emplace_back();
+            blocks.back().reserve(BLOCK_SIZE);
+        }
+        blocks.back().emplace_back(std::forward<Args>(args)...);
+        ++count;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    const Token& operator[](size_t index) const {
+        return blocks[index >> BLOCK_BITS][index & (BLOCK_SIZE - 1)];
+    }
+
+private:
+    static const size_t BLOCK_BITS = 14;
+    static const size_t BLOCK_SIZE = static_cast<size_t>(1) << BLOCK_BITS;
+
+    std::vector< std::vector<Token> > blocks;
+    size_t count = 0;
+};
 
 
 /** Main FBX tokenizer function. Transform input buffer into a list of preprocessed tokens.
@@ -162,7 +198,7 @@ typedef std::vector< TokenPtr > TokenList;
  * @param output_tokens Receives a list of all tokens in the input data.
  * @param input_buffer Textual input buffer to be processed, 0-terminated.
  * @throw DeadlyImportError if something goes wrong */
-void Tokenize(TokenList& output_tokens, const char* input);
+void Tokenize(TokenArena& output_tokens, const char* input);
 
 
 /** Tokenizer function for binary FBX files.
@@ -173,7 +209,7 @@ void Tokenize(TokenList& output_tokens, const char* input);
  * @param input_buffer Binary input buffer to be processed.
  * @param length Length of input buffer, in bytes. There is no 0-terminal.
  * @throw DeadlyImportError if something goes wrong */
-void TokenizeBinary(TokenList& output_tokens, const char* input, size_t length);
+void TokenizeBinary(TokenArena& output_tokens, const char* input, size_t length);
 
 
 } // ! Assimp
@@ -53,35 +53,87 @@ namespace Assimp {
 namespace ObjFile {
 
 struct Object;
-struct Face;
 struct Material;
 
 // ------------------------------------------------------------------------------------------------
-//! \struct Face
-//! \brief  Data structure for a simple obj-face, describes discredit,l.ation and materials
+//! \struct FaceArray
+//! \brief  Struct-of-arrays storage for obj-faces. Every attribute keeps the indices of all faces
+//!         in one contiguous buffer, face i uses the range [offsets[i], offsets[i + 1]) of it.
 // ------------------------------------------------------------------------------------------------
-struct Face {
+struct FaceArray {
     using IndexArray = std::vector<unsigned int>;
 
-    //! Primitive type
-    aiPrimitiveType mPrimitiveType;
-    //! Vertex indices
+    //! Primitive type of each face
+    std::vector<aiPrimitiveType> m_PrimitiveTypes;
+    //! Vertex indices of all faces
     IndexArray m_vertices;
-    //! Normal indices
+    //! Normal indices of all faces
     IndexArray m_normals;
-    //! Texture coordinates indices
+    //! Texture coordinates indices of all faces
     IndexArray m_texturCoords;
-    //! Pointer to assigned material
-    Material *m_pMaterial;
+    //! Start of each face in the vertex indices, one more entry than faces
+    IndexArray m_vertexOffsets;
+    //! Start of each face in the normal indices, one more entry than faces
+    IndexArray m_normalOffsets;
+    //! Start of each face in the texture coordinates indices, one more entry than faces
+    IndexArray m_texturCoordOffsets;
 
     //! \brief  Default constructor
-    Face(aiPrimitiveType pt = aiPrimitiveType_POLYGON) :
-            mPrimitiveType(pt), m_vertices(), m_normals(), m_texturCoords(), m_pMaterial(nullptr) {
+    FaceArray() :
+            m_vertexOffsets(1, 0u), m_normalOffsets(1, 0u), m_texturCoordOffsets(1, 0u) {
         // empty
     }
 
-    //! \brief  Destructor
-    ~Face() = default;
+    //! \brief  Returns the number of stored faces
+    size_t size() const {
+        return m_PrimitiveTypes.size();
+    }
+
+    //! \brief  Returns true, if no faces are stored
+    bool empty() const {
+        return m_PrimitiveTypes.empty();
+    }
+
+    //! \brief  Returns the number of vertex indices of a face
+    unsigned int numVertices(size_t face) const {
+        return m_vertexOffsets[face + 1] - m_vertexOffsets[face];
+    }
+
+    //! \brief  Returns the number of normal indices of a face
+    unsigned int numNormals(size_t face) const {
+        return m_normalOffsets[face + 1] - m_normalOffsets[face];
+    }
+
+    //! \brief  Returns the number of texture coordinates indices of a face
+    unsigned int numTexturCoords(size_t face) const {
+        return m_texturCoordOffsets[face + 1] - m_texturCoordOffsets[face];
+    }
+
+    //! \brief  Closes the face made of all indices added since the previous one
+    void closeFace(aiPrimitiveType type) {
+        m_PrimitiveTypes.push_back(type);
+        m_vertexOffsets.push_back(static_cast<unsigned int>(m_vertices.size()));
+        m_normalOffsets.push_back(static_cast<unsigned int>(m_normals.size()));
+        m_texturCoordOffsets.push_back(static_cast<unsigned int>(m_texturCoords.size()));
+    }
+
+    //! \brief  Drops all indices added since the previous face was closed
+    void discardFace() {
+        m_vertices.resize(m_vertexOffsets.back());
+        m_normals.resize(m_normalOffsets.back());
+        m_texturCoords.resize(m_texturCoordOffsets.back());
+    }
+
+    //! \brief  Removes all faces, the buffers are kept for reuse
+    void clear() {
+        m_PrimitiveTypes.clear();
+        m_vertices.clear();
+        m_normals.clear();
+        m_texturCoords.clear();
+        m_vertexOffsets.resize(1);
+        m_normalOffsets.resize(1);
+        m_texturCoordOffsets.resize(1);
+    }
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -227,8 +279,8 @@ struct Mesh {
     static const unsigned int NoMaterial = ~0u;
     /// The name for the mesh
     std::string m_name;
-    /// Array with pointer to all stored faces
-    std::vector<Face*> m_Faces;
+    /// All stored faces, released together with the mesh
+    FaceArray m_Faces;
     /// Assigned material
     Material *m_pMaterial;
     /// Number of stored indices.
@@ -253,12 +305,7 @@ struct Mesh {
     }
 
     /// Destructor
-    ~Mesh() {
-        for (std::vector<Face *>::iterator it = m_Faces.begin();
-                it != m_Faces.end(); ++it) {
-            delete *it;
-        }
-    }
+    ~Mesh() = default;
 };
 
 // ------------------------------------------------------------------------------------------------
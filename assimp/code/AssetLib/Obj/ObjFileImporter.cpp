@@ -44,6 +44,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ObjFileImporter.h"
 #include "ObjFileData.h"
 #include "ObjFileParser.h"
+#include "Common/ParallelFor.h"
+#include <assimp/DefaultIOStream.h>
 #include <assimp/DefaultIOSystem.h>
 #include <assimp/IOStreamBuffer.h>
 #include <assimp/importerdesc.h>
@@ -67,6 +69,20 @@ static const aiImporterDesc desc = {
 
 static const unsigned int ObjMinSize = 16;
 
+// The stream buffer keeps a cache and a line buffer of this size, the default one is 16 MB each
+static const size_t ObjStreamingCacheSize = 1024 * 1024;
+
+// ------------------------------------------------------------------------------------------------
+//  Returns true, if all indices are below the given number of elements
+static bool indicesInRange(const std::vector<unsigned int> &indices, size_t count) {
+    for (unsigned int index : indices) {
+        if (index >= count) {
+            return false;
+        }
+    }
+    return true;
+}
+
 namespace Assimp {
 
 using namespace std;
@@ -76,7 +92,11 @@ using namespace std;
 ObjFileImporter::ObjFileImporter() :
         m_Buffer(),
         m_pRootObject(nullptr),
-        m_strAbsPath(std::string(1, DefaultIOSystem().getOsSeparator())) {}
+        m_strAbsPath(std::string(1, DefaultIOSystem().getOsSeparator())),
+        m_useMemoryMapping(false),
+        m_numThreads(1),
+        m_streaming(false),
+        m_streamedMeshes() {}
 
 // ------------------------------------------------------------------------------------------------
 //  Destructor.
@@ -97,6 +117,14 @@ const aiImporterDesc *ObjFileImporter::GetInfo() const {
     return &desc;
 }
 
+// ------------------------------------------------------------------------------------------------
+//  Setup configuration properties for the loader
+void ObjFileImporter::SetupProperties(const Importer *pImp) {
+    m_useMemoryMapping = pImp->GetPropertyBool(AI_CONFIG_IMPORT_OBJ_MEMORY_MAPPED, false);
+    m_numThreads = GetNumWorkerThreads(pImp->GetPropertyInteger(AI_CONFIG_IMPORT_OBJ_NUM_THREADS, 1));
+    m_streaming = pImp->GetPropertyBool(AI_CONFIG_IMPORT_OBJ_STREAMING, false);
+}
+
 // ------------------------------------------------------------------------------------------------
 //  Obj-file import implementation
 void ObjFileImporter::InternReadFile(const std::string &file, aiScene *pScene, IOSystem *pIOHandler) {
@@ -107,8 +135,28 @@ void ObjFileImporter::InternReadFile(const std::string &file, aiScene *pScene, I
     };
     std::unique_ptr<IOStream, decltype(streamCloser)> fileStream(pIOHandler->Open(file, mode), streamCloser);
 
-    IOStreamBuffer<char> streamedBuffer;
-    streamedBuffer.open(fileStream.get());
+    // Only plain files can be mapped, everything else goes through the stream buffer
+    const char *mappedData = nullptr;
+    if (m_useMemoryMapping) {
+        DefaultIOStream *defaultStream = dynamic_cast<DefaultIOStream *>(fileStream.get());
+        if (nullptr != defaultStream) {
+            mappedData = defaultStream->Map();
+        }
+    }
+
+    // The parallel parser needs the whole file in memory, which streaming avoids
+    if (nullptr == mappedData && m_numThreads > 1 && !m_streaming) {
+        m_Buffer.resize(fileStream->FileSize());
+        if (!m_Buffer.empty() && fileStream->Read(m_Buffer.data(), 1, m_Buffer.size()) == m_Buffer.size()) {
+            mappedData = m_Buffer.data();
+        }
+    }
+
+    IOStreamBuffer<char> streamedBuffer(m_streaming ? ObjStreamingCacheSize : 4096 * 4096);
+    if (nullptr == mappedData) {
+        fileStream->Seek(0, aiOrigin_SET);
+        streamedBuffer.open(fileStream.get());
+    }
 
     // Get the model name
     std::string modelName, folderName;
@@ -123,11 +171,41 @@ void ObjFileImporter::InternReadFile(const std::string &file, aiScene *pScene, I
         modelName = file;
     }
 
+    // When streaming, each mesh is converted as soon as the parser is done with it. Meshes
+    // referring to data defined later in the file keep their faces and are converted at the end.
+    ObjFileParser::MeshCallback meshCallback;
+    if (m_streaming) {
+        meshCallback = [this](const ObjFile::Model &model, const ObjFile::Object &object, unsigned int meshIndex) {
+            const ObjFile::FaceArray &faces = model.mMeshes[meshIndex]->m_Faces;
+            if (!indicesInRange(faces.m_vertices, model.mVertices.size()) ||
+                    !indicesInRange(faces.m_normals, model.mNormals.size()) ||
+                    !indicesInRange(faces.m_texturCoords, model.mTextureCoord.size())) {
+                return false;
+            }
+            if (m_streamedMeshes.size() <= meshIndex) {
+                m_streamedMeshes.resize(meshIndex + 1, nullptr);
+            }
+            m_streamedMeshes[meshIndex] = createTopology(&model, &object, meshIndex);
+            return true;
+        };
+    }
+
     // parse the file into a temporary representation
-    ObjFileParser parser(streamedBuffer, modelName, pIOHandler, file);
+    std::unique_ptr<ObjFileParser> parser;
+    if (nullptr != mappedData) {
+        parser.reset(new ObjFileParser(mappedData, mappedData + fileStream->FileSize(), modelName, pIOHandler, file, m_numThreads, meshCallback));
+    } else {
+        parser.reset(new ObjFileParser(streamedBuffer, modelName, pIOHandler, file, meshCallback));
+    }
 
     // And create the proper return structures out of it
-    CreateDataFromImport(parser.GetModel(), pScene);
+    CreateDataFromImport(parser->GetModel(), pScene);
+
+    // Meshes not referenced by the node graph
+    for (aiMesh *mesh : m_streamedMeshes) {
+        delete mesh;
+    }
+    m_streamedMeshes.clear();
 
     streamedBuffer.close();
 
@@ -234,7 +312,17 @@ aiNode *ObjFileImporter::createNodes(const ObjFile::Model *pModel, const ObjFile
 
     for (size_t i = 0; i < pObject->m_Meshes.size(); ++i) {
         unsigned int meshId = pObject->m_Meshes[i];
-        aiMesh *pMesh = createTopology(pModel, pObject, meshId);
+        aiMesh *pMesh = nullptr;
+        if (m_streaming && meshId < m_streamedMeshes.size()) {
+            std::swap(pMesh, m_streamedMeshes[meshId]);
+        }
+        if (nullptr == pMesh) {
+            // Not converted while parsing, or not streamed at all
+            pMesh = createTopology(pModel, pObject, meshId);
+        } else if (nullptr != pMesh->mTextureCoords[0]) {
+            // Texture coordinates with more components may have been read after the mesh
+            pMesh->mNumUVComponents[0] = pModel->mTextureCoordDim;
+        }
         if (pMesh) {
             if (pMesh->mNumFaces > 0) {
                 MeshArray.push_back(pMesh);
@@ -283,7 +371,8 @@ aiMesh *ObjFileImporter::createTopology(const ObjFile::Model *pModel, const ObjF
         return nullptr;
     }
 
-    if (pObjMesh->m_Faces.empty()) {
+    const ObjFile::FaceArray &faces = pObjMesh->m_Faces;
+    if (faces.empty()) {
         return nullptr;
     }
 
@@ -292,19 +381,19 @@ aiMesh *ObjFileImporter::createTopology(const ObjFile::Model *pModel, const ObjF
         pMesh->mName.Set(pObjMesh->m_name);
     }
 
-    for (size_t index = 0; index < pObjMesh->m_Faces.size(); index++) {
-        const ObjFile::Face *inp = pObjMesh->m_Faces[index];
-        //ai_assert(nullptr != inp);
+    for (size_t index = 0; index < faces.size(); index++) {
+        const unsigned int numVertices = faces.numVertices(index);
+        const aiPrimitiveType type = faces.m_PrimitiveTypes[index];
 
-        if (inp->mPrimitiveType == aiPrimitiveType_LINE) {
-            pMesh->mNumFaces += static_cast<unsigned int>(inp->m_vertices.size() - 1);
+        if (type == aiPrimitiveType_LINE) {
+            pMesh->mNumFaces += numVertices - 1;
             pMesh->mPrimitiveTypes |= aiPrimitiveType_LINE;
-        } else if (inp->mPrimitiveType == aiPrimitiveType_POINT) {
-            pMesh->mNumFaces += static_cast<unsigned int>(inp->m_vertices.size());
+        } else if (type == aiPrimitiveType_POINT) {
+            pMesh->mNumFaces += numVertices;
             pMesh->mPrimitiveTypes |= aiPrimitiveType_POINT;
         } else {
             ++pMesh->mNumFaces;
-            if (inp->m_vertices.size() > 3) {
+            if (numVertices > 3) {
                 pMesh->mPrimitiveTypes |= aiPrimitiveType_POLYGON;
             } else {
                 pMesh->mPrimitiveTypes |= aiPrimitiveType_TRIANGLE;
@@ -319,45 +408,40 @@ aiMesh *ObjFileImporter::createTopology(const ObjFile::Model *pModel, const ObjF
             pMesh->mMaterialIndex = pObjMesh->m_uiMaterialIndex;
         }
 
-        unsigned int outIndex(0);
+        aiFace *pFace = pMesh->mFaces;
 
         // Copy all data from all stored meshes
-        for (auto &face : pObjMesh->m_Faces) {
-            const ObjFile::Face *inp = face;
-            if (inp->mPrimitiveType == aiPrimitiveType_LINE) {
-                for (size_t i = 0; i < inp->m_vertices.size() - 1; ++i) {
-                    aiFace &f = pMesh->mFaces[outIndex++];
-                    uiIdxCount += f.mNumIndices = 2;
-                    f.mIndices = new unsigned int[2];
-                }
-                continue;
-            } else if (inp->mPrimitiveType == aiPrimitiveType_POINT) {
-                for (size_t i = 0; i < inp->m_vertices.size(); ++i) {
-                    aiFace &f = pMesh->mFaces[outIndex++];
-                    uiIdxCount += f.mNumIndices = 1;
-                    f.mIndices = new unsigned int[1];
+        for (size_t index = 0; index < faces.size(); index++) {
+            const unsigned int numVertices = faces.numVertices(index);
+            const aiPrimitiveType type = faces.m_PrimitiveTypes[index];
+
+            if (type == aiPrimitiveType_LINE || type == aiPrimitiveType_POINT) {
+                const unsigned int numIndices = (type == aiPrimitiveType_LINE) ? 2 : 1;
+                const unsigned int numFaces = (type == aiPrimitiveType_LINE) ? numVertices - 1 : numVertices;
+                for (unsigned int i = 0; i < numFaces; ++i, ++pFace) {
+                    uiIdxCount += pFace->mNumIndices = numIndices;
+                    pFace->mIndices = new unsigned int[numIndices];
                 }
                 continue;
             }
 
-            aiFace *pFace = &pMesh->mFaces[outIndex++];
-            const unsigned int uiNumIndices = (unsigned int)face->m_vertices.size();
-            uiIdxCount += pFace->mNumIndices = (unsigned int)uiNumIndices;
-            if (pFace->mNumIndices > 0) {
-                pFace->mIndices = new unsigned int[uiNumIndices];
-            }
+            uiIdxCount += pFace->mNumIndices = numVertices;
+            pFace->mIndices = new unsigned int[numVertices];
+            ++pFace;
         }
     }
 
     // Create mesh vertices
-    createVertexArray(pModel, pData, meshIndex, pMesh.get(), uiIdxCount);
+    if (!createVertexArray(pModel, pData, meshIndex, pMesh.get(), uiIdxCount)) {
+        return nullptr;
+    }
 
     return pMesh.release();
 }
 
 // ------------------------------------------------------------------------------------------------
-//  Creates a vertex array
-void ObjFileImporter::createVertexArray(const ObjFile::Model *pModel,
+//  Creates a vertex array, returns false if a face refers to a missing vertex
+bool ObjFileImporter::createVertexArray(const ObjFile::Model *pModel,
         const ObjFile::Object *pCurrentObject,
         unsigned int uiMeshIndex,
         aiMesh *pMesh,
@@ -365,12 +449,17 @@ void ObjFileImporter::createVertexArray(const ObjFile::Model *pModel,
 
     // Break, if no faces are stored in object
     if (pCurrentObject->m_Meshes.empty())
-        return;
+        return true;
 
     // Get current mesh
     ObjFile::Mesh *pObjMesh = pModel->mMeshes[uiMeshIndex];
     if (nullptr == pObjMesh || pObjMesh->m_uiNumIndices < 1) {
-        return;
+        return true;
+    }
+
+    const ObjFile::FaceArray &faces = pObjMesh->m_Faces;
+    if (!indicesInRange(faces.m_vertices, pModel->mVertices.size())) {
+        return false;
     }
 
     // Copy vertices of this mesh instance
@@ -388,18 +477,26 @@ void ObjFileImporter::createVertexArray(const ObjFile::Model *pModel,
     }
 
     // Copy vertices, normals and textures into aiMesh instance
+    const bool hasNormals = !pModel->mNormals.empty();
+    const bool hasTextureCoords = !pModel->mTextureCoord.empty();
     bool normalsok = true, uvok = true;
     unsigned int newIndex = 0, outIndex = 0;
-    for (auto sourceFace : pObjMesh->m_Faces) {
-        // Copy all index arrays
-        for (size_t vertexIndex = 0, outVertexIndex = 0; vertexIndex < sourceFace->m_vertices.size(); vertexIndex++) {
-            const unsigned int vertex = sourceFace->m_vertices.at(vertexIndex);
+    for (size_t index = 0; index < faces.size(); index++) {
+        const unsigned int *vertices = faces.m_vertices.data() + faces.m_vertexOffsets[index];
+        const unsigned int *normals = faces.m_normals.data() + faces.m_normalOffsets[index];
+        const unsigned int *texturCoords = faces.m_texturCoords.data() + faces.m_texturCoordOffsets[index];
+        const unsigned int numVertices = faces.numVertices(index);
+        const unsigned int numNormals = faces.numNormals(index);
+        const unsigned int numTexturCoords = faces.numTexturCoords(index);
+        const aiPrimitiveType type = faces.m_PrimitiveTypes[index];
 
-            pMesh->mVertices[newIndex] = pModel->mVertices[vertex];
+        // Copy all index arrays
+        for (unsigned int vertexIndex = 0, outVertexIndex = 0; vertexIndex < numVertices; vertexIndex++) {
+            pMesh->mVertices[newIndex] = pModel->mVertices[vertices[vertexIndex]];
 
             // Copy all normals
-            if (normalsok && !pModel->mNormals.empty() && vertexIndex < sourceFace->m_normals.size()) {
-                const unsigned int normal = sourceFace->m_normals.at(vertexIndex);
+            if (normalsok && hasNormals && vertexIndex < numNormals) {
+                const unsigned int normal = normals[vertexIndex];
                 if (normal >= pModel->mNormals.size()) {
                     normalsok = false;
                 } else {
@@ -408,30 +505,28 @@ void ObjFileImporter::createVertexArray(const ObjFile::Model *pModel,
             }
 
             // Copy all texture coordinates
-            if (uvok && !pModel->mTextureCoord.empty() && vertexIndex < sourceFace->m_texturCoords.size()) {
-                const unsigned int tex = sourceFace->m_texturCoords.at(vertexIndex);
-
+            if (uvok && hasTextureCoords && vertexIndex < numTexturCoords) {
+                const unsigned int tex = texturCoords[vertexIndex];
                 if (tex >= pModel->mTextureCoord.size()) {
                     uvok = false;
                 } else {
-                    const aiVector3D &coord3d = pModel->mTextureCoord[tex];
-                    pMesh->mTextureCoords[0][newIndex] = aiVector3D(coord3d.x, coord3d.y, coord3d.z);
+                    pMesh->mTextureCoords[0][newIndex] = pModel->mTextureCoord[tex];
                 }
             }
 
             // Get destination face
             aiFace *pDestFace = &pMesh->mFaces[outIndex];
 
-            const bool last = (vertexIndex == sourceFace->m_vertices.size() - 1);
-            if (sourceFace->mPrimitiveType != aiPrimitiveType_LINE || !last) {
+            const bool last = (vertexIndex == numVertices - 1);
+            if (type != aiPrimitiveType_LINE || !last) {
                 pDestFace->mIndices[outVertexIndex] = newIndex;
                 outVertexIndex++;
             }
 
-            if (sourceFace->mPrimitiveType == aiPrimitiveType_POINT) {
+            if (type == aiPrimitiveType_POINT) {
                 outIndex++;
                 outVertexIndex = 0;
-            } else if (sourceFace->mPrimitiveType == aiPrimitiveType_LINE) {
+            } else if (type == aiPrimitiveType_LINE) {
                 outVertexIndex = 0;
 
                 if (!last)
@@ -440,10 +535,10 @@ void ObjFileImporter::createVertexArray(const ObjFile::Model *pModel,
                 if (vertexIndex) {
                     if (!last) {
                         pMesh->mVertices[newIndex + 1] = pMesh->mVertices[newIndex];
-                        if (!sourceFace->m_normals.empty() && !pModel->mNormals.empty()) {
+                        if (0 != numNormals && hasNormals) {
                             pMesh->mNormals[newIndex + 1] = pMesh->mNormals[newIndex];
                         }
-                        if (!pModel->mTextureCoord.empty()) {
+                        if (hasTextureCoords) {
                             for (size_t i = 0; i < pMesh->GetNumUVChannels(); i++) {
                                 pMesh->mTextureCoords[i][newIndex + 1] = pMesh->mTextureCoords[i][newIndex];
                             }
@@ -469,6 +564,8 @@ void ObjFileImporter::createVertexArray(const ObjFile::Model *pModel,
         delete[] pMesh->mTextureCoords[0];
         pMesh->mTextureCoords[0] = nullptr;
     }
+
+    return true;
 }
 
 // ------------------------------------------------------------------------------------------------
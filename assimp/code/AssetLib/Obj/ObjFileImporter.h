@@ -76,6 +76,9 @@ protected:
     //! \brief  Appends the supported extension.
     const aiImporterDesc *GetInfo() const override;
 
+    //! \brief  Reads the importer configuration.
+    void SetupProperties(const Importer *pImp) override;
+
     //! \brief  File import implementation.
     void InternReadFile(const std::string &pFile, aiScene *pScene, IOSystem *pIOHandler) override;
 
@@ -90,8 +93,8 @@ protected:
     aiMesh *createTopology(const ObjFile::Model *pModel, const ObjFile::Object *pData,
             unsigned int uiMeshIndex);
 
-    //! \brief  Creates vertices from model.
-    void createVertexArray(const ObjFile::Model *pModel, const ObjFile::Object *pCurrentObject,
+    //! \brief  Creates vertices from model, fails on vertex indices out of range.
+    bool createVertexArray(const ObjFile::Model *pModel, const ObjFile::Object *pCurrentObject,
             unsigned int uiMeshIndex, aiMesh *pMesh, unsigned int numIndices);
 
     //! \brief  Object counter helper method.
@@ -113,6 +116,14 @@ private:
     ObjFile::Object *m_pRootObject;
     //! Absolute pathname of model in file system
     std::string m_strAbsPath;
+    //! Tokenize memory-mapped files in place
+    bool m_useMemoryMapping;
+    //! Number of threads used by the parser
+    unsigned int m_numThreads;
+    //! Convert meshes while parsing and release their faces right away
+    bool m_streaming;
+    //! Meshes converted while parsing, by mesh index
+    std::vector<aiMesh *> m_streamedMeshes;
 };
 
 // ------------------------------------------------------------------------------------------------
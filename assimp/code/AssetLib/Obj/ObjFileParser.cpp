@@ -44,11 +44,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ObjFileData.h"
 #include "ObjFileMtlImporter.h"
 #include "ObjTools.h"
+#include "Common/FastAtofArray.h"
+#include "Common/ParallelFor.h"
 #include <assimp/BaseImporter.h>
 #include <assimp/DefaultIOSystem.h>
 #include <assimp/ParsingUtils.h>
 #include <assimp/Importer.hpp>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <utility>
 #include <string_view>
@@ -58,29 +61,106 @@ namespace Assimp {
 
 constexpr const char ObjFileParser::DEFAULT_MATERIAL[];
 
+// Files are not split into chunks smaller than this
+static constexpr size_t ObjMinChunkSize = 1024 * 1024;
+
+// -------------------------------------------------------------------
+//  A line-aligned part of the file. Definitions are collected into
+//  chunk-local arrays, faces keep their indices as written in the file
+//  together with the number of definitions that preceded them inside the
+//  chunk. Statements changing the parser state are kept as text and
+//  replayed in file order once all chunks are stitched together.
+struct ObjFileParser::Chunk {
+    struct FaceDefinitions {
+        unsigned int numVertices;
+        unsigned int numTextureCoords;
+        unsigned int numNormals;
+    };
+
+    struct Statement {
+        size_t faceIndex;
+        std::string line;
+    };
+
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    std::vector<aiVector3D> vertices;
+    std::vector<aiVector3D> normals;
+    std::vector<aiVector3D> textureCoords;
+    unsigned int textureCoordDim = 0;
+    ObjFile::FaceArray faces;
+    std::vector<FaceDefinitions> faceDefinitions;
+    std::vector<Statement> statements;
+    bool hasCurveSection = false;
+    unsigned int vertexOffset = 0;
+    unsigned int textureCoordOffset = 0;
+    unsigned int normalOffset = 0;
+};
+
 ObjFileParser::ObjFileParser() :
         m_DataIt(),
         m_DataItEnd(),
         m_pModel(nullptr),
+        m_pFaceBuffer(nullptr),
+        m_meshCallback(),
+        m_pMeshObject(nullptr),
         m_uiLine(0),
-        m_buffer(),
+        m_insideCstype(false),
         m_pIO(nullptr),
         m_originalObjFileName() {
-    std::fill_n(m_buffer, Buffersize, '\0');
+    // empty
 }
 
 ObjFileParser::ObjFileParser(IOStreamBuffer<char> &streamBuffer, const std::string &modelName,
         IOSystem *io,
-        const std::string &originalObjFileName) :
+        const std::string &originalObjFileName,
+        MeshCallback meshCallback) :
+        m_DataIt(),
+        m_DataItEnd(),
+        m_pModel(nullptr),
+        m_pFaceBuffer(nullptr),
+        m_meshCallback(std::move(meshCallback)),
+        m_pMeshObject(nullptr),
+        m_uiLine(0),
+        m_insideCstype(false),
+        m_pIO(io),
+        m_originalObjFileName(originalObjFileName) {
+    createModel(modelName);
+
+    // Start parsing the file
+    parseFile(streamBuffer);
+    finishMesh();
+}
+
+ObjFileParser::ObjFileParser(const char *begin, const char *end, const std::string &modelName,
+        IOSystem *io,
+        const std::string &originalObjFileName,
+        unsigned int numThreads,
+        MeshCallback meshCallback) :
         m_DataIt(),
         m_DataItEnd(),
         m_pModel(nullptr),
+        m_pFaceBuffer(nullptr),
+        m_meshCallback(std::move(meshCallback)),
+        m_pMeshObject(nullptr),
         m_uiLine(0),
-        m_buffer(),
+        m_insideCstype(false),
         m_pIO(io),
         m_originalObjFileName(originalObjFileName) {
-    std::fill_n(m_buffer, Buffersize, '\0');
+    createModel(modelName);
+
+    // Start parsing the in-memory file
+    if (numThreads > 1) {
+        parseFileParallel(begin, end, numThreads);
+    } else {
+        parseMappedFile(begin, end);
+    }
+    finishMesh();
+}
+
+ObjFileParser::~ObjFileParser() = default;
 
+void ObjFileParser::createModel(const std::string &modelName) {
     // Create the model instance to store all the data
     m_pModel.reset(new ObjFile::Model());
     m_pModel->mModelName = modelName;
@@ -91,15 +171,12 @@ ObjFileParser::ObjFileParser(IOStreamBuffer<char> &streamBuffer, const std::stri
     m_pModel->mMaterialLib.emplace_back(DEFAULT_MATERIAL);
     m_pModel->mMaterialMap[DEFAULT_MATERIAL] = m_pModel->mDefaultMaterial;
 
-    // Start parsing the file
-    parseFile(streamBuffer);
+    m_pFaceBuffer.reset(new ObjFile::FaceArray());
 }
 
-ObjFileParser::~ObjFileParser() = default;
-
 void ObjFileParser::setBuffer(std::vector<char> &buffer) {
-    m_DataIt = buffer.begin();
-    m_DataItEnd = buffer.end();
+    m_DataIt = buffer.data();
+    m_DataItEnd = buffer.data() + buffer.size();
 }
 
 ObjFile::Model *ObjFileParser::GetModel() const {
@@ -107,154 +184,330 @@ ObjFile::Model *ObjFileParser::GetModel() const {
 }
 
 void ObjFileParser::parseFile(IOStreamBuffer<char> &streamBuffer) {
-    // only update every 100KB or it'll be too slow
-    //const unsigned int updateProgressEveryBytes = 100 * 1024;
-    size_t lastFilePos(0);
-
-    bool insideCstype = false;
     std::vector<char> buffer;
     while (streamBuffer.getNextDataLine(buffer, '\\')) {
-        m_DataIt = buffer.begin();
-        m_DataItEnd = buffer.end();
+        setBuffer(buffer);
+        parseLine();
+    }
+}
+
+// -------------------------------------------------------------------
+//  Returns the position of a trailing line continuation token, if any.
+static const char *findContinuation(const char *lineBegin, const char *lineEnd) {
+    const char *last = lineEnd;
+    if (last != lineBegin && *(last - 1) == '\r') {
+        --last;
+    }
+    if (last != lineBegin && *(last - 1) == '\\') {
+        return last - 1;
+    }
+    return nullptr;
+}
 
-        // Handle progress reporting
-        const size_t filePos(streamBuffer.getFilePos());
-        if (lastFilePos < filePos) {
-            lastFilePos = filePos;
+void ObjFileParser::parseMappedFile(const char *begin, const char *end, Chunk *chunk) {
+    std::vector<char> joined;
+    const char *it = begin;
+    while (it < end) {
+        const char *lineEnd = static_cast<const char *>(::memchr(it, '\n', static_cast<size_t>(end - it)));
+        if (nullptr != lineEnd && lineEnd + 1 < end && nullptr == findContinuation(it, lineEnd)) {
+            // Common case: the line is terminated inside the mapping, so it
+            // can be tokenized in place. Like the buffered reader, the end
+            // iterator is left behind the line end.
+            m_DataIt = it;
+            m_DataItEnd = end;
+            if (nullptr != chunk) {
+                parseChunkLine(*chunk);
+            } else {
+                parseLine();
+            }
+            it = lineEnd + 1;
+            continue;
         }
 
-        // handle cstype section end (http://paulbourke.net/dataformats/obj/)
-        if (insideCstype) {
-            switch (*m_DataIt) {
-            case 'e': {
-                std::string name;
-                getNameNoSpace(m_DataIt, m_DataItEnd, name);
-                insideCstype = name != "end";
-            } break;
+        // Continued lines and the last line are assembled into a terminated
+        // copy, the same way the buffered reader does it
+        joined.clear();
+        for (;;) {
+            const char *continuation = nullptr != lineEnd ? findContinuation(it, lineEnd) : nullptr;
+            if (nullptr == continuation) {
+                joined.insert(joined.end(), it, nullptr != lineEnd ? lineEnd : end);
+                it = nullptr != lineEnd ? lineEnd + 1 : end;
+                break;
             }
-            goto pf_skip_line;
+            joined.insert(joined.end(), it, continuation);
+            it = lineEnd + 1;
+            if (it >= end) {
+                break;
+            }
+            lineEnd = static_cast<const char *>(::memchr(it, '\n', static_cast<size_t>(end - it)));
         }
+        joined.push_back('\n');
+        joined.push_back('\0');
+        setBuffer(joined);
+        if (nullptr != chunk) {
+            parseChunkLine(*chunk);
+        } else {
+            parseLine();
+        }
+    }
+}
 
-        // parse line
-        switch (*m_DataIt) {
-        case 'v': // Parse a vertex texture coordinate
-        {
-            ++m_DataIt;
-            if (*m_DataIt == ' ' || *m_DataIt == '\t') {
-                size_t numComponents = getNumComponentsInDataDefinition();
-                if (numComponents == 3) {
-                    // read in vertex definition
-                    getVector3(m_pModel->mVertices);
-                } else if (numComponents == 4) {
-                    // read in vertex definition (homogeneous coords)
-                    getHomogeneousVector3(m_pModel->mVertices);
-                } else if (numComponents == 6) {
+// -------------------------------------------------------------------
+//  Appends face indices as written in the file as zero-based ones. Relative
+//  indices count back from the given number of definitions.
+static void appendIndices(ObjFile::FaceArray::IndexArray &target, const ObjFile::FaceArray::IndexArray &source,
+        unsigned int begin, unsigned int end, unsigned int count) {
+    for (unsigned int i = begin; i < end; ++i) {
+        const int value = static_cast<int>(source[i]);
+        if (value > 0) {
+            target.push_back(static_cast<unsigned int>(value - 1));
+        } else {
+            target.push_back(static_cast<unsigned int>(static_cast<int>(count) + value));
+        }
+    }
+}
+
+void ObjFileParser::parseFileParallel(const char *begin, const char *end, unsigned int numThreads) {
+    // A few chunks per thread keep all of them busy when the content is uneven
+    const size_t size = static_cast<size_t>(end - begin);
+    const size_t numChunks = std::min(static_cast<size_t>(numThreads) * 4, size / ObjMinChunkSize);
+    if (numChunks <= 1) {
+        parseMappedFile(begin, end);
+        return;
+    }
+
+    // Split behind line ends which are not continued on the next line
+    std::vector<Chunk> chunks(numChunks);
+    const char *chunkBegin = begin;
+    for (size_t i = 0; i < numChunks; ++i) {
+        const char *chunkEnd = end;
+        if (i + 1 < numChunks) {
+            chunkEnd = std::max(chunkBegin, begin + size / numChunks * (i + 1));
+            for (;;) {
+                const char *lineEnd = static_cast<const char *>(::memchr(chunkEnd, '\n', static_cast<size_t>(end - chunkEnd)));
+                if (nullptr == lineEnd) {
+                    chunkEnd = end;
+                    break;
+                }
+                chunkEnd = lineEnd + 1;
+                if (nullptr == findContinuation(begin, lineEnd)) {
+                    break;
                 }
-            } else if (*m_DataIt == 't') {
-                // read in texture coordinate ( 2D or 3D )
-                ++m_DataIt;
-                size_t dim = getTexCoordVector(m_pModel->mTextureCoord);
-                m_pModel->mTextureCoordDim = std::max(m_pModel->mTextureCoordDim, (unsigned int)dim);
-            } else if (*m_DataIt == 'n') {
-                // Read in normal vector definition
-                ++m_DataIt;
-                getVector3(m_pModel->mNormals);
             }
-        } break;
+        }
+        chunks[i].begin = chunkBegin;
+        chunks[i].end = chunkEnd;
+        chunkBegin = chunkEnd;
+    }
 
-        case 'p': // Parse a face, line or point statement
-        case 'l':
-        case 'f': {
-            getFace(*m_DataIt == 'f' ? aiPrimitiveType_POLYGON : (*m_DataIt == 'l' ? aiPrimitiveType_LINE : aiPrimitiveType_POINT));
-        } break;
+    ParallelFor(chunks.size(), numThreads, [&chunks](size_t i) {
+        ObjFileParser worker;
+        worker.parseMappedFile(chunks[i].begin, chunks[i].end, &chunks[i]);
+    });
 
-        case '#': // Parse a comment
-        {
-            getComment();
-        } break;
+    // Curve and surface sections span several lines, leave them to the sequential parser
+    for (const Chunk &chunk : chunks) {
+        if (chunk.hasCurveSection) {
+            chunks.clear();
+            parseMappedFile(begin, end);
+            return;
+        }
+    }
 
-        case 'u': // Parse a material desc. setter
-        {
-            std::string name;
+    // Stitch the definitions together
+    for (Chunk &chunk : chunks) {
+        chunk.vertexOffset = static_cast<unsigned int>(m_pModel->mVertices.size());
+        chunk.textureCoordOffset = static_cast<unsigned int>(m_pModel->mTextureCoord.size());
+        chunk.normalOffset = static_cast<unsigned int>(m_pModel->mNormals.size());
+        m_pModel->mVertices.insert(m_pModel->mVertices.end(), chunk.vertices.begin(), chunk.vertices.end());
+        m_pModel->mTextureCoord.insert(m_pModel->mTextureCoord.end(), chunk.textureCoords.begin(), chunk.textureCoords.end());
+        m_pModel->mNormals.insert(m_pModel->mNormals.end(), chunk.normals.begin(), chunk.normals.end());
+        m_pModel->mTextureCoordDim = std::max(m_pModel->mTextureCoordDim, chunk.textureCoordDim);
+        std::vector<aiVector3D>().swap(chunk.vertices);
+        std::vector<aiVector3D>().swap(chunk.textureCoords);
+        std::vector<aiVector3D>().swap(chunk.normals);
+    }
 
+    // Groups, objects and materials are assigned in file order, relative
+    // indices count back from the global offset of their chunk
+    std::vector<char> buffer;
+    for (Chunk &chunk : chunks) {
+        std::vector<Chunk::Statement>::const_iterator statement = chunk.statements.begin();
+        for (size_t faceIndex = 0; faceIndex <= chunk.faces.size(); ++faceIndex) {
+            for (; statement != chunk.statements.end() && statement->faceIndex == faceIndex; ++statement) {
+                buffer.assign(statement->line.begin(), statement->line.end());
+                buffer.push_back('\n');
+                buffer.push_back('\0');
+                setBuffer(buffer);
+                parseLine();
+            }
+            if (faceIndex < chunk.faces.size()) {
+                const Chunk::FaceDefinitions &definitions = chunk.faceDefinitions[faceIndex];
+                storeFace(chunk.faces, faceIndex,
+                        chunk.vertexOffset + definitions.numVertices,
+                        chunk.textureCoordOffset + definitions.numTextureCoords,
+                        chunk.normalOffset + definitions.numNormals);
+            }
+        }
+        chunk.faces = ObjFile::FaceArray();
+        std::vector<Chunk::FaceDefinitions>().swap(chunk.faceDefinitions);
+    }
+}
+
+void ObjFileParser::parseLine() {
+    // handle cstype section end (http://paulbourke.net/dataformats/obj/)
+    if (m_insideCstype) {
+        switch (*m_DataIt) {
+        case 'e': {
+            std::string name;
             getNameNoSpace(m_DataIt, m_DataItEnd, name);
+            m_insideCstype = name != "end";
+        } break;
+        }
+        goto pf_skip_line;
+    }
 
-            size_t nextSpace = name.find(' ');
-            if (nextSpace != std::string::npos)
-                name = name.substr(0, nextSpace);
+    // parse line
+    switch (*m_DataIt) {
+    case 'v': // Parse a vertex texture coordinate
+    {
+        getVertexDefinition(m_pModel->mVertices, m_pModel->mNormals, m_pModel->mTextureCoord, m_pModel->mTextureCoordDim);
+    } break;
 
-            if (name == "usemtl") {
-                getMaterialDesc();
-            }
-        } break;
+    case 'p': // Parse a face, line or point statement
+    case 'l':
+    case 'f': {
+        getFace(*m_DataIt == 'f' ? aiPrimitiveType_POLYGON : (*m_DataIt == 'l' ? aiPrimitiveType_LINE : aiPrimitiveType_POINT));
+    } break;
 
-        case 'm': // Parse a material library or merging group ('mg')
-        {
-            std::string name;
+    case '#': // Parse a comment
+    {
+        getComment();
+    } break;
 
-            getNameNoSpace(m_DataIt, m_DataItEnd, name);
+    case 'u': // Parse a material desc. setter
+    {
+        std::string name;
 
-            size_t nextSpace = name.find(' ');
-            if (nextSpace != std::string::npos)
-                name = name.substr(0, nextSpace);
+        getNameNoSpace(m_DataIt, m_DataItEnd, name);
 
-            if (name == "mg")
-                getGroupNumberAndResolution();
-            else if (name == "mtllib")
-                getMaterialLib();
-            else
-                goto pf_skip_line;
-        } break;
+        size_t nextSpace = name.find(' ');
+        if (nextSpace != std::string::npos)
+            name = name.substr(0, nextSpace);
 
-        case 'g': // Parse group name
-        {
-            getGroupName();
-        } break;
+        if (name == "usemtl") {
+            getMaterialDesc();
+        }
+    } break;
 
-        case 's': // Parse group number
-        {
-            getGroupNumber();
-        } break;
+    case 'm': // Parse a material library or merging group ('mg')
+    {
+        std::string name;
 
-        case 'o': // Parse object name
-        {
-            getObjectName();
-        } break;
+        getNameNoSpace(m_DataIt, m_DataItEnd, name);
 
-        case 'c': // handle cstype section start
-        {
-            std::string name;
-            getNameNoSpace(m_DataIt, m_DataItEnd, name);
-            insideCstype = name == "cstype";
+        size_t nextSpace = name.find(' ');
+        if (nextSpace != std::string::npos)
+            name = name.substr(0, nextSpace);
+
+        if (name == "mg")
+            getGroupNumberAndResolution();
+        else if (name == "mtllib")
+            getMaterialLib();
+        else
             goto pf_skip_line;
-        } break;
+    } break;
+
+    case 'g': // Parse group name
+    {
+        getGroupName();
+    } break;
+
+    case 's': // Parse group number
+    {
+        getGroupNumber();
+    } break;
+
+    case 'o': // Parse object name
+    {
+        getObjectName();
+    } break;
+
+    case 'c': // handle cstype section start
+    {
+        std::string name;
+        getNameNoSpace(m_DataIt, m_DataItEnd, name);
+        m_insideCstype = name == "cstype";
+        goto pf_skip_line;
+    } break;
+
+    default: {
+    pf_skip_line:
+        m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+    } break;
+    }
+}
 
-        default: {
-        pf_skip_line:
-            m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
-        } break;
+void ObjFileParser::parseChunkLine(Chunk &chunk) {
+    switch (*m_DataIt) {
+    case 'v': {
+        getVertexDefinition(chunk.vertices, chunk.normals, chunk.textureCoords, chunk.textureCoordDim);
+    } break;
+
+    case 'p':
+    case 'l':
+    case 'f': {
+        if (getFaceIndices(*m_DataIt == 'f' ? aiPrimitiveType_POLYGON : (*m_DataIt == 'l' ? aiPrimitiveType_LINE : aiPrimitiveType_POINT), chunk.faces)) {
+            chunk.faceDefinitions.push_back({ static_cast<unsigned int>(chunk.vertices.size()),
+                    static_cast<unsigned int>(chunk.textureCoords.size()),
+                    static_cast<unsigned int>(chunk.normals.size()) });
         }
+    } break;
+
+    case 'u':
+    case 'm':
+    case 'g':
+    case 's':
+    case 'o': {
+        const char *lineEnd = static_cast<const char *>(::memchr(m_DataIt, '\n', static_cast<size_t>(m_DataItEnd - m_DataIt)));
+        if (nullptr == lineEnd) {
+            lineEnd = m_DataItEnd;
+        }
+        chunk.statements.push_back({ chunk.faces.size(), std::string(m_DataIt, lineEnd) });
+        m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+    } break;
+
+    case 'c': {
+        std::string name;
+        getNameNoSpace(m_DataIt, m_DataItEnd, name);
+        chunk.hasCurveSection = chunk.hasCurveSection || name == "cstype";
+        m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+    } break;
+
+    default: {
+        m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+    } break;
     }
 }
 
-void ObjFileParser::copyNextWord(char *pBuffer, size_t length) {
-    size_t index = 0;
+ai_real ObjFileParser::getNextFloat() {
     m_DataIt = getNextWord<DataArrayIt>(m_DataIt, m_DataItEnd);
     if (*m_DataIt == '\\') {
         ++m_DataIt;
         ++m_DataIt;
         m_DataIt = getNextWord<DataArrayIt>(m_DataIt, m_DataItEnd);
     }
+
+    // Every line is terminated, so the number can be read without copying it
+    ai_real value(0.0);
+    m_DataIt = fast_atoreal_move_bounded<ai_real>(m_DataIt, m_DataItEnd, value);
+
+    // Skip whatever is left of the token
     while (m_DataIt != m_DataItEnd && !IsSpaceOrNewLine(*m_DataIt)) {
-        pBuffer[index] = *m_DataIt;
-        index++;
-        if (index == length - 1) {
-            break;
-        }
         ++m_DataIt;
     }
 
-    pBuffer[index] = '\0';
+    return value;
 }
 
 static bool isDataDefinitionEnd(const char *tmp) {
@@ -298,25 +551,42 @@ size_t ObjFileParser::getNumComponentsInDataDefinition() {
     return numComponents;
 }
 
+void ObjFileParser::getVertexDefinition(std::vector<aiVector3D> &vertices, std::vector<aiVector3D> &normals,
+        std::vector<aiVector3D> &textureCoords, unsigned int &textureCoordDim) {
+    ++m_DataIt;
+    if (*m_DataIt == ' ' || *m_DataIt == '\t') {
+        size_t numComponents = getNumComponentsInDataDefinition();
+        if (numComponents == 3) {
+            // read in vertex definition
+            getVector3(vertices);
+        } else if (numComponents == 4) {
+            // read in vertex definition (homogeneous coords)
+            getHomogeneousVector3(vertices);
+        } else if (numComponents == 6) {
+        }
+    } else if (*m_DataIt == 't') {
+        // read in texture coordinate ( 2D or 3D )
+        ++m_DataIt;
+        size_t dim = getTexCoordVector(textureCoords);
+        textureCoordDim = std::max(textureCoordDim, (unsigned int)dim);
+    } else if (*m_DataIt == 'n') {
+        // Read in normal vector definition
+        ++m_DataIt;
+        getVector3(normals);
+    }
+}
+
 size_t ObjFileParser::getTexCoordVector(std::vector<aiVector3D> &point3d_array) {
     size_t numComponents = getNumComponentsInDataDefinition();
     ai_real x = 0.0f, y = 0.0f, z = 0.0f;
     if (2 == numComponents) {
-        copyNextWord(m_buffer, Buffersize);
-        x = (ai_real)fast_atof(m_buffer);
-
-        copyNextWord(m_buffer, Buffersize);
-        y = (ai_real)fast_atof(m_buffer);
+        x = getNextFloat();
+        y = getNextFloat();
         z = 0.0;
     } else if (3 == numComponents) {
-        copyNextWord(m_buffer, Buffersize);
-        x = (ai_real)fast_atof(m_buffer);
-
-        copyNextWord(m_buffer, Buffersize);
-        y = (ai_real)fast_atof(m_buffer);
-
-        copyNextWord(m_buffer, Buffersize);
-        z = (ai_real)fast_atof(m_buffer);
+        x = getNextFloat();
+        y = getNextFloat();
+        z = getNextFloat();
     }
 
     // Coerce nan and inf to 0 as is the OBJ default value
@@ -336,14 +606,9 @@ size_t ObjFileParser::getTexCoordVector(std::vector<aiVector3D> &point3d_array)
 
 void ObjFileParser::getVector3(std::vector<aiVector3D> &point3d_array) {
     ai_real x, y, z;
-    copyNextWord(m_buffer, Buffersize);
-    x = (ai_real)fast_atof(m_buffer);
-
-    copyNextWord(m_buffer, Buffersize);
-    y = (ai_real)fast_atof(m_buffer);
-
-    copyNextWord(m_buffer, Buffersize);
-    z = (ai_real)fast_atof(m_buffer);
+    x = getNextFloat();
+    y = getNextFloat();
+    z = getNextFloat();
 
     point3d_array.emplace_back(x, y, z);
     m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
@@ -351,17 +616,10 @@ void ObjFileParser::getVector3(std::vector<aiVector3D> &point3d_array) {
 
 void ObjFileParser::getHomogeneousVector3(std::vector<aiVector3D> &point3d_array) {
     ai_real x, y, z, w;
-    copyNextWord(m_buffer, Buffersize);
-    x = (ai_real)fast_atof(m_buffer);
-
-    copyNextWord(m_buffer, Buffersize);
-    y = (ai_real)fast_atof(m_buffer);
-
-    copyNextWord(m_buffer, Buffersize);
-    z = (ai_real)fast_atof(m_buffer);
-
-    copyNextWord(m_buffer, Buffersize);
-    w = (ai_real)fast_atof(m_buffer);
+    x = getNextFloat();
+    y = getNextFloat();
+    z = getNextFloat();
+    w = getNextFloat();
 
     point3d_array.emplace_back(x / w, y / w, z / w);
     m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
@@ -369,25 +627,15 @@ void ObjFileParser::getHomogeneousVector3(std::vector<aiVector3D> &point3d_array
 
 void ObjFileParser::getTwoVectors3(std::vector<aiVector3D> &point3d_array_a, std::vector<aiVector3D> &point3d_array_b) {
     ai_real x, y, z;
-    copyNextWord(m_buffer, Buffersize);
-    x = (ai_real)fast_atof(m_buffer);
-
-    copyNextWord(m_buffer, Buffersize);
-    y = (ai_real)fast_atof(m_buffer);
-
-    copyNextWord(m_buffer, Buffersize);
-    z = (ai_real)fast_atof(m_buffer);
+    x = getNextFloat();
+    y = getNextFloat();
+    z = getNextFloat();
 
     point3d_array_a.emplace_back(x, y, z);
 
-    copyNextWord(m_buffer, Buffersize);
-    x = (ai_real)fast_atof(m_buffer);
-
-    copyNextWord(m_buffer, Buffersize);
-    y = (ai_real)fast_atof(m_buffer);
-
-    copyNextWord(m_buffer, Buffersize);
-    z = (ai_real)fast_atof(m_buffer);
+    x = getNextFloat();
+    y = getNextFloat();
+    z = getNextFloat();
 
     point3d_array_b.emplace_back(x, y, z);
 
@@ -396,11 +644,8 @@ void ObjFileParser::getTwoVectors3(std::vector<aiVector3D> &point3d_array_a, std
 
 void ObjFileParser::getVector2(std::vector<aiVector2D> &point2d_array) {
     ai_real x, y;
-    copyNextWord(m_buffer, Buffersize);
-    x = (ai_real)fast_atof(m_buffer);
-
-    copyNextWord(m_buffer, Buffersize);
-    y = (ai_real)fast_atof(m_buffer);
+    x = getNextFloat();
+    y = getNextFloat();
 
     point2d_array.emplace_back(x, y);
 
@@ -410,20 +655,25 @@ void ObjFileParser::getVector2(std::vector<aiVector2D> &point2d_array) {
 static constexpr char DefaultObjName[] = "defaultobject";
 
 void ObjFileParser::getFace(aiPrimitiveType type) {
-    m_DataIt = getNextToken<DataArrayIt>(m_DataIt, m_DataItEnd);
-    if (m_DataIt == m_DataItEnd || *m_DataIt == '\0') {
+    ObjFile::FaceArray &face = *m_pFaceBuffer;
+    face.clear();
+    if (!getFaceIndices(type, face)) {
         return;
     }
 
-    ObjFile::Face *face = new ObjFile::Face(type);
-    bool hasNormal = false;
+    storeFace(face, 0,
+            static_cast<unsigned int>(m_pModel->mVertices.size()),
+            static_cast<unsigned int>(m_pModel->mTextureCoord.size()),
+            static_cast<unsigned int>(m_pModel->mNormals.size()));
+}
 
-    const int vSize = static_cast<unsigned int>(m_pModel->mVertices.size());
-    const int vtSize = static_cast<unsigned int>(m_pModel->mTextureCoord.size());
-    const int vnSize = static_cast<unsigned int>(m_pModel->mNormals.size());
+bool ObjFileParser::getFaceIndices(aiPrimitiveType type, ObjFile::FaceArray &faces) {
+    m_DataIt = getNextToken<DataArrayIt>(m_DataIt, m_DataItEnd);
+    if (m_DataIt == m_DataItEnd || *m_DataIt == '\0') {
+        return false;
+    }
 
-    const bool vt = (!m_pModel->mTextureCoord.empty());
-    const bool vn = (!m_pModel->mNormals.empty());
+    bool valid = true;
     int iPos = 0;
     while (m_DataIt < m_DataItEnd) {
         int iStep = 1;
@@ -433,8 +683,6 @@ void ObjFileParser::getFace(aiPrimitiveType type) {
         }
 
         if (*m_DataIt == '/') {
-            if (type == aiPrimitiveType_POINT) {
-            }
             iPos++;
         } else if (IsSpaceOrNewLine(*m_DataIt)) {
             iPos = 0;
@@ -452,55 +700,39 @@ void ObjFileParser::getFace(aiPrimitiveType type) {
                 ++iStep;
             }
 
-            if (iPos == 1 && !vt && vn)
-                iPos = 2; // skip texture coords for normals if there are no tex coords
-
-            if (iVal > 0) {
-                // Store parsed index
-                if (0 == iPos) {
-                    face->m_vertices.push_back(iVal - 1);
-                } else if (1 == iPos) {
-                    face->m_texturCoords.push_back(iVal - 1);
-                } else if (2 == iPos) {
-                    face->m_normals.push_back(iVal - 1);
-                    hasNormal = true;
-                } else {
-                    reportErrorTokenInFace();
-                }
-            } else if (iVal < 0) {
-                // Store relatively index
-                if (0 == iPos) {
-                    face->m_vertices.push_back(vSize + iVal);
-                } else if (1 == iPos) {
-                    face->m_texturCoords.push_back(vtSize + iVal);
-                } else if (2 == iPos) {
-                    face->m_normals.push_back(vnSize + iVal);
-                    hasNormal = true;
-                } else {
-                    reportErrorTokenInFace();
-                }
+            //On error, std::atoi will return 0 which is not a valid value
+            if (0 == iVal) {
+                valid = false;
+                break;
+            }
+
+            // Store the index as written, relative ones are resolved later
+            if (0 == iPos) {
+                faces.m_vertices.push_back(static_cast<unsigned int>(iVal));
+            } else if (1 == iPos) {
+                faces.m_texturCoords.push_back(static_cast<unsigned int>(iVal));
+            } else if (2 == iPos) {
+                faces.m_normals.push_back(static_cast<unsigned int>(iVal));
             } else {
-                //On error, std::atoi will return 0 which is not a valid value
-                delete face;
+                break;
             }
         }
         m_DataIt += iStep;
     }
 
-    if (face->m_vertices.empty()) {
-        // skip line and clean up
-        m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
-        delete face;
-        return;
+    // Skip the rest of the line
+    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+    if (!valid || faces.m_vertices.size() == faces.m_vertexOffsets.back()) {
+        faces.discardFace();
+        return false;
     }
 
-    // Set active material, if one set
-    if (nullptr != m_pModel->mCurrentMaterial) {
-        face->m_pMaterial = m_pModel->mCurrentMaterial;
-    } else {
-        face->m_pMaterial = m_pModel->mDefaultMaterial;
-    }
+    faces.closeFace(type);
+    return true;
+}
 
+void ObjFileParser::storeFace(const ObjFile::FaceArray &faces, size_t index, unsigned int numVertices,
+        unsigned int numTextureCoords, unsigned int numNormals) {
     // Create a default object, if nothing is there
     if (nullptr == m_pModel->mCurrentObject) {
         createObject(DefaultObjName);
@@ -512,14 +744,26 @@ void ObjFileParser::getFace(aiPrimitiveType type) {
     }
 
     // Store the face
-    m_pModel->mCurrentMesh->m_Faces.emplace_back(face);
-    m_pModel->mCurrentMesh->m_uiNumIndices += static_cast<unsigned int>(face->m_vertices.size());
-    m_pModel->mCurrentMesh->m_uiUVCoordinates[0] += static_cast<unsigned int>(face->m_texturCoords.size());
-    if (!m_pModel->mCurrentMesh->m_hasNormals && hasNormal) {
-        m_pModel->mCurrentMesh->m_hasNormals = true;
+    ObjFile::Mesh *mesh = m_pModel->mCurrentMesh;
+    ObjFile::FaceArray &target = mesh->m_Faces;
+    appendIndices(target.m_vertices, faces.m_vertices, faces.m_vertexOffsets[index], faces.m_vertexOffsets[index + 1], numVertices);
+
+    // skip texture coords for normals if there are no tex coords
+    if (0 == numTextureCoords && 0 != numNormals && 0 != faces.numTexturCoords(index)) {
+        appendIndices(target.m_normals, faces.m_normals, faces.m_normalOffsets[index], faces.m_normalOffsets[index + 1], numNormals);
+        appendIndices(target.m_normals, faces.m_texturCoords, faces.m_texturCoordOffsets[index], faces.m_texturCoordOffsets[index + 1], numNormals);
+    } else {
+        appendIndices(target.m_texturCoords, faces.m_texturCoords, faces.m_texturCoordOffsets[index], faces.m_texturCoordOffsets[index + 1], numTextureCoords);
+        appendIndices(target.m_normals, faces.m_normals, faces.m_normalOffsets[index], faces.m_normalOffsets[index + 1], numNormals);
+    }
+    target.closeFace(faces.m_PrimitiveTypes[index]);
+
+    const size_t stored = target.size() - 1;
+    mesh->m_uiNumIndices += target.numVertices(stored);
+    mesh->m_uiUVCoordinates[0] += target.numTexturCoords(stored);
+    if (!mesh->m_hasNormals && 0 != target.numNormals(stored)) {
+        mesh->m_hasNormals = true;
     }
-    // Skip the rest of the line
-    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
 }
 
 void ObjFileParser::getMaterialDesc() {
@@ -529,7 +773,7 @@ void ObjFileParser::getMaterialDesc() {
         return;
     }
 
-    char *pStart = &(*m_DataIt);
+    const char *pStart = &(*m_DataIt);
     while (m_DataIt != m_DataItEnd && !IsLineEnd(*m_DataIt)) {
         ++m_DataIt;
     }
@@ -592,7 +836,7 @@ void ObjFileParser::getMaterialLib() {
         return;
     }
 
-    char *pStart = &(*m_DataIt);
+    const char *pStart = &(*m_DataIt);
     while (m_DataIt != m_DataItEnd && !IsLineEnd(*m_DataIt)) {
         ++m_DataIt;
     }
@@ -649,7 +893,7 @@ void ObjFileParser::getNewMaterial() {
         return;
     }
 
-    char *pStart = &(*m_DataIt);
+    const char *pStart = &(*m_DataIt);
     std::string strMat(pStart, *m_DataIt);
     while (m_DataIt != m_DataItEnd && IsSpaceOrNewLine(*m_DataIt)) {
         ++m_DataIt;
@@ -742,7 +986,7 @@ void ObjFileParser::getObjectName() {
     if (m_DataIt == m_DataItEnd) {
         return;
     }
-    char *pStart = &(*m_DataIt);
+    const char *pStart = &(*m_DataIt);
     while (m_DataIt != m_DataItEnd && !IsSpaceOrNewLine(*m_DataIt)) {
         ++m_DataIt;
     }
@@ -788,6 +1032,7 @@ void ObjFileParser::createObject(const std::string &objName) {
 // -------------------------------------------------------------------
 //  Creates a new mesh
 void ObjFileParser::createMesh(const std::string &meshName) {
+    finishMesh();
 
     m_pModel->mCurrentMesh = new ObjFile::Mesh(meshName);
     m_pModel->mMeshes.push_back(m_pModel->mCurrentMesh);
@@ -795,6 +1040,18 @@ void ObjFileParser::createMesh(const std::string &meshName) {
     if (nullptr != m_pModel->mCurrentObject) {
         m_pModel->mCurrentObject->m_Meshes.push_back(meshId);
     }
+    m_pMeshObject = m_pModel->mCurrentObject;
+}
+
+void ObjFileParser::finishMesh() {
+    if (!m_meshCallback || nullptr == m_pModel->mCurrentMesh) {
+        return;
+    }
+
+    // Meshes are never continued once a new one was created
+    if (nullptr == m_pMeshObject || m_meshCallback(*m_pModel, *m_pMeshObject, static_cast<unsigned int>(m_pModel->mMeshes.size() - 1))) {
+        m_pModel->mCurrentMesh->m_Faces = ObjFile::FaceArray();
+    }
 }
 
 // -------------------------------------------------------------------
@@ -818,12 +1075,6 @@ bool ObjFileParser::needsNewMesh(const std::string &materialName) {
     return newMat;
 }
 
-// -------------------------------------------------------------------
-//  Shows an error in parsing process.
-void ObjFileParser::reportErrorTokenInFace() {
-    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
-}
-
 // -------------------------------------------------------------------
 
 } // Namespace Assimp
@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/mesh.h>
 #include <assimp/vector2.h>
 #include <assimp/vector3.h>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -59,6 +60,7 @@ struct Object;
 struct Material;
 struct Point3;
 struct Point2;
+struct FaceArray;
 } // namespace ObjFile
 
 class ObjFileImporter;
@@ -70,13 +72,20 @@ class ObjFileParser {
 public:
     static const size_t Buffersize = 4096;
     typedef std::vector<char> DataArray;
-    typedef std::vector<char>::iterator DataArrayIt;
-    typedef std::vector<char>::const_iterator ConstDataArrayIt;
+    typedef const char *DataArrayIt;
+    typedef const char *ConstDataArrayIt;
+    /// Called for every mesh of an object once all of its faces are read. The face data is released afterwards,
+    /// unless the callback returns false to keep it for a conversion after parsing.
+    typedef std::function<bool(const ObjFile::Model &model, const ObjFile::Object &object, unsigned int meshIndex)> MeshCallback;
 
     /// @brief  The default constructor.
     ObjFileParser();
     /// @brief  Constructor with data array.
-    ObjFileParser(IOStreamBuffer<char> &streamBuffer, const std::string &modelName, IOSystem *io, const std::string &originalObjFileName);
+    ObjFileParser(IOStreamBuffer<char> &streamBuffer, const std::string &modelName, IOSystem *io, const std::string &originalObjFileName,
+            MeshCallback meshCallback = MeshCallback());
+    /// @brief  Constructor with an in-memory or memory-mapped file, tokenizes in place.
+    ObjFileParser(const char *begin, const char *end, const std::string &modelName, IOSystem *io, const std::string &originalObjFileName,
+            unsigned int numThreads = 1, MeshCallback meshCallback = MeshCallback());
     /// @brief  Destructor
     ~ObjFileParser();
     /// @brief  If you want to load in-core data.
@@ -88,14 +97,30 @@ public:
     ObjFileParser &operator=(const ObjFileParser& ) = delete;
 
 protected:
+    /// A line-aligned part of the file, parsed by one worker.
+    struct Chunk;
+
+    /// Creates the model instance and its default material.
+    void createModel(const std::string &modelName);
     /// Parse the loaded file
     void parseFile(IOStreamBuffer<char> &streamBuffer);
-    /// Method to copy the new delimited word in the current line.
-    void copyNextWord(char *pBuffer, size_t length);
+    /// Parse a memory-mapped file without copying its lines, into the chunk if one is given.
+    void parseMappedFile(const char *begin, const char *end, Chunk *chunk = nullptr);
+    /// Parse an in-memory file in line-aligned chunks on several threads.
+    void parseFileParallel(const char *begin, const char *end, unsigned int numThreads);
+    /// Parse the line between the data iterators.
+    void parseLine();
+    /// Parse the line between the data iterators into a chunk.
+    void parseChunkLine(Chunk &chunk);
+    /// Parses the next delimited number in the current line in place.
+    ai_real getNextFloat();
     /// Method to copy the new line.
     //    void copyNextLine(char *pBuffer, size_t length);
     /// Get the number of components in a line.
     size_t getNumComponentsInDataDefinition();
+    /// Stores the following vertex, normal or texture coordinate definition.
+    void getVertexDefinition(std::vector<aiVector3D> &vertices, std::vector<aiVector3D> &normals,
+            std::vector<aiVector3D> &textureCoords, unsigned int &textureCoordDim);
     /// Stores the vector
     size_t getTexCoordVector(std::vector<aiVector3D> &point3d_array);
     /// Stores the following 3d vector.
@@ -108,6 +133,11 @@ protected:
     void getVector2(std::vector<aiVector2D> &point2d_array);
     /// Stores the following face.
     void getFace(aiPrimitiveType type);
+    /// Appends the indices of the following face as written in the file, returns false for an invalid face.
+    bool getFaceIndices(aiPrimitiveType type, ObjFile::FaceArray &faces);
+    /// Resolves a face against the given numbers of definitions and assigns it to the current mesh.
+    void storeFace(const ObjFile::FaceArray &faces, size_t index, unsigned int numVertices,
+            unsigned int numTextureCoords, unsigned int numNormals);
     /// Reads the material description.
     void getMaterialDesc();
     /// Gets a comment.
@@ -130,10 +160,10 @@ protected:
     void createObject(const std::string &strObjectName);
     /// Creates a new mesh.
     void createMesh(const std::string &meshName);
+    /// Hands the current mesh to the mesh callback and releases its faces, unless the callback keeps them.
+    void finishMesh();
     /// Returns true, if a new mesh instance must be created.
     bool needsNewMesh(const std::string &rMaterialName);
-    /// Error report in token
-    void reportErrorTokenInFace();
 
 private:
     /// Default material name
@@ -144,10 +174,16 @@ private:
     DataArrayIt m_DataItEnd;
     //! Pointer to model instance
     std::unique_ptr<ObjFile::Model> m_pModel;
+    //! Indices of the face currently read, reused for every face
+    std::unique_ptr<ObjFile::FaceArray> m_pFaceBuffer;
+    //! Receives finished meshes, if set
+    MeshCallback m_meshCallback;
+    //! Object the current mesh was assigned to
+    ObjFile::Object *m_pMeshObject;
     //! Current line (for debugging)
     unsigned int m_uiLine;
-    //! Helper buffer
-    char m_buffer[Buffersize];
+    //! True while skipping a cstype section
+    bool m_insideCstype;
     /// Pointer to IO system instance.
     IOSystem *m_pIO;
     /// Path to the current model, name of the obj file where the buffer comes from
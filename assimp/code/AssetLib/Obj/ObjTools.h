@@ -146,7 +146,7 @@ inline char_t getName(char_t it, char_t end, std::string &name) {
         return end;
     }
 
-    char *pStart = &(*it);
+    const char *pStart = &(*it);
     while (!isEndOfBuffer(it, end) && !IsLineEnd(*it)) {
         ++it;
     }
@@ -159,7 +159,7 @@ inline char_t getName(char_t it, char_t end, std::string &name) {
     while (&(*it) < pStart) {
         ++it;
     }
-    std::string strName(pStart, &(*it));
+    std::string strName(pStart, static_cast<const char *>(&(*it)));
     if (!strName.empty()) {
         name = strName;
     }
@@ -183,7 +183,7 @@ inline char_t getNameNoSpace(char_t it, char_t end, std::string &name) {
         return end;
     }
 
-    char *pStart = &(*it);
+    const char *pStart = &(*it);
     while (!isEndOfBuffer(it, end) && !IsLineEnd(*it) && !IsSpaceOrNewLine(*it)) {
         ++it;
     }
@@ -198,7 +198,7 @@ inline char_t getNameNoSpace(char_t it, char_t end, std::string &name) {
     while (&(*it) < pStart) {
         ++it;
     }
-    std::string strName(pStart, &(*it));
+    std::string strName(pStart, static_cast<const char *>(&(*it)));
     if (!strName.empty()) {
         name = strName;
     }
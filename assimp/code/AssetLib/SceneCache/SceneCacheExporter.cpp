@@ -0,0 +1,512 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file  SceneCacheExporter.cpp
+ *  @brief Implementation of the writer for the binary scene cache.
+ */
+
+#ifndef ASSIMP_BUILD_NO_SCENECACHE_IMPORTER
+
+#include "SceneCacheExporter.h"
+#include "SceneCacheFormat.h"
+
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
+#include <assimp/scene.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Assimp {
+
+using namespace SceneCache;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Collects records and arrays into one aligned blob.
+class BlobWriter {
+public:
+    BlobWriter() :
+            mData(sizeof(Header)) {}
+
+    // Appends raw bytes at the next aligned offset.
+    uint64_t Append(const void *data, size_t size) {
+        const uint64_t offset = (mData.size() + Alignment - 1) / Alignment * Alignment;
+        mData.resize(offset + size);
+        if (size > 0) {
+            ::memcpy(mData.data() + offset, data, size);
+        }
+        return offset;
+    }
+
+    template <typename T>
+    ArrayRef AppendArray(const T *data, size_t count) {
+        if (nullptr == data) {
+            return ArrayRef{ 0, 0 };
+        }
+        return ArrayRef{ Append(data, count * sizeof(T)), count };
+    }
+
+    ArrayRef AppendString(const aiString &str) {
+        return ArrayRef{ Append(str.data, str.length), str.length };
+    }
+
+    template <typename T>
+    ArrayRef AppendRecords(const std::vector<T> &records) {
+        return ArrayRef{ Append(records.data(), records.size() * sizeof(T)), records.size() };
+    }
+
+    std::vector<char> &GetData() {
+        return mData;
+    }
+
+private:
+    std::vector<char> mData;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Writes all parts of a scene, nodes and meshes are referred to by their index.
+class SceneWriter {
+public:
+    explicit SceneWriter(const aiScene *scene) :
+            mScene(scene) {
+        CollectNodes(scene->mRootNode, -1);
+        for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+            mMeshIndices[scene->mMeshes[i]] = static_cast<int32_t>(i);
+        }
+    }
+
+    uint64_t Write(BlobWriter &blob);
+
+private:
+    void CollectNodes(const aiNode *node, int32_t parent);
+    int32_t GetNodeIndex(const aiNode *node) const;
+    uint64_t WriteMetadata(BlobWriter &blob, const aiMetadata *metadata);
+    MeshRecord WriteMesh(BlobWriter &blob, const aiMesh *mesh);
+    MaterialRecord WriteMaterial(BlobWriter &blob, const aiMaterial *material);
+    AnimationRecord WriteAnimation(BlobWriter &blob, const aiAnimation *animation);
+    TextureRecord WriteTexture(BlobWriter &blob, const aiTexture *texture);
+    SkeletonRecord WriteSkeleton(BlobWriter &blob, const aiSkeleton *skeleton);
+
+    const aiScene *mScene;
+    std::vector<std::pair<const aiNode *, int32_t>> mNodes;
+    std::unordered_map<const aiNode *, int32_t> mNodeIndices;
+    std::unordered_map<const aiMesh *, int32_t> mMeshIndices;
+};
+
+// ------------------------------------------------------------------------------------------------
+void SceneWriter::CollectNodes(const aiNode *node, int32_t parent) {
+    if (nullptr == node) {
+        return;
+    }
+    const int32_t index = static_cast<int32_t>(mNodes.size());
+    mNodes.emplace_back(node, parent);
+    mNodeIndices[node] = index;
+    for (unsigned int i = 0; i < node->mNumChildren; ++i) {
+        CollectNodes(node->mChildren[i], index);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+int32_t SceneWriter::GetNodeIndex(const aiNode *node) const {
+    auto it = mNodeIndices.find(node);
+    return it == mNodeIndices.end() ? -1 : it->second;
+}
+
+// ------------------------------------------------------------------------------------------------
+uint64_t SceneWriter::WriteMetadata(BlobWriter &blob, const aiMetadata *metadata) {
+    if (nullptr == metadata) {
+        return 0;
+    }
+
+    std::vector<MetadataEntryRecord> entries(metadata->mNumProperties);
+    for (unsigned int i = 0; i < metadata->mNumProperties; ++i) {
+        const aiMetadataEntry &entry = metadata->mValues[i];
+        MetadataEntryRecord &record = entries[i];
+        record.mKey = blob.AppendString(metadata->mKeys[i]);
+        record.mType = static_cast<uint32_t>(entry.mType);
+        record.mPadding = 0;
+        record.mData = ArrayRef{ 0, 0 };
+        if (nullptr == entry.mData) {
+            continue;
+        }
+        switch (entry.mType) {
+        case AI_BOOL:
+            record.mData = blob.AppendArray(static_cast<const bool *>(entry.mData), 1);
+            break;
+        case AI_INT32:
+            record.mData = blob.AppendArray(static_cast<const int32_t *>(entry.mData), 1);
+            break;
+        case AI_UINT64:
+            record.mData = blob.AppendArray(static_cast<const uint64_t *>(entry.mData), 1);
+            break;
+        case AI_FLOAT:
+            record.mData = blob.AppendArray(static_cast<const float *>(entry.mData), 1);
+            break;
+        case AI_DOUBLE:
+            record.mData = blob.AppendArray(static_cast<const double *>(entry.mData), 1);
+            break;
+        case AI_AISTRING:
+            record.mData = blob.AppendString(*static_cast<const aiString *>(entry.mData));
+            break;
+        case AI_AIVECTOR3D:
+            record.mData = blob.AppendArray(static_cast<const aiVector3D *>(entry.mData), 1);
+            break;
+        case AI_AIMETADATA:
+            record.mData = ArrayRef{ WriteMetadata(blob, static_cast<const aiMetadata *>(entry.mData)), 1 };
+            break;
+        case AI_INT64:
+            record.mData = blob.AppendArray(static_cast<const int64_t *>(entry.mData), 1);
+            break;
+        case AI_UINT32:
+            record.mData = blob.AppendArray(static_cast<const uint32_t *>(entry.mData), 1);
+            break;
+        default:
+            break;
+        }
+    }
+
+    MetadataRecord record;
+    record.mEntries = blob.AppendRecords(entries);
+    return blob.Append(&record, sizeof(record));
+}
+
+// ------------------------------------------------------------------------------------------------
+MeshRecord SceneWriter::WriteMesh(BlobWriter &blob, const aiMesh *mesh) {
+    MeshRecord record = MeshRecord();
+    record.mName = blob.AppendString(mesh->mName);
+    record.mVertices = blob.AppendArray(mesh->mVertices, mesh->mNumVertices);
+    record.mNormals = blob.AppendArray(mesh->mNormals, mesh->mNumVertices);
+    record.mTangents = blob.AppendArray(mesh->mTangents, mesh->mNumVertices);
+    record.mBitangents = blob.AppendArray(mesh->mBitangents, mesh->mNumVertices);
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        record.mTextureCoords[i] = blob.AppendArray(mesh->mTextureCoords[i], mesh->mNumVertices);
+        record.mNumUVComponents[i] = mesh->mNumUVComponents[i];
+        if (nullptr != mesh->mTextureCoordsNames && nullptr != mesh->mTextureCoordsNames[i]) {
+            record.mTextureCoordsNames[i] = blob.AppendString(*mesh->mTextureCoordsNames[i]);
+        }
+    }
+
+    // faces go into one index array, their sizes are only stored if they differ
+    std::vector<unsigned int> indices, faceSizes;
+    record.mFaceSize = mesh->mNumFaces > 0 ? mesh->mFaces[0].mNumIndices : 0;
+    for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+        const aiFace &face = mesh->mFaces[i];
+        indices.insert(indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
+        faceSizes.push_back(face.mNumIndices);
+        if (face.mNumIndices != record.mFaceSize) {
+            record.mFaceSize = 0;
+        }
+    }
+    if (nullptr != mesh->mFaces) {
+        record.mIndices = blob.AppendArray(indices.data(), indices.size());
+        if (0 == record.mFaceSize) {
+            record.mFaceSizes = blob.AppendArray(faceSizes.data(), faceSizes.size());
+        }
+    }
+
+    std::vector<BoneRecord> bones(mesh->mNumBones);
+    for (unsigned int i = 0; i < mesh->mNumBones; ++i) {
+        const aiBone *bone = mesh->mBones[i];
+        bones[i].mName = blob.AppendString(bone->mName);
+        bones[i].mWeights = blob.AppendArray(bone->mWeights, bone->mNumWeights);
+#ifndef ASSIMP_BUILD_NO_ARMATUREPOPULATE_PROCESS
+        bones[i].mArmature = GetNodeIndex(bone->mArmature);
+        bones[i].mNode = GetNodeIndex(bone->mNode);
+#else
+        bones[i].mArmature = -1;
+        bones[i].mNode = -1;
+#endif
+        bones[i].mOffsetMatrix = bone->mOffsetMatrix;
+    }
+    record.mBones = blob.AppendRecords(bones);
+
+    std::vector<AnimMeshRecord> animMeshes(mesh->mNumAnimMeshes);
+    for (unsigned int i = 0; i < mesh->mNumAnimMeshes; ++i) {
+        const aiAnimMesh *animMesh = mesh->mAnimMeshes[i];
+        AnimMeshRecord &animRecord = animMeshes[i];
+        animRecord.mName = blob.AppendString(animMesh->mName);
+        animRecord.mVertices = blob.AppendArray(animMesh->mVertices, animMesh->mNumVertices);
+        animRecord.mNormals = blob.AppendArray(animMesh->mNormals, animMesh->mNumVertices);
+        animRecord.mTangents = blob.AppendArray(animMesh->mTangents, animMesh->mNumVertices);
+        animRecord.mBitangents = blob.AppendArray(animMesh->mBitangents, animMesh->mNumVertices);
+        for (unsigned int c = 0; c < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++c) {
+            animRecord.mTextureCoords[c] = blob.AppendArray(animMesh->mTextureCoords[c], animMesh->mNumVertices);
+        }
+        animRecord.mNumVertices = animMesh->mNumVertices;
+        animRecord.mWeight = animMesh->mWeight;
+    }
+    record.mAnimMeshes = blob.AppendRecords(animMeshes);
+
+    record.mMeshlets = blob.AppendArray(mesh->mMeshlets, mesh->mNumMeshlets);
+    record.mMeshletVertices = blob.AppendArray(mesh->mMeshletVertices, mesh->mNumMeshletVertices);
+    record.mMeshletTriangles = blob.AppendArray(mesh->mMeshletTriangles, static_cast<size_t>(mesh->mNumMeshletTriangles) * 3);
+    record.mNumMeshletTriangles = nullptr != mesh->mMeshletTriangles ? mesh->mNumMeshletTriangles : 0;
+
+    std::vector<MeshRecord> lods;
+    for (unsigned int i = 0; nullptr != mesh->mLODs && i < mesh->mNumLODs; ++i) {
+        lods.push_back(WriteMesh(blob, mesh->mLODs[i]));
+    }
+    record.mLODs = blob.AppendRecords(lods);
+
+    record.mAABB = mesh->mAABB;
+    record.mPrimitiveTypes = mesh->mPrimitiveTypes;
+    record.mNumVertices = mesh->mNumVertices;
+    record.mNumFaces = mesh->mNumFaces;
+    record.mMaterialIndex = mesh->mMaterialIndex;
+    record.mMethod = static_cast<uint32_t>(mesh->mMethod);
+    return record;
+}
+
+// ------------------------------------------------------------------------------------------------
+MaterialRecord SceneWriter::WriteMaterial(BlobWriter &blob, const aiMaterial *material) {
+    std::vector<MaterialPropertyRecord> properties(material->mNumProperties);
+    for (unsigned int i = 0; i < material->mNumProperties; ++i) {
+        const aiMaterialProperty *property = material->mProperties[i];
+        properties[i].mKey = blob.AppendString(property->mKey);
+        properties[i].mData = blob.AppendArray(property->mData, property->mDataLength);
+        properties[i].mSemantic = property->mSemantic;
+        properties[i].mIndex = property->mIndex;
+        properties[i].mType = static_cast<uint32_t>(property->mType);
+        properties[i].mPadding = 0;
+    }
+
+    MaterialRecord record;
+    record.mProperties = blob.AppendRecords(properties);
+    return record;
+}
+
+// ------------------------------------------------------------------------------------------------
+AnimationRecord SceneWriter::WriteAnimation(BlobWriter &blob, const aiAnimation *animation) {
+    std::vector<NodeAnimRecord> channels(animation->mNumChannels);
+    for (unsigned int i = 0; i < animation->mNumChannels; ++i) {
+        const aiNodeAnim *channel = animation->mChannels[i];
+        channels[i].mNodeName = blob.AppendString(channel->mNodeName);
+        channels[i].mPositionKeys = blob.AppendArray(channel->mPositionKeys, channel->mNumPositionKeys);
+        channels[i].mRotationKeys = blob.AppendArray(channel->mRotationKeys, channel->mNumRotationKeys);
+        channels[i].mScalingKeys = blob.AppendArray(channel->mScalingKeys, channel->mNumScalingKeys);
+        channels[i].mPreState = static_cast<uint32_t>(channel->mPreState);
+        channels[i].mPostState = static_cast<uint32_t>(channel->mPostState);
+    }
+
+    std::vector<MeshAnimRecord> meshChannels(animation->mNumMeshChannels);
+    for (unsigned int i = 0; i < animation->mNumMeshChannels; ++i) {
+        const aiMeshAnim *channel = animation->mMeshChannels[i];
+        meshChannels[i].mName = blob.AppendString(channel->mName);
+        meshChannels[i].mKeys = blob.AppendArray(channel->mKeys, channel->mNumKeys);
+    }
+
+    std::vector<MeshMorphAnimRecord> morphChannels(animation->mNumMorphMeshChannels);
+    for (unsigned int i = 0; i < animation->mNumMorphMeshChannels; ++i) {
+        const aiMeshMorphAnim *channel = animation->mMorphMeshChannels[i];
+        std::vector<MeshMorphKeyRecord> keys(channel->mNumKeys);
+        for (unsigned int k = 0; k < channel->mNumKeys; ++k) {
+            const aiMeshMorphKey &key = channel->mKeys[k];
+            keys[k].mValues = blob.AppendArray(key.mValues, key.mNumValuesAndWeights);
+            keys[k].mWeights = blob.AppendArray(key.mWeights, key.mNumValuesAndWeights);
+            keys[k].mTime = key.mTime;
+        }
+        morphChannels[i].mName = blob.AppendString(channel->mName);
+        morphChannels[i].mKeys = blob.AppendRecords(keys);
+    }
+
+    AnimationRecord record;
+    record.mName = blob.AppendString(animation->mName);
+    record.mChannels = blob.AppendRecords(channels);
+    record.mMeshChannels = blob.AppendRecords(meshChannels);
+    record.mMorphMeshChannels = blob.AppendRecords(morphChannels);
+    record.mDuration = animation->mDuration;
+    record.mTicksPerSecond = animation->mTicksPerSecond;
+    return record;
+}
+
+// ------------------------------------------------------------------------------------------------
+TextureRecord SceneWriter::WriteTexture(BlobWriter &blob, const aiTexture *texture) {
+    TextureRecord record = TextureRecord();
+    record.mFilename = blob.AppendString(texture->mFilename);
+
+    // compressed textures hold mWidth bytes, all others mWidth * mHeight texels
+    const size_t size = 0 == texture->mHeight ? texture->mWidth :
+            static_cast<size_t>(texture->mWidth) * texture->mHeight * sizeof(aiTexel);
+    record.mData = blob.AppendArray(reinterpret_cast<const char *>(texture->pcData), size);
+    record.mWidth = texture->mWidth;
+    record.mHeight = texture->mHeight;
+    ::memcpy(record.mFormatHint, texture->achFormatHint, HINTMAXTEXTURELEN);
+    return record;
+}
+
+// ------------------------------------------------------------------------------------------------
+SkeletonRecord SceneWriter::WriteSkeleton(BlobWriter &blob, const aiSkeleton *skeleton) {
+    std::vector<SkeletonBoneRecord> bones(skeleton->mNumBones);
+    for (unsigned int i = 0; i < skeleton->mNumBones; ++i) {
+        const aiSkeletonBone *bone = skeleton->mBones[i];
+        SkeletonBoneRecord &boneRecord = bones[i];
+        boneRecord.mWeights = blob.AppendArray(bone->mWeights, bone->mNumnWeights);
+        boneRecord.mParent = bone->mParent;
+#ifndef ASSIMP_BUILD_NO_ARMATUREPOPULATE_PROCESS
+        boneRecord.mArmature = GetNodeIndex(bone->mArmature);
+        boneRecord.mNode = GetNodeIndex(bone->mNode);
+#else
+        boneRecord.mArmature = -1;
+        boneRecord.mNode = -1;
+#endif
+        auto it = mMeshIndices.find(bone->mMeshId);
+        boneRecord.mMesh = it == mMeshIndices.end() ? -1 : it->second;
+        boneRecord.mOffsetMatrix = bone->mOffsetMatrix;
+        boneRecord.mLocalMatrix = bone->mLocalMatrix;
+    }
+
+    SkeletonRecord record;
+    record.mName = blob.AppendString(skeleton->mName);
+    record.mBones = blob.AppendRecords(bones);
+    return record;
+}
+
+// ------------------------------------------------------------------------------------------------
+uint64_t SceneWriter::Write(BlobWriter &blob) {
+    std::vector<NodeRecord> nodes(mNodes.size());
+    for (size_t i = 0; i < mNodes.size(); ++i) {
+        const aiNode *node = mNodes[i].first;
+        nodes[i].mName = blob.AppendString(node->mName);
+        nodes[i].mMeshes = blob.AppendArray(node->mMeshes, node->mNumMeshes);
+        nodes[i].mMetaData = WriteMetadata(blob, node->mMetaData);
+        nodes[i].mParent = mNodes[i].second;
+        nodes[i].mNumChildren = node->mNumChildren;
+        nodes[i].mTransformation = node->mTransformation;
+    }
+
+    std::vector<MeshRecord> meshes;
+    meshes.reserve(mScene->mNumMeshes);
+    for (unsigned int i = 0; i < mScene->mNumMeshes; ++i) {
+        meshes.push_back(WriteMesh(blob, mScene->mMeshes[i]));
+    }
+    std::vector<MaterialRecord> materials;
+    materials.reserve(mScene->mNumMaterials);
+    for (unsigned int i = 0; i < mScene->mNumMaterials; ++i) {
+        materials.push_back(WriteMaterial(blob, mScene->mMaterials[i]));
+    }
+    std::vector<AnimationRecord> animations;
+    animations.reserve(mScene->mNumAnimations);
+    for (unsigned int i = 0; i < mScene->mNumAnimations; ++i) {
+        animations.push_back(WriteAnimation(blob, mScene->mAnimations[i]));
+    }
+    std::vector<TextureRecord> textures;
+    textures.reserve(mScene->mNumTextures);
+    for (unsigned int i = 0; i < mScene->mNumTextures; ++i) {
+        textures.push_back(WriteTexture(blob, mScene->mTextures[i]));
+    }
+    std::vector<SkeletonRecord> skeletons;
+    skeletons.reserve(mScene->mNumSkeletons);
+    for (unsigned int i = 0; i < mScene->mNumSkeletons; ++i) {
+        skeletons.push_back(WriteSkeleton(blob, mScene->mSkeletons[i]));
+    }
+
+    SceneRecord record;
+    record.mName = blob.AppendString(mScene->mName);
+    record.mMeshes = blob.AppendRecords(meshes);
+    record.mMaterials = blob.AppendRecords(materials);
+    record.mAnimations = blob.AppendRecords(animations);
+    record.mTextures = blob.AppendRecords(textures);
+    record.mSkeletons = blob.AppendRecords(skeletons);
+    record.mNodes = blob.AppendRecords(nodes);
+    record.mMetaData = WriteMetadata(blob, mScene->mMetaData);
+    return blob.Append(&record, sizeof(record));
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+bool ExportSceneCache(const char *pFile, IOSystem *pIOSystem, const aiScene *pScene,
+        uint64_t pKey, unsigned int pPostProcessing) {
+    if (nullptr == pFile || nullptr == pIOSystem || nullptr == pScene || nullptr == pScene->mRootNode) {
+        return false;
+    }
+
+    BlobWriter blob;
+    SceneWriter writer(pScene);
+    const uint64_t scene = writer.Write(blob);
+
+    std::vector<char> &data = blob.GetData();
+    Header header = Header();
+    ::memcpy(header.mMagic, Magic, sizeof(Magic));
+    header.mVersion = Version;
+    header.mLayout = GetLayoutSignature();
+    header.mKey = pKey;
+    header.mSize = data.size();
+    header.mScene = scene;
+    header.mPostProcessing = pPostProcessing;
+    header.mFlags = pScene->mFlags;
+    ::memcpy(data.data(), &header, sizeof(header));
+
+    // write to a temporary file first, an importer reading the cache concurrently
+    // must never see a partially written file
+    char suffix[32];
+    ::snprintf(suffix, sizeof(suffix), ".%08x.tmp", std::random_device()());
+    const std::string tmpFile = std::string(pFile) + suffix;
+
+    auto streamCloser = [&](IOStream *pStream) {
+        pIOSystem->Close(pStream);
+    };
+    std::unique_ptr<IOStream, decltype(streamCloser)> stream(pIOSystem->Open(tmpFile.c_str(), "wb"), streamCloser);
+    if (!stream) {
+        return false;
+    }
+    const bool written = stream->Write(data.data(), 1, data.size()) == data.size();
+    stream.reset();
+
+    if (!written || !pIOSystem->RenameFile(tmpFile, pFile)) {
+        pIOSystem->DeleteFile(tmpFile);
+        return false;
+    }
+    return true;
+}
+
+} // namespace Assimp
+
+#endif // !! ASSIMP_BUILD_NO_SCENECACHE_IMPORTER
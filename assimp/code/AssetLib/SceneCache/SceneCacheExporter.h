@@ -0,0 +1,75 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  SceneCacheExporter.h
+ *  @brief Declares the writer for the binary scene cache.
+ */
+#pragma once
+#ifndef AI_SCENECACHEEXPORTER_H_INC
+#define AI_SCENECACHEEXPORTER_H_INC
+
+#include <cstdint>
+
+struct aiScene;
+
+namespace Assimp {
+
+class IOSystem;
+
+// ------------------------------------------------------------------------------------------------
+/** Writes a fully processed scene to a scene cache file, see SceneCacheFormat.h.
+ *  @param pFile Path of the file to write.
+ *  @param pIOSystem IO system to open the file with.
+ *  @param pScene The scene to write.
+ *  @param pKey Key of the source file and the import settings, checked when
+ *    the file is loaded again.
+ *  @param pPostProcessing Post-processing steps which were applied to the scene.
+ *  The data is written to a temporary file which is then renamed to pFile, so
+ *  readers either see the complete file or none at all.
+ *  @return true if the file was written completely.
+ */
+bool ExportSceneCache(const char *pFile, IOSystem *pIOSystem, const aiScene *pScene,
+        uint64_t pKey, unsigned int pPostProcessing);
+
+} // namespace Assimp
+
+#endif // AI_SCENECACHEEXPORTER_H_INC
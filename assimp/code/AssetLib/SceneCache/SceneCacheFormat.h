@@ -0,0 +1,276 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  SceneCacheFormat.h
+ *  @brief Binary layout of the scene cache files.
+ *
+ *  A scene cache file is one flat blob: a header, followed by records and
+ *  arrays which all start at a multiple of 16 bytes. Records refer to their
+ *  arrays and to other records by offsets from the start of the blob, so a
+ *  mapped file can be used as it is and every array is restored with a single
+ *  copy. Arrays are stored in the in-memory layout of this build. The header
+ *  keeps a signature of that layout, and caches written by a different build
+ *  are rejected.
+ */
+#pragma once
+#ifndef AI_SCENECACHEFORMAT_H_INC
+#define AI_SCENECACHEFORMAT_H_INC
+
+#include <assimp/anim.h>
+#include <assimp/mesh.h>
+#include <assimp/texture.h>
+#include <cstdint>
+
+namespace Assimp {
+namespace SceneCache {
+
+/** Magic string at the start of every cache file. */
+static const char Magic[8] = { 'A', 'I', 'S', 'C', 'A', 'C', 'H', 'E' };
+
+/** Version of the format, increased with every change of the records. */
+static const uint32_t Version = 3;
+
+/** Alignment of all records and arrays in the blob. */
+static const uint64_t Alignment = 16;
+
+/** File extension of the cache files. */
+static const char Extension[] = "aicache";
+
+// ------------------------------------------------------------------------------------------------
+/** Returns a signature of the in-memory structures which are stored as they are. */
+inline uint32_t GetLayoutSignature() {
+    const uint32_t endianness = 1;
+    uint32_t signature = static_cast<uint32_t>(*reinterpret_cast<const unsigned char *>(&endianness));
+    const uint32_t sizes[] = {
+        static_cast<uint32_t>(sizeof(ai_real)),
+        static_cast<uint32_t>(sizeof(aiMatrix4x4)),
+        static_cast<uint32_t>(sizeof(aiVertexWeight)),
+        static_cast<uint32_t>(sizeof(aiMeshlet)),
+        static_cast<uint32_t>(sizeof(aiVectorKey)),
+        static_cast<uint32_t>(sizeof(aiQuatKey)),
+        static_cast<uint32_t>(sizeof(aiMeshKey)),
+        static_cast<uint32_t>(sizeof(aiTexel))
+    };
+    for (uint32_t size : sizes) {
+        signature = signature * 31 + size;
+    }
+    return signature;
+}
+
+/** An array stored elsewhere in the blob. An offset of zero marks a null pointer. */
+struct ArrayRef {
+    uint64_t mOffset;
+    uint64_t mCount;
+};
+
+/** The header at the start of the blob. */
+struct Header {
+    char mMagic[8];
+    uint32_t mVersion;
+    uint32_t mLayout;
+    uint64_t mKey;
+    uint64_t mSize;
+    uint64_t mScene;
+    uint32_t mPostProcessing;
+    uint32_t mFlags;
+};
+
+/** Root record of the scene, nodes are stored in pre-order. */
+struct SceneRecord {
+    ArrayRef mName;
+    ArrayRef mMeshes;
+    ArrayRef mMaterials;
+    ArrayRef mAnimations;
+    ArrayRef mTextures;
+    ArrayRef mSkeletons;
+    ArrayRef mNodes;
+    uint64_t mMetaData;
+};
+
+struct NodeRecord {
+    ArrayRef mName;
+    ArrayRef mMeshes;
+    uint64_t mMetaData;
+    int32_t mParent;
+    uint32_t mNumChildren;
+    aiMatrix4x4 mTransformation;
+};
+
+struct MetadataRecord {
+    ArrayRef mEntries;
+};
+
+/** Values of type AI_AIMETADATA refer to a nested MetadataRecord. */
+struct MetadataEntryRecord {
+    ArrayRef mKey;
+    ArrayRef mData;
+    uint32_t mType;
+    uint32_t mPadding;
+};
+
+/** Faces are stored as one index array. If all faces have the same size,
+ *  mFaceSize holds it and mFaceSizes is empty. mMeshletTriangles holds
+ *  three bytes per meshlet triangle. mLODs refers to nested MeshRecords,
+ *  which have no levels of detail of their own. */
+struct MeshRecord {
+    ArrayRef mName;
+    ArrayRef mVertices;
+    ArrayRef mNormals;
+    ArrayRef mTangents;
+    ArrayRef mBitangents;
+    ArrayRef mTextureCoords[AI_MAX_NUMBER_OF_TEXTURECOORDS];
+    ArrayRef mTextureCoordsNames[AI_MAX_NUMBER_OF_TEXTURECOORDS];
+    ArrayRef mFaceSizes;
+    ArrayRef mIndices;
+    ArrayRef mBones;
+    ArrayRef mAnimMeshes;
+    ArrayRef mMeshlets;
+    ArrayRef mMeshletVertices;
+    ArrayRef mMeshletTriangles;
+    ArrayRef mLODs;
+    aiAABB mAABB;
+    uint32_t mPrimitiveTypes;
+    uint32_t mNumVertices;
+    uint32_t mNumFaces;
+    uint32_t mFaceSize;
+    uint32_t mMaterialIndex;
+    uint32_t mMethod;
+    uint32_t mNumUVComponents[AI_MAX_NUMBER_OF_TEXTURECOORDS];
+    uint32_t mNumMeshletTriangles;
+    uint32_t mPadding;
+};
+
+/** Node references are indices into SceneRecord::mNodes, -1 for none. */
+struct BoneRecord {
+    ArrayRef mName;
+    ArrayRef mWeights;
+    int32_t mArmature;
+    int32_t mNode;
+    aiMatrix4x4 mOffsetMatrix;
+};
+
+struct AnimMeshRecord {
+    ArrayRef mName;
+    ArrayRef mVertices;
+    ArrayRef mNormals;
+    ArrayRef mTangents;
+    ArrayRef mBitangents;
+    ArrayRef mTextureCoords[AI_MAX_NUMBER_OF_TEXTURECOORDS];
+    uint32_t mNumVertices;
+    float mWeight;
+};
+
+struct MaterialRecord {
+    ArrayRef mProperties;
+};
+
+struct MaterialPropertyRecord {
+    ArrayRef mKey;
+    ArrayRef mData;
+    uint32_t mSemantic;
+    uint32_t mIndex;
+    uint32_t mType;
+    uint32_t mPadding;
+};
+
+struct TextureRecord {
+    ArrayRef mFilename;
+    ArrayRef mData;
+    uint32_t mWidth;
+    uint32_t mHeight;
+    char mFormatHint[HINTMAXTEXTURELEN];
+};
+
+struct AnimationRecord {
+    ArrayRef mName;
+    ArrayRef mChannels;
+    ArrayRef mMeshChannels;
+    ArrayRef mMorphMeshChannels;
+    double mDuration;
+    double mTicksPerSecond;
+};
+
+struct NodeAnimRecord {
+    ArrayRef mNodeName;
+    ArrayRef mPositionKeys;
+    ArrayRef mRotationKeys;
+    ArrayRef mScalingKeys;
+    uint32_t mPreState;
+    uint32_t mPostState;
+};
+
+struct MeshAnimRecord {
+    ArrayRef mName;
+    ArrayRef mKeys;
+};
+
+struct MeshMorphAnimRecord {
+    ArrayRef mName;
+    ArrayRef mKeys;
+};
+
+struct MeshMorphKeyRecord {
+    ArrayRef mValues;
+    ArrayRef mWeights;
+    double mTime;
+};
+
+struct SkeletonRecord {
+    ArrayRef mName;
+    ArrayRef mBones;
+};
+
+/** The mesh reference is an index into SceneRecord::mMeshes, -1 for none. */
+struct SkeletonBoneRecord {
+    ArrayRef mWeights;
+    int32_t mParent;
+    int32_t mArmature;
+    int32_t mNode;
+    int32_t mMesh;
+    aiMatrix4x4 mOffsetMatrix;
+    aiMatrix4x4 mLocalMatrix;
+};
+
+} // namespace SceneCache
+} // namespace Assimp
+
+#endif // AI_SCENECACHEFORMAT_H_INC
@@ -0,0 +1,790 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file  SceneCacheLoader.cpp
+ *  @brief Implementation of the loader for the binary scene cache.
+ */
+
+#ifndef ASSIMP_BUILD_NO_SCENECACHE_IMPORTER
+
+#include "SceneCacheLoader.h"
+#include "SceneCacheFormat.h"
+
+#include <assimp/DefaultIOStream.h>
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
+#include <assimp/importerdesc.h>
+#include <assimp/scene.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+static const aiImporterDesc desc = {
+    "Assimp Scene Cache Importer",
+    "",
+    "",
+    "",
+    aiImporterFlags_SupportBinaryFlavour,
+    0,
+    0,
+    0,
+    0,
+    "aicache"
+};
+
+namespace Assimp {
+
+using namespace SceneCache;
+
+namespace {
+
+// Nested metadata deeper than this is treated as corrupt.
+const unsigned int MaxMetadataDepth = 64;
+
+// ------------------------------------------------------------------------------------------------
+// Bounds-checked access to the records and arrays of a blob. Any failed check marks the blob
+// as invalid, the caller checks that once at the end.
+class BlobReader {
+public:
+    BlobReader(const char *data, uint64_t size) :
+            mData(data), mSize(size), mValid(true) {}
+
+    bool IsValid() const {
+        return mValid;
+    }
+
+    void Invalidate() {
+        mValid = false;
+    }
+
+    // Checks that an array of the given element size lies inside the blob.
+    bool Check(const ArrayRef &ref, uint64_t elementSize) {
+        if (0 == ref.mOffset) {
+            if (0 != ref.mCount) {
+                mValid = false;
+            }
+        } else if (ref.mOffset > mSize || ref.mCount > (mSize - ref.mOffset) / elementSize) {
+            mValid = false;
+        }
+        return mValid;
+    }
+
+    template <typename T>
+    T ReadRecord(uint64_t offset) {
+        T record = T();
+        if (offset > mSize || sizeof(T) > mSize - offset) {
+            mValid = false;
+        } else {
+            ::memcpy(static_cast<void *>(&record), mData + offset, sizeof(T));
+        }
+        return record;
+    }
+
+    template <typename T>
+    T ReadRecord(const ArrayRef &ref, uint64_t index) {
+        return ReadRecord<T>(ref.mOffset + index * sizeof(T));
+    }
+
+    // Copies an array with the expected number of elements, nullptr for absent arrays.
+    template <typename T>
+    T *ReadArray(const ArrayRef &ref, uint64_t count) {
+        if (0 == ref.mOffset) {
+            return nullptr;
+        }
+        if (ref.mCount != count || !Check(ref, sizeof(T))) {
+            mValid = false;
+            return nullptr;
+        }
+        T *out = new T[count];
+        ::memcpy(static_cast<void *>(out), mData + ref.mOffset, count * sizeof(T));
+        return out;
+    }
+
+    // Returns a pointer into the blob, nullptr for absent arrays.
+    const char *GetBytes(const ArrayRef &ref) {
+        if (0 == ref.mOffset || !Check(ref, 1)) {
+            return nullptr;
+        }
+        return mData + ref.mOffset;
+    }
+
+    void ReadString(const ArrayRef &ref, aiString &out) {
+        if (ref.mCount >= MAXLEN || !Check(ref, 1)) {
+            mValid = false;
+            return;
+        }
+        out.length = static_cast<ai_uint32>(ref.mCount);
+        if (ref.mCount > 0) {
+            ::memcpy(out.data, mData + ref.mOffset, ref.mCount);
+        }
+        out.data[ref.mCount] = '\0';
+    }
+
+private:
+    const char *mData;
+    uint64_t mSize;
+    bool mValid;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Rebuilds the scene from the blob, stops at the first failed check.
+class SceneReader {
+public:
+    SceneReader(BlobReader &blob, aiScene *scene) :
+            mBlob(blob), mScene(scene) {}
+
+    bool Read(uint64_t offset);
+
+private:
+    bool ReadNodes(const ArrayRef &ref);
+    aiNode *GetNode(int32_t index);
+    aiMetadata *ReadMetadata(uint64_t offset, unsigned int depth);
+    aiMesh *ReadMesh(const MeshRecord &record, bool isLOD);
+    aiMaterial *ReadMaterial(const MaterialRecord &record);
+    aiAnimation *ReadAnimation(const AnimationRecord &record);
+    aiTexture *ReadTexture(const TextureRecord &record);
+    aiSkeleton *ReadSkeleton(const SkeletonRecord &record);
+
+    template <typename T>
+    void *ReadMetadataValue(const ArrayRef &ref) {
+        if (1 != ref.mCount || !mBlob.Check(ref, sizeof(T))) {
+            mBlob.Invalidate();
+            return nullptr;
+        }
+        return new T(mBlob.ReadRecord<T>(ref.mOffset));
+    }
+
+    BlobReader &mBlob;
+    aiScene *mScene;
+    std::vector<aiNode *> mNodes;
+};
+
+// ------------------------------------------------------------------------------------------------
+bool SceneReader::ReadNodes(const ArrayRef &ref) {
+    if (0 == ref.mCount || !mBlob.Check(ref, sizeof(NodeRecord))) {
+        return false;
+    }
+
+    // nodes are stored in pre-order, so every parent comes before its children
+    mNodes.resize(ref.mCount, nullptr);
+    std::vector<unsigned int> numAttached(ref.mCount, 0);
+    for (uint64_t i = 0; i < ref.mCount; ++i) {
+        const NodeRecord record = mBlob.ReadRecord<NodeRecord>(ref, i);
+        aiNode *node = new aiNode();
+        if (0 == i) {
+            mScene->mRootNode = node;
+        } else if (record.mParent < 0 || static_cast<uint64_t>(record.mParent) >= i ||
+                numAttached[record.mParent] >= mNodes[record.mParent]->mNumChildren) {
+            delete node;
+            return false;
+        } else {
+            aiNode *parent = mNodes[record.mParent];
+            parent->mChildren[numAttached[record.mParent]++] = node;
+            node->mParent = parent;
+        }
+        mNodes[i] = node;
+
+        mBlob.ReadString(record.mName, node->mName);
+        node->mTransformation = record.mTransformation;
+        node->mMeshes = mBlob.ReadArray<unsigned int>(record.mMeshes, record.mMeshes.mCount);
+        node->mNumMeshes = nullptr != node->mMeshes ? static_cast<unsigned int>(record.mMeshes.mCount) : 0;
+        if (record.mNumChildren > ref.mCount) {
+            return false;
+        }
+        if (record.mNumChildren > 0) {
+            node->mChildren = new aiNode *[record.mNumChildren]();
+            node->mNumChildren = record.mNumChildren;
+        }
+        node->mMetaData = ReadMetadata(record.mMetaData, 0);
+        if (!mBlob.IsValid()) {
+            return false;
+        }
+    }
+
+    for (uint64_t i = 0; i < ref.mCount; ++i) {
+        if (numAttached[i] != mNodes[i]->mNumChildren) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiNode *SceneReader::GetNode(int32_t index) {
+    if (index < 0) {
+        return nullptr;
+    }
+    if (static_cast<size_t>(index) >= mNodes.size()) {
+        mBlob.Invalidate();
+        return nullptr;
+    }
+    return mNodes[index];
+}
+
+// ------------------------------------------------------------------------------------------------
+aiMetadata *SceneReader::ReadMetadata(uint64_t offset, unsigned int depth) {
+    if (0 == offset) {
+        return nullptr;
+    }
+    const MetadataRecord record = mBlob.ReadRecord<MetadataRecord>(offset);
+    if (depth > MaxMetadataDepth || !mBlob.Check(record.mEntries, sizeof(MetadataEntryRecord)) ||
+            record.mEntries.mCount > UINT_MAX) {
+        mBlob.Invalidate();
+        return nullptr;
+    }
+
+    aiMetadata *metadata = new aiMetadata();
+    if (0 == record.mEntries.mCount) {
+        return metadata;
+    }
+    metadata->mNumProperties = static_cast<unsigned int>(record.mEntries.mCount);
+    metadata->mKeys = new aiString[metadata->mNumProperties]();
+    metadata->mValues = new aiMetadataEntry[metadata->mNumProperties]();
+    for (unsigned int i = 0; i < metadata->mNumProperties && mBlob.IsValid(); ++i) {
+        const MetadataEntryRecord entry = mBlob.ReadRecord<MetadataEntryRecord>(record.mEntries, i);
+        mBlob.ReadString(entry.mKey, metadata->mKeys[i]);
+        aiMetadataEntry &value = metadata->mValues[i];
+        value.mType = static_cast<aiMetadataType>(entry.mType);
+        if (0 == entry.mData.mOffset) {
+            continue;
+        }
+        switch (entry.mType) {
+        case AI_BOOL:
+            value.mData = ReadMetadataValue<bool>(entry.mData);
+            break;
+        case AI_INT32:
+            value.mData = ReadMetadataValue<int32_t>(entry.mData);
+            break;
+        case AI_UINT64:
+            value.mData = ReadMetadataValue<uint64_t>(entry.mData);
+            break;
+        case AI_FLOAT:
+            value.mData = ReadMetadataValue<float>(entry.mData);
+            break;
+        case AI_DOUBLE:
+            value.mData = ReadMetadataValue<double>(entry.mData);
+            break;
+        case AI_AISTRING: {
+            aiString *str = new aiString();
+            mBlob.ReadString(entry.mData, *str);
+            value.mData = str;
+            break;
+        }
+        case AI_AIVECTOR3D:
+            value.mData = ReadMetadataValue<aiVector3D>(entry.mData);
+            break;
+        case AI_AIMETADATA:
+            value.mData = ReadMetadata(entry.mData.mOffset, depth + 1);
+            break;
+        case AI_INT64:
+            value.mData = ReadMetadataValue<int64_t>(entry.mData);
+            break;
+        case AI_UINT32:
+            value.mData = ReadMetadataValue<uint32_t>(entry.mData);
+            break;
+        default:
+            mBlob.Invalidate();
+            break;
+        }
+    }
+    return metadata;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiMesh *SceneReader::ReadMesh(const MeshRecord &record, bool isLOD) {
+    aiMesh *mesh = new aiMesh();
+    mBlob.ReadString(record.mName, mesh->mName);
+    mesh->mPrimitiveTypes = record.mPrimitiveTypes;
+    mesh->mNumVertices = record.mNumVertices;
+    mesh->mMaterialIndex = record.mMaterialIndex;
+    mesh->mMethod = static_cast<aiMorphingMethod>(record.mMethod);
+    mesh->mAABB = record.mAABB;
+    mesh->mVertices = mBlob.ReadArray<aiVector3D>(record.mVertices, record.mNumVertices);
+    mesh->mNormals = mBlob.ReadArray<aiVector3D>(record.mNormals, record.mNumVertices);
+    mesh->mTangents = mBlob.ReadArray<aiVector3D>(record.mTangents, record.mNumVertices);
+    mesh->mBitangents = mBlob.ReadArray<aiVector3D>(record.mBitangents, record.mNumVertices);
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        mesh->mTextureCoords[i] = mBlob.ReadArray<aiVector3D>(record.mTextureCoords[i], record.mNumVertices);
+        mesh->mNumUVComponents[i] = record.mNumUVComponents[i];
+        if (0 != record.mTextureCoordsNames[i].mOffset) {
+            aiString name;
+            mBlob.ReadString(record.mTextureCoordsNames[i], name);
+            mesh->SetTextureCoordsName(i, name);
+        }
+    }
+
+    // check the face layout against the index array before allocating the faces
+    const uint32_t *faceSizes = nullptr;
+    if (0 != record.mIndices.mOffset && mBlob.Check(record.mIndices, sizeof(uint32_t))) {
+        if (0 != record.mFaceSize) {
+            if (static_cast<uint64_t>(record.mFaceSize) * record.mNumFaces != record.mIndices.mCount) {
+                mBlob.Invalidate();
+            }
+        } else if (record.mFaceSizes.mCount != record.mNumFaces || !mBlob.Check(record.mFaceSizes, sizeof(uint32_t)) ||
+                (record.mNumFaces > 0 && 0 == record.mFaceSizes.mOffset)) {
+            mBlob.Invalidate();
+        } else {
+            faceSizes = reinterpret_cast<const uint32_t *>(mBlob.GetBytes(record.mFaceSizes));
+        }
+    }
+    const char *indices = mBlob.GetBytes(record.mIndices);
+    if (nullptr != indices && mBlob.IsValid()) {
+        mesh->mFaces = new aiFace[record.mNumFaces];
+        mesh->mNumFaces = record.mNumFaces;
+        uint64_t numIndices = 0;
+        for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+            uint32_t faceSize = record.mFaceSize;
+            if (nullptr != faceSizes) {
+                ::memcpy(&faceSize, faceSizes + i, sizeof(faceSize));
+            }
+            if (faceSize > record.mIndices.mCount - numIndices) {
+                mBlob.Invalidate();
+                break;
+            }
+            aiFace &face = mesh->mFaces[i];
+            face.mNumIndices = faceSize;
+            face.mIndices = new unsigned int[faceSize];
+            ::memcpy(face.mIndices, indices + numIndices * sizeof(uint32_t), faceSize * sizeof(uint32_t));
+            numIndices += faceSize;
+            for (unsigned int a = 0; a < faceSize; ++a) {
+                if (face.mIndices[a] >= mesh->mNumVertices) {
+                    mBlob.Invalidate();
+                }
+            }
+        }
+    }
+
+    if (mBlob.Check(record.mBones, sizeof(BoneRecord)) && record.mBones.mCount > 0) {
+        mesh->mNumBones = static_cast<unsigned int>(record.mBones.mCount);
+        mesh->mBones = new aiBone *[mesh->mNumBones]();
+        for (unsigned int i = 0; i < mesh->mNumBones; ++i) {
+            const BoneRecord boneRecord = mBlob.ReadRecord<BoneRecord>(record.mBones, i);
+            aiBone *bone = mesh->mBones[i] = new aiBone();
+            mBlob.ReadString(boneRecord.mName, bone->mName);
+            bone->mWeights = mBlob.ReadArray<aiVertexWeight>(boneRecord.mWeights, boneRecord.mWeights.mCount);
+            bone->mNumWeights = nullptr != bone->mWeights ? static_cast<unsigned int>(boneRecord.mWeights.mCount) : 0;
+#ifndef ASSIMP_BUILD_NO_ARMATUREPOPULATE_PROCESS
+            bone->mArmature = GetNode(boneRecord.mArmature);
+            bone->mNode = GetNode(boneRecord.mNode);
+#endif
+            bone->mOffsetMatrix = boneRecord.mOffsetMatrix;
+        }
+    }
+
+    if (mBlob.Check(record.mAnimMeshes, sizeof(AnimMeshRecord)) && record.mAnimMeshes.mCount > 0) {
+        mesh->mNumAnimMeshes = static_cast<unsigned int>(record.mAnimMeshes.mCount);
+        mesh->mAnimMeshes = new aiAnimMesh *[mesh->mNumAnimMeshes]();
+        for (unsigned int i = 0; i < mesh->mNumAnimMeshes; ++i) {
+            const AnimMeshRecord animRecord = mBlob.ReadRecord<AnimMeshRecord>(record.mAnimMeshes, i);
+            aiAnimMesh *animMesh = mesh->mAnimMeshes[i] = new aiAnimMesh();
+            mBlob.ReadString(animRecord.mName, animMesh->mName);
+            animMesh->mNumVertices = animRecord.mNumVertices;
+            animMesh->mWeight = animRecord.mWeight;
+            animMesh->mVertices = mBlob.ReadArray<aiVector3D>(animRecord.mVertices, animRecord.mNumVertices);
+            animMesh->mNormals = mBlob.ReadArray<aiVector3D>(animRecord.mNormals, animRecord.mNumVertices);
+            animMesh->mTangents = mBlob.ReadArray<aiVector3D>(animRecord.mTangents, animRecord.mNumVertices);
+            animMesh->mBitangents = mBlob.ReadArray<aiVector3D>(animRecord.mBitangents, animRecord.mNumVertices);
+            for (unsigned int c = 0; c < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++c) {
+                animMesh->mTextureCoords[c] = mBlob.ReadArray<aiVector3D>(animRecord.mTextureCoords[c], animRecord.mNumVertices);
+            }
+        }
+    }
+
+    mesh->mMeshlets = mBlob.ReadArray<aiMeshlet>(record.mMeshlets, record.mMeshlets.mCount);
+    mesh->mNumMeshlets = nullptr != mesh->mMeshlets ? static_cast<unsigned int>(record.mMeshlets.mCount) : 0;
+    mesh->mMeshletVertices = mBlob.ReadArray<unsigned int>(record.mMeshletVertices, record.mMeshletVertices.mCount);
+    mesh->mNumMeshletVertices = nullptr != mesh->mMeshletVertices ? static_cast<unsigned int>(record.mMeshletVertices.mCount) : 0;
+    mesh->mMeshletTriangles = mBlob.ReadArray<unsigned char>(record.mMeshletTriangles, static_cast<uint64_t>(record.mNumMeshletTriangles) * 3);
+    mesh->mNumMeshletTriangles = nullptr != mesh->mMeshletTriangles ? record.mNumMeshletTriangles : 0;
+
+    // meshlets must stay inside their vertex and triangle ranges, like the face indices above
+    for (unsigned int i = 0; i < mesh->mNumMeshlets && mBlob.IsValid(); ++i) {
+        const aiMeshlet &meshlet = mesh->mMeshlets[i];
+        if (static_cast<uint64_t>(meshlet.mVertexOffset) + meshlet.mVertexCount > mesh->mNumMeshletVertices ||
+                static_cast<uint64_t>(meshlet.mTriangleOffset) + meshlet.mTriangleCount > mesh->mNumMeshletTriangles) {
+            mBlob.Invalidate();
+            break;
+        }
+        const unsigned char *triangles = mesh->mMeshletTriangles + static_cast<size_t>(meshlet.mTriangleOffset) * 3;
+        for (size_t a = 0; a < static_cast<size_t>(meshlet.mTriangleCount) * 3; ++a) {
+            if (triangles[a] >= meshlet.mVertexCount) {
+                mBlob.Invalidate();
+                break;
+            }
+        }
+    }
+    for (unsigned int i = 0; i < mesh->mNumMeshletVertices; ++i) {
+        if (mesh->mMeshletVertices[i] >= mesh->mNumVertices) {
+            mBlob.Invalidate();
+            break;
+        }
+    }
+
+    // levels of detail have no levels of their own, which also bounds the recursion
+    if (record.mLODs.mCount > 0 && mBlob.IsValid()) {
+        if (isLOD || !mBlob.Check(record.mLODs, sizeof(MeshRecord))) {
+            mBlob.Invalidate();
+            return mesh;
+        }
+        mesh->mNumLODs = static_cast<unsigned int>(record.mLODs.mCount);
+        mesh->mLODs = new aiMesh *[mesh->mNumLODs]();
+        for (unsigned int i = 0; i < mesh->mNumLODs && mBlob.IsValid(); ++i) {
+            mesh->mLODs[i] = ReadMesh(mBlob.ReadRecord<MeshRecord>(record.mLODs, i), true);
+            if (mesh->mLODs[i]->mMaterialIndex != mesh->mMaterialIndex) {
+                mBlob.Invalidate();
+            }
+        }
+    }
+    return mesh;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiMaterial *SceneReader::ReadMaterial(const MaterialRecord &record) {
+    aiMaterial *material = new aiMaterial();
+    if (!mBlob.Check(record.mProperties, sizeof(MaterialPropertyRecord))) {
+        return material;
+    }
+    for (uint64_t i = 0; i < record.mProperties.mCount; ++i) {
+        const MaterialPropertyRecord property = mBlob.ReadRecord<MaterialPropertyRecord>(record.mProperties, i);
+        aiString key;
+        mBlob.ReadString(property.mKey, key);
+        const char *data = mBlob.GetBytes(property.mData);
+        if (nullptr == data || property.mData.mCount > UINT_MAX || !mBlob.IsValid()) {
+            mBlob.Invalidate();
+            break;
+        }
+        material->AddBinaryProperty(data, static_cast<unsigned int>(property.mData.mCount), key.C_Str(),
+                property.mSemantic, property.mIndex, static_cast<aiPropertyTypeInfo>(property.mType));
+    }
+    return material;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiAnimation *SceneReader::ReadAnimation(const AnimationRecord &record) {
+    aiAnimation *animation = new aiAnimation();
+    mBlob.ReadString(record.mName, animation->mName);
+    animation->mDuration = record.mDuration;
+    animation->mTicksPerSecond = record.mTicksPerSecond;
+
+    if (mBlob.Check(record.mChannels, sizeof(NodeAnimRecord)) && record.mChannels.mCount > 0) {
+        animation->mNumChannels = static_cast<unsigned int>(record.mChannels.mCount);
+        animation->mChannels = new aiNodeAnim *[animation->mNumChannels]();
+        for (unsigned int i = 0; i < animation->mNumChannels; ++i) {
+            const NodeAnimRecord channelRecord = mBlob.ReadRecord<NodeAnimRecord>(record.mChannels, i);
+            aiNodeAnim *channel = animation->mChannels[i] = new aiNodeAnim();
+            mBlob.ReadString(channelRecord.mNodeName, channel->mNodeName);
+            channel->mPositionKeys = mBlob.ReadArray<aiVectorKey>(channelRecord.mPositionKeys, channelRecord.mPositionKeys.mCount);
+            channel->mNumPositionKeys = nullptr != channel->mPositionKeys ? static_cast<unsigned int>(channelRecord.mPositionKeys.mCount) : 0;
+            channel->mRotationKeys = mBlob.ReadArray<aiQuatKey>(channelRecord.mRotationKeys, channelRecord.mRotationKeys.mCount);
+            channel->mNumRotationKeys = nullptr != channel->mRotationKeys ? static_cast<unsigned int>(channelRecord.mRotationKeys.mCount) : 0;
+            channel->mScalingKeys = mBlob.ReadArray<aiVectorKey>(channelRecord.mScalingKeys, channelRecord.mScalingKeys.mCount);
+            channel->mNumScalingKeys = nullptr != channel->mScalingKeys ? static_cast<unsigned int>(channelRecord.mScalingKeys.mCount) : 0;
+            channel->mPreState = static_cast<aiAnimBehaviour>(channelRecord.mPreState);
+            channel->mPostState = static_cast<aiAnimBehaviour>(channelRecord.mPostState);
+        }
+    }
+
+    if (mBlob.Check(record.mMeshChannels, sizeof(MeshAnimRecord)) && record.mMeshChannels.mCount > 0) {
+        animation->mNumMeshChannels = static_cast<unsigned int>(record.mMeshChannels.mCount);
+        animation->mMeshChannels = new aiMeshAnim *[animation->mNumMeshChannels]();
+        for (unsigned int i = 0; i < animation->mNumMeshChannels; ++i) {
+            const MeshAnimRecord channelRecord = mBlob.ReadRecord<MeshAnimRecord>(record.mMeshChannels, i);
+            aiMeshAnim *channel = animation->mMeshChannels[i] = new aiMeshAnim();
+            mBlob.ReadString(channelRecord.mName, channel->mName);
+            channel->mKeys = mBlob.ReadArray<aiMeshKey>(channelRecord.mKeys, channelRecord.mKeys.mCount);
+            channel->mNumKeys = nullptr != channel->mKeys ? static_cast<unsigned int>(channelRecord.mKeys.mCount) : 0;
+        }
+    }
+
+    if (mBlob.Check(record.mMorphMeshChannels, sizeof(MeshMorphAnimRecord)) && record.mMorphMeshChannels.mCount > 0) {
+        animation->mNumMorphMeshChannels = static_cast<unsigned int>(record.mMorphMeshChannels.mCount);
+        animation->mMorphMeshChannels = new aiMeshMorphAnim *[animation->mNumMorphMeshChannels]();
+        for (unsigned int i = 0; i < animation->mNumMorphMeshChannels; ++i) {
+            const MeshMorphAnimRecord channelRecord = mBlob.ReadRecord<MeshMorphAnimRecord>(record.mMorphMeshChannels, i);
+            aiMeshMorphAnim *channel = animation->mMorphMeshChannels[i] = new aiMeshMorphAnim();
+            mBlob.ReadString(channelRecord.mName, channel->mName);
+            if (!mBlob.Check(channelRecord.mKeys, sizeof(MeshMorphKeyRecord)) || 0 == channelRecord.mKeys.mCount) {
+                continue;
+            }
+            channel->mNumKeys = static_cast<unsigned int>(channelRecord.mKeys.mCount);
+            channel->mKeys = new aiMeshMorphKey[channel->mNumKeys];
+            for (unsigned int k = 0; k < channel->mNumKeys; ++k) {
+                const MeshMorphKeyRecord keyRecord = mBlob.ReadRecord<MeshMorphKeyRecord>(channelRecord.mKeys, k);
+                aiMeshMorphKey &key = channel->mKeys[k];
+                key.mTime = keyRecord.mTime;
+                key.mValues = mBlob.ReadArray<unsigned int>(keyRecord.mValues, keyRecord.mValues.mCount);
+                key.mWeights = mBlob.ReadArray<double>(keyRecord.mWeights, keyRecord.mValues.mCount);
+                if (nullptr != key.mValues && nullptr != key.mWeights) {
+                    key.mNumValuesAndWeights = static_cast<unsigned int>(keyRecord.mValues.mCount);
+                } else if (nullptr != key.mValues || nullptr != key.mWeights) {
+                    mBlob.Invalidate();
+                }
+            }
+        }
+    }
+    return animation;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiTexture *SceneReader::ReadTexture(const TextureRecord &record) {
+    aiTexture *texture = new aiTexture();
+    mBlob.ReadString(record.mFilename, texture->mFilename);
+    ::memcpy(texture->achFormatHint, record.mFormatHint, HINTMAXTEXTURELEN);
+    texture->achFormatHint[HINTMAXTEXTURELEN - 1] = '\0';
+
+    // compressed textures hold mWidth bytes, all others mWidth * mHeight texels
+    const uint64_t size = 0 == record.mHeight ? record.mWidth :
+            static_cast<uint64_t>(record.mWidth) * record.mHeight * sizeof(aiTexel);
+    const char *data = mBlob.GetBytes(record.mData);
+    if (nullptr == data) {
+        return texture;
+    }
+    if (record.mData.mCount != size) {
+        mBlob.Invalidate();
+        return texture;
+    }
+    texture->mWidth = record.mWidth;
+    texture->mHeight = record.mHeight;
+    texture->pcData = new aiTexel[(size + sizeof(aiTexel) - 1) / sizeof(aiTexel)];
+    ::memcpy(static_cast<void *>(texture->pcData), data, size);
+    return texture;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiSkeleton *SceneReader::ReadSkeleton(const SkeletonRecord &record) {
+    aiSkeleton *skeleton = new aiSkeleton();
+    mBlob.ReadString(record.mName, skeleton->mName);
+    if (!mBlob.Check(record.mBones, sizeof(SkeletonBoneRecord)) || 0 == record.mBones.mCount) {
+        return skeleton;
+    }
+
+    skeleton->mNumBones = static_cast<unsigned int>(record.mBones.mCount);
+    skeleton->mBones = new aiSkeletonBone *[skeleton->mNumBones]();
+    for (unsigned int i = 0; i < skeleton->mNumBones; ++i) {
+        const SkeletonBoneRecord boneRecord = mBlob.ReadRecord<SkeletonBoneRecord>(record.mBones, i);
+        aiSkeletonBone *bone = skeleton->mBones[i] = new aiSkeletonBone();
+        bone->mParent = boneRecord.mParent;
+#ifndef ASSIMP_BUILD_NO_ARMATUREPOPULATE_PROCESS
+        bone->mArmature = GetNode(boneRecord.mArmature);
+        bone->mNode = GetNode(boneRecord.mNode);
+#endif
+        if (boneRecord.mMesh >= 0) {
+            if (static_cast<unsigned int>(boneRecord.mMesh) < mScene->mNumMeshes) {
+                bone->mMeshId = mScene->mMeshes[boneRecord.mMesh];
+            } else {
+                mBlob.Invalidate();
+            }
+        }
+        bone->mWeights = mBlob.ReadArray<aiVertexWeight>(boneRecord.mWeights, boneRecord.mWeights.mCount);
+        bone->mNumnWeights = nullptr != bone->mWeights ? static_cast<unsigned int>(boneRecord.mWeights.mCount) : 0;
+        bone->mOffsetMatrix = boneRecord.mOffsetMatrix;
+        bone->mLocalMatrix = boneRecord.mLocalMatrix;
+    }
+    return skeleton;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SceneReader::Read(uint64_t offset) {
+    const SceneRecord record = mBlob.ReadRecord<SceneRecord>(offset);
+    mBlob.ReadString(record.mName, mScene->mName);
+    if (!mBlob.IsValid() || !ReadNodes(record.mNodes)) {
+        return false;
+    }
+
+    if (!mBlob.Check(record.mMeshes, sizeof(MeshRecord)) || !mBlob.Check(record.mMaterials, sizeof(MaterialRecord)) ||
+            !mBlob.Check(record.mAnimations, sizeof(AnimationRecord)) || !mBlob.Check(record.mTextures, sizeof(TextureRecord)) ||
+            !mBlob.Check(record.mSkeletons, sizeof(SkeletonRecord))) {
+        return false;
+    }
+
+    if (record.mMeshes.mCount > 0) {
+        mScene->mNumMeshes = static_cast<unsigned int>(record.mMeshes.mCount);
+        mScene->mMeshes = new aiMesh *[mScene->mNumMeshes]();
+        for (unsigned int i = 0; i < mScene->mNumMeshes && mBlob.IsValid(); ++i) {
+            mScene->mMeshes[i] = ReadMesh(mBlob.ReadRecord<MeshRecord>(record.mMeshes, i), false);
+            if (mScene->mMeshes[i]->mMaterialIndex >= record.mMaterials.mCount) {
+                mBlob.Invalidate();
+            }
+        }
+    }
+    if (record.mMaterials.mCount > 0) {
+        mScene->mNumMaterials = static_cast<unsigned int>(record.mMaterials.mCount);
+        mScene->mMaterials = new aiMaterial *[mScene->mNumMaterials]();
+        for (unsigned int i = 0; i < mScene->mNumMaterials && mBlob.IsValid(); ++i) {
+            mScene->mMaterials[i] = ReadMaterial(mBlob.ReadRecord<MaterialRecord>(record.mMaterials, i));
+        }
+    }
+    if (record.mAnimations.mCount > 0) {
+        mScene->mNumAnimations = static_cast<unsigned int>(record.mAnimations.mCount);
+        mScene->mAnimations = new aiAnimation *[mScene->mNumAnimations]();
+        for (unsigned int i = 0; i < mScene->mNumAnimations && mBlob.IsValid(); ++i) {
+            mScene->mAnimations[i] = ReadAnimation(mBlob.ReadRecord<AnimationRecord>(record.mAnimations, i));
+        }
+    }
+    if (record.mTextures.mCount > 0) {
+        mScene->mNumTextures = static_cast<unsigned int>(record.mTextures.mCount);
+        mScene->mTextures = new aiTexture *[mScene->mNumTextures]();
+        for (unsigned int i = 0; i < mScene->mNumTextures && mBlob.IsValid(); ++i) {
+            mScene->mTextures[i] = ReadTexture(mBlob.ReadRecord<TextureRecord>(record.mTextures, i));
+        }
+    }
+    if (record.mSkeletons.mCount > 0) {
+        mScene->mNumSkeletons = static_cast<unsigned int>(record.mSkeletons.mCount);
+        mScene->mSkeletons = new aiSkeleton *[mScene->mNumSkeletons]();
+        for (unsigned int i = 0; i < mScene->mNumSkeletons && mBlob.IsValid(); ++i) {
+            mScene->mSkeletons[i] = ReadSkeleton(mBlob.ReadRecord<SkeletonRecord>(record.mSkeletons, i));
+        }
+    }
+    mScene->mMetaData = ReadMetadata(record.mMetaData, 0);
+
+    // node mesh references can only be checked now
+    for (const aiNode *node : mNodes) {
+        for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
+            if (node->mMeshes[i] >= mScene->mNumMeshes) {
+                return false;
+            }
+        }
+    }
+    return mBlob.IsValid();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Hands all data of the source scene over to the destination scene.
+void MoveScene(aiScene *dest, aiScene *src) {
+    dest->mFlags = src->mFlags;
+    dest->mName = src->mName;
+    std::swap(dest->mRootNode, src->mRootNode);
+    std::swap(dest->mNumMeshes, src->mNumMeshes);
+    std::swap(dest->mMeshes, src->mMeshes);
+    std::swap(dest->mNumMaterials, src->mNumMaterials);
+    std::swap(dest->mMaterials, src->mMaterials);
+    std::swap(dest->mNumAnimations, src->mNumAnimations);
+    std::swap(dest->mAnimations, src->mAnimations);
+    std::swap(dest->mNumTextures, src->mNumTextures);
+    std::swap(dest->mTextures, src->mTextures);
+    std::swap(dest->mNumSkeletons, src->mNumSkeletons);
+    std::swap(dest->mSkeletons, src->mSkeletons);
+    std::swap(dest->mMetaData, src->mMetaData);
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+SceneCacheImporter::SceneCacheImporter() :
+        mExpectedKey(0) {}
+
+// ------------------------------------------------------------------------------------------------
+bool SceneCacheImporter::CanRead(const std::string &pFile, IOSystem *pIOHandler, bool /*checkSig*/) const {
+    return CheckMagicToken(pIOHandler, pFile, Magic, 1, 0, sizeof(Magic));
+}
+
+// ------------------------------------------------------------------------------------------------
+const aiImporterDesc *SceneCacheImporter::GetInfo() const {
+    return &desc;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiScene *SceneCacheImporter::ReadCachedScene(Importer *pImp, const std::string &pFile, IOSystem *pIOHandler, uint64_t pKey) {
+    mExpectedKey = pKey;
+    aiScene *scene = ReadFile(pImp, pFile, pIOHandler);
+    mExpectedKey = 0;
+
+    // a rejected file leaves the scene empty
+    if (nullptr != scene && nullptr == scene->mRootNode) {
+        delete scene;
+        scene = nullptr;
+    }
+    return scene;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SceneCacheImporter::InternReadFile(const std::string &pFile, aiScene *pScene, IOSystem *pIOHandler) {
+    auto streamCloser = [&](IOStream *pStream) {
+        pIOHandler->Close(pStream);
+    };
+    std::unique_ptr<IOStream, decltype(streamCloser)> fileStream(pIOHandler->Open(pFile, "rb"), streamCloser);
+    if (!fileStream) {
+        return;
+    }
+    const size_t size = fileStream->FileSize();
+    if (size < sizeof(Header)) {
+        return;
+    }
+
+    // Map the file if it is a plain file, otherwise read it as a whole
+    const char *data = nullptr;
+    std::vector<char> buffer;
+    DefaultIOStream *defaultStream = dynamic_cast<DefaultIOStream *>(fileStream.get());
+    if (nullptr != defaultStream) {
+        data = defaultStream->Map();
+    }
+    if (nullptr == data) {
+        buffer.resize(size);
+        if (fileStream->Read(buffer.data(), 1, size) != size) {
+            return;
+        }
+        data = buffer.data();
+    }
+
+    Header header;
+    ::memcpy(&header, data, sizeof(header));
+    if (0 != ::memcmp(header.mMagic, Magic, sizeof(Magic)) || header.mVersion != Version ||
+            header.mLayout != GetLayoutSignature() || header.mSize != size ||
+            (0 != mExpectedKey && header.mKey != mExpectedKey)) {
+        return;
+    }
+
+    BlobReader blob(data, size);
+    std::unique_ptr<aiScene> scene(new aiScene());
+    SceneReader reader(blob, scene.get());
+    if (!reader.Read(header.mScene)) {
+        return;
+    }
+    scene->mFlags = header.mFlags;
+    MoveScene(pScene, scene.get());
+}
+
+} // namespace Assimp
+
+#endif // !! ASSIMP_BUILD_NO_SCENECACHE_IMPORTER
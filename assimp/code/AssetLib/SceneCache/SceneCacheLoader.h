@@ -0,0 +1,99 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  SceneCacheLoader.h
+ *  @brief Declares the loader for the binary scene cache.
+ */
+#pragma once
+#ifndef AI_SCENECACHELOADER_H_INC
+#define AI_SCENECACHELOADER_H_INC
+
+#include <assimp/BaseImporter.h>
+#include <cstdint>
+
+struct aiScene;
+
+namespace Assimp {
+
+// ------------------------------------------------------------------------------------------------
+/** Loads scenes from scene cache files written by ExportSceneCache().
+ *
+ *  The loaded scene is already post-processed. The file is memory-mapped if
+ *  the IO system allows it, and each array is restored with a single copy.
+ *  Files which are truncated, corrupt or written by a different build are
+ *  rejected and leave the scene empty.
+ */
+class SceneCacheImporter : public BaseImporter {
+public:
+    SceneCacheImporter();
+    ~SceneCacheImporter() override = default;
+
+    // -------------------------------------------------------------------
+    /** Returns whether the file starts with the scene cache magic. */
+    bool CanRead(const std::string &pFile, IOSystem *pIOHandler, bool checkSig) const override;
+
+    // -------------------------------------------------------------------
+    /** Loads the cache file, but only if it was written for the given key.
+     *  @param pImp #Importer object hosting this loader.
+     *  @param pFile Path of the cache file.
+     *  @param pIOHandler IO handler to open the file with.
+     *  @param pKey Key of the source file and the import settings.
+     *  @return The cached scene, nullptr if the file does not match or is
+     *    invalid.
+     */
+    aiScene *ReadCachedScene(Importer *pImp, const std::string &pFile, IOSystem *pIOHandler, uint64_t pKey);
+
+protected:
+    // -------------------------------------------------------------------
+    const aiImporterDesc *GetInfo() const override;
+
+    // -------------------------------------------------------------------
+    void InternReadFile(const std::string &pFile, aiScene *pScene, IOSystem *pIOHandler) override;
+
+private:
+    /** Key the file has to match, zero to accept any key. */
+    uint64_t mExpectedKey;
+};
+
+} // namespace Assimp
+
+#endif // AI_SCENECACHELOADER_H_INC
@@ -43,7 +43,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "BaseProcess.h"
 #include "Importer.h"
+#include "ParallelFor.h"
 #include <assimp/BaseImporter.h>
+#include <assimp/SceneCombiner.h>
 #include <assimp/scene.h>
 
 using namespace Assimp;
@@ -71,6 +73,9 @@ void BaseProcess::ExecuteOnScene(Importer *pImp) {
 
     SetupProperties(pImp);
 
+    // the step may write to arrays shared with other scenes
+    SceneCombiner::UnshareScene(pImp->Pimpl()->mScene);
+
     // catch exceptions thrown inside the PostProcess-Step
     try {
         Execute(pImp->Pimpl()->mScene);
@@ -82,12 +87,71 @@ void BaseProcess::ExecuteOnScene(Importer *pImp) {
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+void BaseProcess::ExecuteOnSceneMeshes(Importer *pImp, const std::vector<BaseProcess *> &steps, unsigned int numThreads) {
+    if (pImp == nullptr) {
+        return;
+    }
+
+    aiScene *scene = pImp->Pimpl()->mScene;
+    if (scene == nullptr) {
+        return;
+    }
+
+    for (BaseProcess *step : steps) {
+        step->SetupProperties(pImp);
+    }
+
+    // the steps may write to arrays shared with other scenes
+    SceneCombiner::UnshareScene(scene);
+
+    // catch exceptions thrown inside the PostProcess-Steps
+    try {
+        ParallelFor(scene->mNumMeshes, numThreads, [scene, &steps](size_t i) {
+            for (BaseProcess *step : steps) {
+                if (scene->mMeshes[i] == nullptr) {
+                    break;
+                }
+                step->ExecutePerMesh(scene, static_cast<unsigned int>(i));
+            }
+        });
+        for (BaseProcess *step : steps) {
+            step->FinishPerMesh(scene);
+        }
+    } catch (const std::exception&) {
+
+        // and kill the partially imported data
+        delete pImp->Pimpl()->mScene;
+        pImp->Pimpl()->mScene = nullptr;
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 void BaseProcess::SetupProperties(const Importer * /*pImp*/) {
     // the default implementation does nothing
 }
 
+// ------------------------------------------------------------------------------------------------
+bool BaseProcess::IsRequested(const Importer * /*pImp*/) const {
+    return false;
+}
+
 // ------------------------------------------------------------------------------------------------
 bool BaseProcess::RequireVerboseFormat() const {
     return true;
 }
+
+// ------------------------------------------------------------------------------------------------
+bool BaseProcess::IsPerMeshStep() const {
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void BaseProcess::ExecutePerMesh(aiScene * /*pScene*/, unsigned int /*meshIndex*/) {
+    // the default implementation does nothing
+}
+
+// ------------------------------------------------------------------------------------------------
+void BaseProcess::FinishPerMesh(aiScene * /*pScene*/) {
+    // the default implementation does nothing
+}
@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/GenericProperty.h>
 
 #include <map>
+#include <vector>
 
 struct aiScene;
 
@@ -195,6 +196,16 @@ public:
      */
     virtual bool IsActive(unsigned int pFlags) const = 0;
 
+    // -------------------------------------------------------------------
+    /**
+     * @brief Returns whether the step was requested by an importer property.
+     * All #aiPostProcessSteps bits are taken, so newer steps are enabled by a
+     * property of their own instead. They run in addition to the steps given
+     * by the flags. The default implementation returns false.
+     * @param pImp Importer instance holding the properties.
+     */
+    virtual bool IsRequested(const Importer *pImp) const;
+
     // -------------------------------------------------------------------
     /** Check whether this step expects its input vertex data to be
      *  in verbose format. */
@@ -226,6 +237,44 @@ public:
      */
     virtual void Execute(aiScene *pScene) = 0;
 
+    // -------------------------------------------------------------------
+    /** Check whether the step processes each mesh on its own. If so, the
+     *  importer may call ExecutePerMesh() for every mesh, concurrently for
+     *  different meshes, followed by FinishPerMesh() instead of Execute().
+     */
+    virtual bool IsPerMeshStep() const;
+
+    // -------------------------------------------------------------------
+    /**
+     * @brief Executes the post processing step on a single mesh.
+     * The function must only modify the given mesh. It may delete the mesh
+     * and set its slot in pScene->mMeshes to nullptr, later steps skip it
+     * then. A process should throw an ImportErrorException* if it fails.
+     * @param pScene The imported data to work at.
+     * @param meshIndex The index of the mesh to process.
+     */
+    virtual void ExecutePerMesh(aiScene *pScene, unsigned int meshIndex);
+
+    // -------------------------------------------------------------------
+    /**
+     * @brief Called once after ExecutePerMesh() has run on all meshes, on
+     * the calling thread. Used by steps which need to update the scene.
+     * @param pScene The imported data to work at.
+     */
+    virtual void FinishPerMesh(aiScene *pScene);
+
+    // -------------------------------------------------------------------
+    /**
+     * @brief Executes a sequence of per-mesh steps on the given imported data.
+     * Each mesh runs through all steps in order, different meshes are
+     * processed on up to numThreads threads. As ExecuteOnScene(), the function
+     * deletes the scene if one of the steps fails.
+     * @param pImp Importer instance (pImp->mScene must be valid)
+     * @param steps The steps to execute, IsPerMeshStep() must be true for all.
+     * @param numThreads The maximum number of threads to use.
+     */
+    static void ExecuteOnSceneMeshes(Importer *pImp, const std::vector<BaseProcess *> &steps, unsigned int numThreads);
+
     // -------------------------------------------------------------------
     /** Assign a new SharedPostProcessInfo to the step. This object
      *  allows multiple post-process steps to share data.
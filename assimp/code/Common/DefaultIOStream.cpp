@@ -45,6 +45,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/DefaultIOStream.h>
 #include <sys/stat.h>
 
+#ifdef _WIN32
+#    include <io.h>
+#    include <windows.h>
+#elif defined __unix__ || defined __APPLE__
+#    include <sys/mman.h>
+#endif
+
 using namespace Assimp;
 
 namespace {
@@ -78,6 +85,7 @@ inline int select_fseek<8>(FILE *file, int64_t offset, int origin) {
 
 // ----------------------------------------------------------------------------------
 DefaultIOStream::~DefaultIOStream() {
+    Unmap();
     if (mFile) {
         ::fclose(mFile);
     }
@@ -179,3 +187,58 @@ void DefaultIOStream::Flush() {
 }
 
 // ----------------------------------------------------------------------------------
+const char *DefaultIOStream::Map() {
+    if (nullptr != mMappedData) {
+        return static_cast<const char *>(mMappedData);
+    }
+
+    const size_t size = FileSize();
+    if (!mFile || 0 == size) {
+        return nullptr;
+    }
+
+#if defined _WIN32
+    HANDLE file = reinterpret_cast<HANDLE>(::_get_osfhandle(::_fileno(mFile)));
+    if (INVALID_HANDLE_VALUE == file) {
+        return nullptr;
+    }
+    HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (nullptr == mapping) {
+        return nullptr;
+    }
+    // the view keeps the mapping object alive
+    mMappedData = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+    ::CloseHandle(mapping);
+#elif defined __unix__ || defined __APPLE__
+    void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, ::fileno(mFile), 0);
+    if (MAP_FAILED == data) {
+        return nullptr;
+    }
+    // text importers walk the file front to back
+    ::madvise(data, size, MADV_SEQUENTIAL);
+    mMappedData = data;
+#endif
+
+    if (nullptr != mMappedData) {
+        mMappedSize = size;
+    }
+
+    return static_cast<const char *>(mMappedData);
+}
+
+// ----------------------------------------------------------------------------------
+void DefaultIOStream::Unmap() {
+    if (nullptr == mMappedData) {
+        return;
+    }
+
+#if defined _WIN32
+    ::UnmapViewOfFile(mMappedData);
+#elif defined __unix__ || defined __APPLE__
+    ::munmap(mMappedData, mMappedSize);
+#endif
+    mMappedData = nullptr;
+    mMappedSize = 0;
+}
+
+// ----------------------------------------------------------------------------------
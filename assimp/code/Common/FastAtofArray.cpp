@@ -0,0 +1,291 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+#include "FastAtofArray.h"
+#include <assimp/ParsingUtils.h>
+#include <assimp/fast_atof.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AI_FAST_ATOF_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace Assimp {
+
+#ifdef AI_FAST_ATOF_SSE2
+
+// Size of the windows the digit runs are located in
+static constexpr ptrdiff_t WindowSize = 16;
+
+// Size of the blocks the separators between numbers are located in
+static constexpr ptrdiff_t BlockSize = 64;
+
+static const uint64_t Pow10Table[9] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+// ------------------------------------------------------------------------------------------------
+static inline unsigned int countTrailingZeros(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index = 0;
+#ifdef _M_X64
+    _BitScanForward64(&index, value);
+#else
+    if (!_BitScanForward(&index, static_cast<unsigned long>(value))) {
+        _BitScanForward(&index, static_cast<unsigned long>(value >> 32));
+        index += 32;
+    }
+#endif
+    return static_cast<unsigned int>(index);
+#else
+    return static_cast<unsigned int>(__builtin_ctzll(value));
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Returns a mask of the characters which are not decimal digits in the 16 bytes at c.
+static inline unsigned int nonDigitMask(const char *c) {
+    const __m128i window = _mm_loadu_si128(reinterpret_cast<const __m128i *>(c));
+    const __m128i below = _mm_cmplt_epi8(window, _mm_set1_epi8('0'));
+    const __m128i above = _mm_cmpgt_epi8(window, _mm_set1_epi8('9'));
+    return static_cast<unsigned int>(_mm_movemask_epi8(_mm_or_si128(below, above)));
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Returns a mask of the spaces, tabs and line ends in the 64 bytes at c.
+static inline uint64_t separatorMask(const char *c) {
+    uint64_t mask = 0;
+    for (int i = 0; i < BlockSize / WindowSize; ++i) {
+        const __m128i window = _mm_loadu_si128(reinterpret_cast<const __m128i *>(c + i * WindowSize));
+        const __m128i separators = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(window, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(window, _mm_set1_epi8('\t'))),
+                _mm_or_si128(_mm_cmpeq_epi8(window, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(window, _mm_set1_epi8('\n'))));
+        mask |= static_cast<uint64_t>(static_cast<unsigned int>(_mm_movemask_epi8(separators))) << (i * WindowSize);
+    }
+    return mask;
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Returns the value of the n (1-8) digits at c, converting all of them at once inside a
+//  64 bit register. SSE2 implies a little endian target.
+static inline uint64_t eightDigitsValue(const char *c, unsigned int n) {
+    uint64_t value;
+    ::memcpy(&value, c, sizeof(value));
+    const unsigned int shift = 8 * (8 - n);
+    value = (value << shift) - (0x3030303030303030ull << shift);
+    value = (value * 10) + (value >> 8);
+    value = (((value & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+                    (((value >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+    return value;
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Returns the value of the n (1-16) digits at c.
+static inline uint64_t digitsValue(const char *c, unsigned int n) {
+    if (n <= 8) {
+        return eightDigitsValue(c, n);
+    }
+    return eightDigitsValue(c, 8) * Pow10Table[n - 8] + eightDigitsValue(c + 8, n - 8);
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Parses a plain [+-]digits[.digits] token of known length (1-16) from a single window,
+//  rounding exactly like fast_atoreal_move. Returns false for anything else.
+template <typename Real>
+static inline bool parseTokenSSE2(const char *c, unsigned int length, Real &out) {
+    const unsigned int nonDigits = nonDigitMask(c) | (~0u << length);
+    const bool inv = (*c == '-');
+    const unsigned int intBegin = (inv || *c == '+') ? 1 : 0;
+    const unsigned int intEnd = countTrailingZeros(nonDigits >> intBegin) + intBegin;
+
+    Real f = 0;
+    if (intEnd > intBegin) {
+        f = static_cast<Real>(digitsValue(c + intBegin, intEnd - intBegin));
+    }
+    if (intEnd < length) {
+        if ((c[intEnd] != '.' && c[intEnd] != ',') || intEnd + 1 == length) {
+            return false;
+        }
+        const unsigned int fracEnd = countTrailingZeros(nonDigits >> (intEnd + 1)) + intEnd + 1;
+        const unsigned int diff = fracEnd - intEnd - 1;
+        if (fracEnd != length || diff > AI_FAST_ATOF_RELAVANT_DECIMALS) {
+            return false;
+        }
+        double pl = static_cast<double>(digitsValue(c + intEnd + 1, diff));
+        pl *= fast_atof_table[diff];
+        f += static_cast<Real>(pl);
+    } else if (intEnd == intBegin) {
+        return false;
+    }
+
+    out = inv ? -f : f;
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Mirrors fast_atoreal_move step by step, so both round identically. Returns nullptr
+//  if the number has to be parsed by fast_atoreal_move.
+template <typename Real>
+static inline const char *parseRealSSE2(const char *c, const char *end, Real &out) {
+    const bool inv = (*c == '-');
+    if (inv || *c == '+') {
+        ++c;
+    }
+    if (end - c <= WindowSize || *c == 'n' || *c == 'N' || *c == 'i' || *c == 'I') {
+        return nullptr;
+    }
+
+    // integer part
+    const unsigned int intDigits = countTrailingZeros(nonDigitMask(c) | 0x10000u);
+    if (intDigits == WindowSize) {
+        return nullptr;
+    }
+    Real f = 0;
+    if (intDigits > 0) {
+        f = static_cast<Real>(digitsValue(c, intDigits));
+        c += intDigits;
+    }
+
+    // fractional part, only the first AI_FAST_ATOF_RELAVANT_DECIMALS digits are relevant
+    if ((*c == '.' || *c == ',') && c[1] >= '0' && c[1] <= '9') {
+        ++c;
+        if (end - c <= WindowSize) {
+            return nullptr;
+        }
+        const unsigned int fracDigits = countTrailingZeros(nonDigitMask(c) | 0x10000u);
+        const unsigned int diff = fracDigits < AI_FAST_ATOF_RELAVANT_DECIMALS ? fracDigits : AI_FAST_ATOF_RELAVANT_DECIMALS;
+        double pl = static_cast<double>(digitsValue(c, diff));
+        pl *= fast_atof_table[diff];
+        f += static_cast<Real>(pl);
+        c += fracDigits;
+        while (c != end && *c >= '0' && *c <= '9') {
+            ++c;
+        }
+    } else if (*c == '.') {
+        ++c;
+    }
+
+    // exponent, rare enough to be read digit by digit
+    if (*c == 'e' || *c == 'E') {
+        ++c;
+        const bool einv = (*c == '-');
+        if (einv || *c == '+') {
+            ++c;
+        }
+        Real exp = static_cast<Real>(strtoul10_64(c, &c));
+        if (einv) {
+            exp = -exp;
+        }
+        f *= std::pow(static_cast<Real>(10.0), exp);
+    }
+
+    if (inv) {
+        f = -f;
+    }
+    out = f;
+    return c;
+}
+
+#endif // AI_FAST_ATOF_SSE2
+
+// ------------------------------------------------------------------------------------------------
+template <typename Real>
+const char *fast_atoreal_move_bounded(const char *c, const char *end, Real &out) {
+#ifdef AI_FAST_ATOF_SSE2
+    const char *next = parseRealSSE2<Real>(c, end, out);
+    if (nullptr != next) {
+        return next;
+    }
+#else
+    (void)end;
+#endif
+    return fast_atoreal_move<Real>(c, out);
+}
+
+// ------------------------------------------------------------------------------------------------
+template <typename Real>
+const char *fast_atoreal_array(const char *c, const char *end, Real *out, size_t count) {
+    size_t i = 0;
+#ifdef AI_FAST_ATOF_SSE2
+    // The separators of a whole block are located up front, so the numbers inside it
+    // do not have to wait for the end of their predecessor. A number which does not
+    // end right at the next separator is left to the sequential path.
+    while (i < count && end - c > BlockSize + 2 * WindowSize) {
+        const uint64_t separators = separatorMask(c);
+        unsigned int pos = 0;
+        while (i < count) {
+            const uint64_t behind = pos < BlockSize ? separators >> pos : 0;
+            if (0 == behind || 0 != (behind & 1)) {
+                break;
+            }
+            const unsigned int tokenEnd = pos + countTrailingZeros(behind);
+            if (tokenEnd - pos > WindowSize || !parseTokenSSE2<Real>(c + pos, tokenEnd - pos, out[i])) {
+                if (parseRealSSE2<Real>(c + pos, end, out[i]) != c + tokenEnd) {
+                    break;
+                }
+            }
+            ++i;
+            const uint64_t next = tokenEnd < BlockSize ? ~separators >> tokenEnd : 0;
+            pos = 0 != next ? tokenEnd + countTrailingZeros(next) : static_cast<unsigned int>(BlockSize);
+        }
+        c += pos;
+        if (pos < BlockSize && i < count) {
+            c = fast_atoreal_move_bounded<Real>(c, end, out[i++]);
+        }
+        SkipSpacesAndLineEnd(&c);
+    }
+#endif
+    for (; i < count; ++i) {
+        c = fast_atoreal_move_bounded<Real>(c, end, out[i]);
+        SkipSpacesAndLineEnd(&c);
+    }
+    return c;
+}
+
+template const char *fast_atoreal_move_bounded<float>(const char *, const char *, float &);
+template const char *fast_atoreal_move_bounded<double>(const char *, const char *, double &);
+template const char *fast_atoreal_array<float>(const char *, const char *, float *, size_t);
+template const char *fast_atoreal_array<double>(const char *, const char *, double *, size_t);
+
+} // Namespace Assimp
@@ -0,0 +1,83 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  FastAtofArray.h
+ *  @brief Bounded and bulk variants of fast_atoreal_move for the text importers.
+ */
+#pragma once
+#ifndef AI_FAST_ATOF_ARRAY_H_INC
+#define AI_FAST_ATOF_ARRAY_H_INC
+
+#include <assimp/defs.h>
+#include <cstddef>
+
+namespace Assimp {
+
+// ------------------------------------------------------------------------------------
+/// @brief  Parses one number, giving exactly the same result and end position as
+///         fast_atoreal_move with comma checking enabled.
+///
+/// The digit runs are located and converted with SSE2 where available, as long as
+/// they fit into 16 byte windows which end before @p end. Anything else, like nan,
+/// inf or very long digit runs, is handed to fast_atoreal_move.
+/// @param  c       The start of the number.
+/// @param  end     The end of the readable buffer.
+/// @param  out     Receives the parsed value.
+/// @return Position behind the parsed number.
+template <typename Real>
+const char *fast_atoreal_move_bounded(const char *c, const char *end, Real &out);
+
+// ------------------------------------------------------------------------------------
+/// @brief  Parses count numbers which are separated by spaces, tabs and line ends.
+///
+/// Gives the same results as calling fast_atoreal_move for each number and skipping
+/// the white space behind it with SkipSpacesAndLineEnd.
+/// @param  c       The start of the first number.
+/// @param  end     The end of the readable buffer.
+/// @param  out     Receives the parsed values.
+/// @param  count   The number of values to read.
+/// @return Position behind the white space following the last number.
+template <typename Real>
+const char *fast_atoreal_array(const char *c, const char *end, Real *out, size_t count);
+
+} // Namespace Assimp
+
+#endif // AI_FAST_ATOF_ARRAY_H_INC
@@ -65,12 +65,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PostProcessing/ProcessHelper.h"
 #include "Common/ScenePreprocessor.h"
 #include "Common/ScenePrivate.h"
+#include "Common/ParallelFor.h"
 
 #include <assimp/BaseImporter.h>
 #include <assimp/GenericProperty.h>
 #include <assimp/MemoryIOWrapper.h>
 #include <assimp/commonMetaData.h>
 
+#include <algorithm>
 #include <exception>
 #include <set>
 #include <memory>
@@ -78,6 +80,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/DefaultIOStream.h>
 #include <assimp/DefaultIOSystem.h>
 
+#ifndef ASSIMP_BUILD_NO_SCENECACHE_IMPORTER
+#   include "AssetLib/SceneCache/SceneCacheExporter.h"
+#   include "AssetLib/SceneCache/SceneCacheFormat.h"
+#   include "AssetLib/SceneCache/SceneCacheLoader.h"
+#   include <cstdio>
+#   include <cstring>
+#endif
+
 namespace Assimp {
     // ImporterRegistry.cpp
     void GetImporterInstanceList(std::vector< BaseImporter* >& out);
@@ -90,6 +100,121 @@ namespace Assimp {
 using namespace Assimp;
 using namespace Assimp::Intern;
 
+// ------------------------------------------------------------------------------------------------
+// Builds the property index of all materials once the scene is complete.
+static void BuildMaterialPropertyIndices(aiScene *pScene) {
+    for (unsigned int i = 0; i < pScene->mNumMaterials; ++i) {
+        pScene->mMaterials[i]->BuildPropertyIndex();
+    }
+}
+
+#ifndef ASSIMP_BUILD_NO_SCENECACHE_IMPORTER
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// 64-bit MurmurHash2 (variant 64A), processes the data a whole word at a time.
+uint64_t HashBytes(const void *pData, size_t pSize, uint64_t pSeed) {
+    const uint64_t m = 0xc6a4a7935bd1e995ULL;
+    const int r = 47;
+    const unsigned char *data = static_cast<const unsigned char *>(pData);
+    uint64_t h = pSeed ^ (pSize * m);
+
+    const size_t numWords = pSize / sizeof(uint64_t);
+    for (size_t i = 0; i < numWords; ++i) {
+        uint64_t k;
+        ::memcpy(&k, data + i * sizeof(uint64_t), sizeof(k));
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    const unsigned char *tail = data + numWords * sizeof(uint64_t);
+    const size_t tailSize = pSize & (sizeof(uint64_t) - 1);
+    if (tailSize > 0) {
+        uint64_t k = 0;
+        ::memcpy(&k, tail, tailSize);
+        h ^= k;
+        h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+// ------------------------------------------------------------------------------------------------
+template <typename T>
+uint64_t HashValue(const T &pValue, uint64_t pSeed) {
+    return HashBytes(&pValue, sizeof(T), pSeed);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Computes the cache key of a file: its contents, the post-processing flags and all properties
+// which may influence the import. Returns 0 if the file can't be read.
+uint64_t ComputeSceneCacheKey(const ImporterPimpl *pimpl, const std::string &pFile, unsigned int pFlags) {
+    auto streamCloser = [&](IOStream *pStream) {
+        pimpl->mIOHandler->Close(pStream);
+    };
+    std::unique_ptr<IOStream, decltype(streamCloser)> fileStream(pimpl->mIOHandler->Open(pFile, "rb"), streamCloser);
+    if (!fileStream) {
+        return 0;
+    }
+
+    const size_t fileSize = fileStream->FileSize();
+    const char *data = nullptr;
+    std::vector<char> buffer;
+    DefaultIOStream *defaultStream = dynamic_cast<DefaultIOStream *>(fileStream.get());
+    if (nullptr != defaultStream) {
+        data = defaultStream->Map();
+    }
+    if (nullptr == data && fileSize > 0) {
+        buffer.resize(fileSize);
+        if (fileStream->Read(buffer.data(), 1, fileSize) != fileSize) {
+            return 0;
+        }
+        data = buffer.data();
+    }
+
+    uint64_t key = HashBytes(data, fileSize, SceneCache::Version);
+    key = HashValue(pFlags, key);
+
+    // properties written by ReadFile() itself describe the last import, not the settings
+    const unsigned int importerIndex = SuperFastHash("importerIndex");
+    const unsigned int sourceFilePath = SuperFastHash("sourceFilePath");
+    const unsigned int appScale = SuperFastHash(AI_CONFIG_APP_SCALE_KEY);
+    for (const auto &property : pimpl->mIntProperties) {
+        if (property.first != importerIndex) {
+            key = HashValue(property.first, key);
+            key = HashValue(property.second, key);
+        }
+    }
+    for (const auto &property : pimpl->mFloatProperties) {
+        if (property.first != appScale) {
+            key = HashValue(property.first, key);
+            key = HashValue(property.second, key);
+        }
+    }
+    for (const auto &property : pimpl->mStringProperties) {
+        if (property.first != sourceFilePath) {
+            key = HashValue(property.first, key);
+            key = HashBytes(property.second.data(), property.second.size(), key);
+        }
+    }
+    for (const auto &property : pimpl->mMatrixProperties) {
+        key = HashValue(property.first, key);
+        key = HashValue(property.second, key);
+    }
+
+    // zero marks a missing key
+    return 0 != key ? key : 1;
+}
+
+} // namespace
+#endif // !! ASSIMP_BUILD_NO_SCENECACHE_IMPORTER
+
 // ------------------------------------------------------------------------------------------------
 // Intern::AllocateFromAssimpHeap serves as abstract base class. It overrides
 // new and delete (and their array counterparts) of public API classes (e.g. Logger) to
@@ -480,6 +605,39 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags) {
             }
         }
 
+#ifndef ASSIMP_BUILD_NO_SCENECACHE_IMPORTER
+        // Look the file up in the scene cache, unless it is a cache file itself
+        std::string cacheFile;
+        uint64_t cacheKey = 0;
+        SceneCacheImporter *cacheImporter = nullptr;
+        const std::string cacheDir = GetPropertyString(AI_CONFIG_IMPORT_SCENE_CACHE_DIR, "");
+        if (!cacheDir.empty() && nullptr == dynamic_cast<SceneCacheImporter *>(imp)) {
+            for (BaseImporter *importer : pimpl->mImporter) {
+                cacheImporter = dynamic_cast<SceneCacheImporter *>(importer);
+                if (nullptr != cacheImporter) {
+                    break;
+                }
+            }
+            cacheKey = ComputeSceneCacheKey(pimpl, pFile, pFlags);
+        }
+        if (nullptr != cacheImporter && 0 != cacheKey) {
+            char name[32];
+            ::snprintf(name, sizeof(name), "%016llx.", static_cast<unsigned long long>(cacheKey));
+            cacheFile = cacheDir + pimpl->mIOHandler->getOsSeparator() + name + SceneCache::Extension;
+            if (pimpl->mIOHandler->Exists(cacheFile)) {
+                pimpl->mScene = cacheImporter->ReadCachedScene(this, cacheFile, pimpl->mIOHandler, cacheKey);
+            }
+            if (pimpl->mScene) {
+                SetPropertyString("sourceFilePath", pFile);
+                ScenePriv(pimpl->mScene)->mPPStepsApplied |= pFlags;
+                if (GetPropertyBool(AI_CONFIG_IMPORT_MATERIAL_PROPERTY_INDEX, true)) {
+                    BuildMaterialPropertyIndices(pimpl->mScene);
+                }
+                return pimpl->mScene;
+            }
+        }
+#endif // !! ASSIMP_BUILD_NO_SCENECACHE_IMPORTER
+
         // Get file size for progress handler
         IOStream * fileIO = pimpl->mIOHandler->Open( pFile );
         uint32_t fileSize = 0;
@@ -514,6 +672,17 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags) {
 
             // Ensure that the validation process won't be called twice
             ApplyPostProcessing(pFlags);
+
+#ifndef ASSIMP_BUILD_NO_SCENECACHE_IMPORTER
+            // Store the result for the next import of the same file
+            if (pimpl->mScene && !cacheFile.empty()) {
+                ExportSceneCache(cacheFile.c_str(), pimpl->mIOHandler, pimpl->mScene, cacheKey, pFlags);
+            }
+#endif // !! ASSIMP_BUILD_NO_SCENECACHE_IMPORTER
+
+            if (pimpl->mScene && GetPropertyBool(AI_CONFIG_IMPORT_MATERIAL_PROPERTY_INDEX, true)) {
+                BuildMaterialPropertyIndices(pimpl->mScene);
+            }
         }
         // if failed, extract the error string
         else if( !pimpl->mScene) {
@@ -542,16 +711,41 @@ const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags) {
         return nullptr;
     }
 
-    // If no flags are given, return the current scene with no further action
-    if (!pFlags) {
+    // steps without a flag of their own are requested by properties
+    auto isActive = [this, pFlags](const BaseProcess *process) {
+        return process->IsActive(pFlags) || process->IsRequested(this);
+    };
+
+    // If no steps are requested, return the current scene with no further action
+    if (!pFlags && std::none_of(pimpl->mPostProcessingSteps.begin(), pimpl->mPostProcessingSteps.end(), isActive)) {
         return pimpl->mScene;
     }
 
+    const unsigned int numThreads = GetNumWorkerThreads(GetPropertyInteger(AI_CONFIG_PP_NUM_THREADS, 1));
+    std::vector<BaseProcess*> perMeshSteps;
+
     for( unsigned int a = 0; a < pimpl->mPostProcessingSteps.size(); a++)   {
         BaseProcess* process = pimpl->mPostProcessingSteps[a];
 
-        if( process->IsActive( pFlags)) {
-            process->ExecuteOnScene ( this );
+        if( isActive( process)) {
+            if (numThreads > 1 && process->IsPerMeshStep()) {
+                // gather the active per-mesh steps up to the next scene-wide step, they run as one batch
+                perMeshSteps.clear();
+                for ( ; a < pimpl->mPostProcessingSteps.size(); a++) {
+                    process = pimpl->mPostProcessingSteps[a];
+                    if (!isActive(process)) {
+                        continue;
+                    }
+                    if (!process->IsPerMeshStep()) {
+                        break;
+                    }
+                    perMeshSteps.push_back(process);
+                }
+                --a;
+                BaseProcess::ExecuteOnSceneMeshes(this, perMeshSteps, numThreads);
+            } else {
+                process->ExecuteOnScene ( this );
+            }
         }
         if( !pimpl->mScene) {
             break;
@@ -848,6 +1042,7 @@ void Importer::GetMemoryRequirements(aiMemoryInfo& in) const {
         const aiMaterial* pc = mScene->mMaterials[i];
         in.materials += sizeof(aiMaterial);
         in.materials += pc->mNumAllocated * sizeof(void*);
+        in.materials += pc->mNumPropertyIndexSlots * 2 * sizeof(unsigned int);
 
         for (unsigned int a = 0; a < pc->mNumProperties;++a) {
             in.materials += pc->mProperties[a]->mDataLength;
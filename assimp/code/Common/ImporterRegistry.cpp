@@ -64,6 +64,9 @@ corresponding preprocessor flag to selectively disable formats.
 #ifndef ASSIMP_BUILD_NO_FBX_IMPORTER
 #include "AssetLib/FBX/FBXImporter.h"
 #endif
+#ifndef ASSIMP_BUILD_NO_SCENECACHE_IMPORTER
+#include "AssetLib/SceneCache/SceneCacheLoader.h"
+#endif
 
 namespace Assimp {
 
@@ -83,7 +86,7 @@ void GetImporterInstanceList(std::vector<BaseImporter *> &out) {
     // Add an instance of each worker class here
     // (register_new_importers_here)
     // ----------------------------------------------------------------------------
-    out.reserve(3);
+    out.reserve(4);
 
 #if (!defined ASSIMP_BUILD_NO_OBJ_IMPORTER)
     out.push_back(new ObjFileImporter());
@@ -94,6 +97,9 @@ void GetImporterInstanceList(std::vector<BaseImporter *> &out) {
 #if (!defined ASSIMP_BUILD_NO_FBX_IMPORTER)
     out.push_back(new FBXImporter());
 #endif
+#if (!defined ASSIMP_BUILD_NO_SCENECACHE_IMPORTER)
+    out.push_back(new SceneCacheImporter());
+#endif
 }
 
 /** will delete all registered importers. */
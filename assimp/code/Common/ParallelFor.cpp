@@ -0,0 +1,124 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  ParallelFor.cpp
+ *  @brief Implementation of the worker thread pool used by ParallelFor().
+ */
+
+#include "ParallelFor.h"
+
+#include <system_error>
+
+using namespace Assimp;
+
+// ------------------------------------------------------------------------------------------------
+ThreadPool &ThreadPool::Get() {
+    static ThreadPool pool;
+    return pool;
+}
+
+// ------------------------------------------------------------------------------------------------
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWake.notify_all();
+    for (std::thread &thread : mThreads) {
+        thread.join();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void ThreadPool::Run(const std::function<void()> &work, unsigned int numHelpers) {
+    Job job = { &work, numHelpers, 0 };
+    if (numHelpers) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        Grow(numHelpers);
+        mJobs.push_back(&job);
+    }
+    mWake.notify_all();
+
+    work();
+
+    // the work is done, helpers which did not pick the job up yet are not needed anymore
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (job.pending) {
+        mJobs.erase(std::find(mJobs.begin(), mJobs.end(), &job));
+    }
+    mDone.wait(lock, [&job] { return job.active == 0; });
+}
+
+// ------------------------------------------------------------------------------------------------
+void ThreadPool::Grow(size_t numThreads) {
+    try {
+        while (mThreads.size() < numThreads) {
+            mThreads.emplace_back(&ThreadPool::WorkerMain, this);
+        }
+    } catch (const std::system_error &) {
+        // out of threads, the threads already running take over the work
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void ThreadPool::WorkerMain() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (;;) {
+        mWake.wait(lock, [this] { return mStop || !mJobs.empty(); });
+        if (mStop) {
+            return;
+        }
+
+        Job *job = mJobs.front();
+        ++job->active;
+        if (--job->pending == 0) {
+            mJobs.pop_front();
+        }
+
+        lock.unlock();
+        (*job->work)();
+        lock.lock();
+
+        if (--job->active == 0) {
+            mDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,162 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  ParallelFor.h
+ *  @brief Minimal fork-join helper shared by the importers and post-processing steps.
+ */
+#pragma once
+#ifndef AI_PARALLELFOR_H_INC
+#define AI_PARALLELFOR_H_INC
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Assimp {
+
+// ------------------------------------------------------------------------------------------------
+/// @brief  Resolves a requested thread count to the number of threads to spawn.
+/// @param  requested   The requested count, zero or negative selects the hardware concurrency.
+/// @return The number of threads to use, always at least one.
+inline unsigned int GetNumWorkerThreads(int requested) {
+    if (requested > 0) {
+        return static_cast<unsigned int>(requested);
+    }
+    const unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1u;
+}
+
+// ------------------------------------------------------------------------------------------------
+/// @brief  Process-wide pool of worker threads shared by all ParallelFor() calls.
+///
+/// Threads are started on first use, added when a call asks for more helpers than the
+/// pool has and kept waiting for work until the library is unloaded.
+class ThreadPool {
+public:
+    /// @brief  Returns the pool, starting it on first use.
+    static ThreadPool &Get();
+
+    /// @brief  Runs work() on the calling thread and on up to numHelpers pool threads.
+    ///
+    /// work() must not throw and must return once nothing is left to do; the call returns
+    /// after every thread running it has returned. Nested calls are allowed. If threads
+    /// cannot be started, the work is shared by the threads already running.
+    /// @param  work        The callable, run once per participating thread.
+    /// @param  numHelpers  The maximum number of pool threads to use.
+    void Run(const std::function<void()> &work, unsigned int numHelpers);
+
+    ~ThreadPool();
+
+private:
+    struct Job {
+        const std::function<void()> *work;
+        unsigned int pending; ///< helpers still wanted
+        unsigned int active; ///< helpers running work
+    };
+
+    ThreadPool() = default;
+    void Grow(size_t numThreads);
+    void WorkerMain();
+
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+    std::deque<Job *> mJobs;
+    std::vector<std::thread> mThreads;
+    bool mStop = false;
+};
+
+// ------------------------------------------------------------------------------------------------
+/// @brief  Calls task(i) for every i in [0, count) on up to numThreads threads.
+///
+/// Indices are handed out one by one from a shared counter, so tasks of uneven
+/// cost balance themselves. The calling thread takes part in the work, the other
+/// threads are taken from the ThreadPool. When a single thread is requested or
+/// there is at most one task, everything runs inline on the calling thread. The
+/// first exception thrown by a task is rethrown on the calling thread once all
+/// threads have finished.
+/// @param  count       The number of tasks.
+/// @param  numThreads  The maximum number of threads to use.
+/// @param  task        The callable, invoked with the task index.
+template <class Task>
+inline void ParallelFor(size_t count, unsigned int numThreads, Task &&task) {
+    if (numThreads <= 1 || count <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++) {
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next = count;
+            }
+        }
+    };
+
+    const size_t numHelpers = std::min(count, static_cast<size_t>(numThreads)) - 1;
+    ThreadPool::Get().Run(worker, static_cast<unsigned int>(numHelpers));
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // Namespace Assimp
+
+#endif // AI_PARALLELFOR_H_INC
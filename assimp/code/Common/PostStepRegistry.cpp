@@ -59,6 +59,9 @@ corresponding preprocessor flag to selectively disable steps.
 #ifndef ASSIMP_BUILD_NO_TRIANGULATE_PROCESS
 #   include "PostProcessing/TriangulateProcess.h"
 #endif
+#ifndef ASSIMP_BUILD_NO_JOINVERTICES_PROCESS
+#   include "PostProcessing/JoinVerticesProcess.h"
+#endif
 #ifndef ASSIMP_BUILD_NO_DROPFACENORMALS_PROCESS
 #   include "PostProcessing/DropFaceNormalsProcess.h"
 #endif
@@ -77,6 +80,12 @@ corresponding preprocessor flag to selectively disable steps.
 #ifndef ASSIMP_BUILD_NO_LIMITBONEWEIGHTS_PROCESS
 #   include "PostProcessing/LimitBoneWeightsProcess.h"
 #endif
+#ifndef ASSIMP_BUILD_NO_GENLODS_PROCESS
+#   include "PostProcessing/GenLODsProcess.h"
+#endif
+#ifndef ASSIMP_BUILD_NO_IMPROVECACHELOCALITY_PROCESS
+#   include "PostProcessing/ImproveCacheLocalityProcess.h"
+#endif
 #ifndef ASSIMP_BUILD_NO_FIXINFACINGNORMALS_PROCESS
 #   include "PostProcessing/FixNormalsStep.h"
 #endif
@@ -210,6 +219,9 @@ void GetPostProcessingStepInstanceList(std::vector< BaseProcess* >& out)
 #if (!defined ASSIMP_BUILD_NO_CALCTANGENTS_PROCESS)
     out.push_back( new CalcTangentsProcess());
 #endif
+#if (!defined ASSIMP_BUILD_NO_JOINVERTICES_PROCESS)
+    out.push_back( new JoinVerticesProcess());
+#endif
 
     // .........................................................................
     out.push_back( new DestroySpatialSortProcess());
@@ -221,6 +233,12 @@ void GetPostProcessingStepInstanceList(std::vector< BaseProcess* >& out)
 #if (!defined ASSIMP_BUILD_NO_LIMITBONEWEIGHTS_PROCESS)
     out.push_back( new LimitBoneWeightsProcess());
 #endif
+#if (!defined ASSIMP_BUILD_NO_GENLODS_PROCESS)
+    out.push_back( new GenLODsProcess());
+#endif
+#if (!defined ASSIMP_BUILD_NO_IMPROVECACHELOCALITY_PROCESS)
+    out.push_back( new ImproveCacheLocalityProcess());
+#endif
 #if (!defined ASSIMP_BUILD_NO_GENBOUNDINGBOXES_PROCESS)
     out.push_back(new GenBoundingBoxesProcess);
 #endif
@@ -52,6 +52,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
   *       OptimizeGraph step.
   */
 // ----------------------------------------------------------------------------
+#include "ParallelFor.h"
 #include "ScenePrivate.h"
 #include <assimp/Hash.h>
 #include <assimp/SceneCombiner.h>
@@ -62,6 +63,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/scene.h>
 #include <stdio.h>
 
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+
 namespace Assimp {
 
 #if (__GNUC__ >= 8 && __GNUC_MINOR__ >= 0)
@@ -90,7 +95,7 @@ inline void PrefixString(aiString &string, const char *prefix, unsigned int len)
 
 // ------------------------------------------------------------------------------------------------
 // Add node identifiers to a hashing set
-void SceneCombiner::AddNodeHashes(aiNode *node, std::set<unsigned int> &hashes) {
+void SceneCombiner::AddNodeHashes(aiNode *node, std::unordered_set<unsigned int> &hashes) {
     // Add node name to hashing set if it is non-empty - empty nodes are allowed
     // and they can't have any anims assigned so its absolutely safe to duplicate them.
     if (node->mName.length) {
@@ -116,36 +121,30 @@ void SceneCombiner::AddNodePrefixes(aiNode *node, const char *prefix, unsigned i
 
 // ------------------------------------------------------------------------------------------------
 // Search for matching names
-bool SceneCombiner::FindNameMatch(const aiString &name, std::vector<SceneHelper> &input, unsigned int cur) {
+bool SceneCombiner::FindNameMatch(const aiString &name,
+        const std::unordered_map<unsigned int, unsigned int> &hashCounts, const SceneHelper &cur) {
     const unsigned int hash = SuperFastHash(name.data, static_cast<uint32_t>(name.length));
 
-    // Check whether we find a positive match in one of the given sets
-    for (unsigned int i = 0; i < input.size(); ++i) {
-        if (cur != i && input[i].hashes.find(hash) != input[i].hashes.end()) {
-            return true;
-        }
+    // Check whether one of the other scenes contains the name, too
+    const auto it = hashCounts.find(hash);
+    if (it == hashCounts.end()) {
+        return false;
     }
-    return false;
+    return it->second > (cur.hashes.count(hash) ? 1u : 0u);
 }
 
 // ------------------------------------------------------------------------------------------------
 // Add a name prefix to all nodes in a hierarchy if a hash match is found
 void SceneCombiner::AddNodePrefixesChecked(aiNode *node, const char *prefix, unsigned int len,
-        std::vector<SceneHelper> &input, unsigned int cur) {
+        const std::unordered_map<unsigned int, unsigned int> &hashCounts, const SceneHelper &cur) {
 
-    const unsigned int hash = SuperFastHash(node->mName.data, static_cast<uint32_t>(node->mName.length));
-
-    // Check whether we find a positive match in one of the given sets
-    for (unsigned int i = 0; i < input.size(); ++i) {
-        if (cur != i && input[i].hashes.find(hash) != input[i].hashes.end()) {
-            PrefixString(node->mName, prefix, len);
-            break;
-        }
+    if (FindNameMatch(node->mName, hashCounts, cur)) {
+        PrefixString(node->mName, prefix, len);
     }
 
     // Process all children recursively
     for (unsigned int i = 0; i < node->mNumChildren; ++i) {
-        AddNodePrefixesChecked(node->mChildren[i], prefix, len, input, cur);
+        AddNodePrefixesChecked(node->mChildren[i], prefix, len, hashCounts, cur);
     }
 }
 
@@ -197,42 +196,53 @@ void SceneCombiner::MergeScenes(aiScene **_dest, std::vector<aiScene *> &src, un
 }
 
 // ------------------------------------------------------------------------------------------------
-void SceneCombiner::AttachToGraph(aiNode *attach, std::vector<NodeAttachmentInfo> &srcList) {
-    unsigned int cnt;
-    for (cnt = 0; cnt < attach->mNumChildren; ++cnt) {
-        AttachToGraph(attach->mChildren[cnt], srcList);
+// Attach the pending attachments of a node and all of its children, see AttachToGraph()
+static void AttachPendingNodes(aiNode *attach,
+        std::unordered_map<aiNode *, std::vector<NodeAttachmentInfo *>> &pending) {
+    for (unsigned int cnt = 0; cnt < attach->mNumChildren; ++cnt) {
+        AttachPendingNodes(attach->mChildren[cnt], pending);
     }
 
-    cnt = 0;
-    for (std::vector<NodeAttachmentInfo>::iterator it = srcList.begin();
-            it != srcList.end(); ++it) {
-        if ((*it).attachToNode == attach && !(*it).resolved)
-            ++cnt;
+    auto it = pending.find(attach);
+    if (it == pending.end()) {
+        return;
     }
+    const std::vector<NodeAttachmentInfo *> &list = it->second;
 
-    if (cnt) {
-        aiNode **n = new aiNode *[cnt + attach->mNumChildren];
-        if (attach->mNumChildren) {
-            ::memcpy(n, attach->mChildren, sizeof(void *) * attach->mNumChildren);
-            delete[] attach->mChildren;
-        }
-        attach->mChildren = n;
+    aiNode **n = new aiNode *[list.size() + attach->mNumChildren];
+    if (attach->mNumChildren) {
+        ::memcpy(n, attach->mChildren, sizeof(void *) * attach->mNumChildren);
+        delete[] attach->mChildren;
+    }
+    attach->mChildren = n;
 
-        n += attach->mNumChildren;
-        attach->mNumChildren += cnt;
+    n += attach->mNumChildren;
+    attach->mNumChildren += static_cast<unsigned int>(list.size());
 
-        for (unsigned int i = 0; i < srcList.size(); ++i) {
-            NodeAttachmentInfo &att = srcList[i];
-            if (att.attachToNode == attach && !att.resolved) {
-                *n = att.node;
-                (**n).mParent = attach;
-                ++n;
+    for (NodeAttachmentInfo *att : list) {
+        *n = att->node;
+        (**n).mParent = attach;
+        ++n;
 
-                // mark this attachment as resolved
-                att.resolved = true;
-            }
+        // mark this attachment as resolved
+        att->resolved = true;
+    }
+    pending.erase(it);
+}
+
+// ------------------------------------------------------------------------------------------------
+void SceneCombiner::AttachToGraph(aiNode *attach, std::vector<NodeAttachmentInfo> &srcList) {
+    // group the unresolved attachments by their attachment point, keeping their order
+    std::unordered_map<aiNode *, std::vector<NodeAttachmentInfo *>> pending;
+    for (NodeAttachmentInfo &att : srcList) {
+        if (!att.resolved) {
+            pending[att.attachToNode].push_back(&att);
         }
     }
+
+    if (!pending.empty()) {
+        AttachPendingNodes(attach, pending);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -240,6 +250,47 @@ void SceneCombiner::AttachToGraph(aiScene *master, std::vector<NodeAttachmentInf
     AttachToGraph(master->mRootNode, src);
 }
 
+// ------------------------------------------------------------------------------------------------
+// Update the embedded texture indices of a material and prefix its name, see MergeScenes()
+static void OffsetMaterialTextures(aiMaterial *mat, unsigned int offset, const SceneHelper &cur, unsigned int flags) {
+    // We need to update all texture indices of the mesh. So we need to search for
+    // a material property called '$tex.file'
+    for (unsigned int a = 0; a < mat->mNumProperties; ++a) {
+        aiMaterialProperty *prop = mat->mProperties[a];
+        if (!strncmp(prop->mKey.data, "$tex.file", 9)) {
+            // Check whether this texture is an embedded texture.
+            // In this case the property looks like this: *<n>,
+            // where n is the index of the texture.
+            // Copy here because we overwrite the string data in-place and the buffer inside of aiString
+            // will be a lie if we just reinterpret from prop->mData. The size of mData is not guaranteed to be
+            // MAXLEN in size.
+            aiString s(*(aiString *)prop->mData);
+            if ('*' == s.data[0]) {
+                // Offset the index and write it back ..
+                const unsigned int idx = strtoul10(&s.data[1]) + offset;
+                const unsigned int oldLen = s.length;
+
+                s.length = 1 + ASSIMP_itoa10(&s.data[1], sizeof(s.data) - 1, idx);
+
+                // The string changed in size so we need to reallocate the buffer for the property.
+                if (oldLen < s.length) {
+                    prop->mDataLength += s.length - oldLen;
+                    delete[] prop->mData;
+                    prop->mData = new char[prop->mDataLength];
+                }
+
+                memcpy(prop->mData, static_cast<void*>(&s), prop->mDataLength);
+            }
+        }
+
+        // Need to generate new, unique material names?
+        else if (!::strcmp(prop->mKey.data, "$mat.name") && flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_MATNAMES) {
+            aiString *pcSrc = (aiString *)prop->mData;
+            PrefixString(*pcSrc, cur.id, cur.idlen);
+        }
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 void SceneCombiner::MergeScenes(aiScene **_dest, aiScene *master, std::vector<AttachmentInfo> &srcList, unsigned int flags) {
     if (nullptr == _dest) {
@@ -261,53 +312,44 @@ void SceneCombiner::MergeScenes(aiScene **_dest, aiScene *master, std::vector<At
         *_dest = new aiScene();
 
     aiScene *dest = *_dest;
+    const unsigned int numThreads = (flags & AI_INT_MERGE_SCENE_PARALLEL) ? GetNumWorkerThreads(0) : 1;
 
+    // the meshes and textures of the input scenes are moved to the output scene,
+    // which must not share them with scenes outside of the merge
+    UnshareScene(master);
     std::vector<SceneHelper> src(srcList.size() + 1);
     src[0].scene = master;
     for (unsigned int i = 0; i < srcList.size(); ++i) {
+        UnshareScene(srcList[i].scene);
         src[i + 1] = SceneHelper(srcList[i].scene);
     }
 
     // this helper array specifies which scenes are duplicates of others
-    std::vector<unsigned int> duplicates(src.size(), UINT_MAX);
-
-    // this helper array is used as lookup table several times
-    std::vector<unsigned int> offset(src.size());
+    std::vector<unsigned int> duplicates(src.size());
 
     // Find duplicate scenes
-    for (unsigned int i = 0; i < src.size(); ++i) {
-        if (duplicates[i] != i && duplicates[i] != UINT_MAX) {
-            continue;
-        }
-
-        duplicates[i] = i;
-        for (unsigned int a = i + 1; a < src.size(); ++a) {
-            if (src[i].scene == src[a].scene) {
-                duplicates[a] = i;
-            }
+    {
+        std::unordered_map<const aiScene *, unsigned int> firstOccurrence;
+        firstOccurrence.reserve(src.size());
+        for (unsigned int i = 0; i < src.size(); ++i) {
+            duplicates[i] = firstOccurrence.emplace(src[i].scene, i).first->second;
         }
     }
 
+    // number of scenes containing each name hash
+    std::unordered_map<unsigned int, unsigned int> hashCounts;
+
     // Generate unique names for all named stuff?
     if (flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES) {
-        for (unsigned int i = 1; i < src.size(); ++i) {
-            //if (i != duplicates[i])
-            //{
-            //  // duplicate scenes share the same UID
-            //  ::strcpy( src[i].id, src[duplicates[i]].id );
-            //  src[i].idlen = src[duplicates[i]].idlen;
-
-            //  continue;
-            //}
-
+        ParallelFor(src.size() - 1, numThreads, [&src, flags](size_t k) {
+            const unsigned int i = static_cast<unsigned int>(k + 1);
             src[i].idlen = ai_snprintf(src[i].id, 32, "$%.6X$_", i);
 
             if (flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES_IF_NECESSARY) {
 
                 // Compute hashes for all identifiers in this scene and store them
-                // in a sorted table (for convenience I'm using std::set). We hash
-                // just the node and animation channel names, all identifiers except
-                // the material names should be caught by doing this.
+                // in a hash set. We hash just the node and animation channel names,
+                // all identifiers except the material names should be caught by doing this.
                 AddNodeHashes(src[i]->mRootNode, src[i].hashes);
 
                 for (unsigned int a = 0; a < src[i]->mNumAnimations; ++a) {
@@ -315,23 +357,32 @@ void SceneCombiner::MergeScenes(aiScene **_dest, aiScene *master, std::vector<At
                     src[i].hashes.insert(SuperFastHash(anim->mName.data, static_cast<uint32_t>(anim->mName.length)));
                 }
             }
+        });
+
+        if (flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES_IF_NECESSARY) {
+            for (unsigned int i = 1; i < src.size(); ++i) {
+                for (unsigned int hash : src[i].hashes) {
+                    ++hashCounts[hash];
+                }
+            }
         }
     }
 
-    unsigned int cnt;
-
-    // First find out how large the respective output arrays must be
+    // First find out how large the respective output arrays must be and where the
+    // items of each scene go. Animations are stored in reverse scene order.
+    std::vector<unsigned int> texOffset(src.size()), matOffset(src.size()), meshOffset(src.size()), animOffset(src.size());
     for (unsigned int n = 0; n < src.size(); ++n) {
         SceneHelper *cur = &src[n];
 
+        texOffset[n] = dest->mNumTextures;
+        matOffset[n] = dest->mNumMaterials;
+        meshOffset[n] = dest->mNumMeshes;
         if (n == duplicates[n] || flags & AI_INT_MERGE_SCENE_DUPLICATES_DEEP_CPY) {
             dest->mNumTextures += (*cur)->mNumTextures;
             dest->mNumMaterials += (*cur)->mNumMaterials;
             dest->mNumMeshes += (*cur)->mNumMeshes;
         }
 
-        dest->mNumAnimations += (*cur)->mNumAnimations;
-
         // Combine the flags of all scenes
         // We need to process them flag-by-flag here to get correct results
         // dest->mFlags ; //|= (*cur)->mFlags;
@@ -339,123 +390,91 @@ void SceneCombiner::MergeScenes(aiScene **_dest, aiScene *master, std::vector<At
             dest->mFlags |= AI_SCENE_FLAGS_NON_VERBOSE_FORMAT;
         }
     }
+    for (size_t n = src.size(); n-- > 0;) {
+        animOffset[n] = dest->mNumAnimations;
+        dest->mNumAnimations += src[n]->mNumAnimations;
+    }
 
-    // generate the output texture list + an offset table for all texture indices
-    if (dest->mNumTextures) {
-        aiTexture **pip = dest->mTextures = new aiTexture *[dest->mNumTextures];
-        cnt = 0;
-        for (unsigned int n = 0; n < src.size(); ++n) {
-            SceneHelper *cur = &src[n];
-            for (unsigned int i = 0; i < (*cur)->mNumTextures; ++i) {
-                if (n != duplicates[n]) {
-                    if (flags & AI_INT_MERGE_SCENE_DUPLICATES_DEEP_CPY)
-                        Copy(pip, (*cur)->mTextures[i]);
+    // Scenes which are processed at all. The copies of duplicate scenes are made in a second
+    // pass, once their original has been fully updated.
+    auto isOriginal = [&duplicates](size_t n) {
+        return n == duplicates[n];
+    };
+    auto isDeepCopy = [&duplicates, flags](size_t n) {
+        return n != duplicates[n] && (flags & AI_INT_MERGE_SCENE_DUPLICATES_DEEP_CPY);
+    };
 
-                    else
-                        continue;
-                } else
-                    *pip = (*cur)->mTextures[i];
-                ++pip;
+    // generate the output texture list
+    if (dest->mNumTextures) {
+        dest->mTextures = new aiTexture *[dest->mNumTextures];
+        ParallelFor(src.size(), numThreads, [&](size_t n) {
+            aiTexture **pip = dest->mTextures + texOffset[n];
+            for (unsigned int i = 0; i < src[n]->mNumTextures; ++i) {
+                if (isOriginal(n)) {
+                    pip[i] = src[n]->mTextures[i];
+                } else if (isDeepCopy(n)) {
+                    Copy(&pip[i], src[n]->mTextures[i]);
+                }
             }
-
-            offset[n] = cnt;
-            cnt = (unsigned int)(pip - dest->mTextures);
-        }
+        });
     }
 
-    // generate the output material list + an offset table for all material indices
+    // generate the output material list and update all texture indices
     if (dest->mNumMaterials) {
-        aiMaterial **pip = dest->mMaterials = new aiMaterial *[dest->mNumMaterials];
-        cnt = 0;
-        for (unsigned int n = 0; n < src.size(); ++n) {
+        dest->mMaterials = new aiMaterial *[dest->mNumMaterials];
+        auto mergeMaterials = [&](size_t n) {
             SceneHelper *cur = &src[n];
+            aiMaterial **pip = dest->mMaterials + matOffset[n];
             for (unsigned int i = 0; i < (*cur)->mNumMaterials; ++i) {
-                if (n != duplicates[n]) {
-                    if (flags & AI_INT_MERGE_SCENE_DUPLICATES_DEEP_CPY)
-                        Copy(pip, (*cur)->mMaterials[i]);
-
-                    else
-                        continue;
-                } else
-                    *pip = (*cur)->mMaterials[i];
+                if (isOriginal(n)) {
+                    pip[i] = (*cur)->mMaterials[i];
+                } else {
+                    Copy(&pip[i], (*cur)->mMaterials[i]);
+                }
 
                 if ((*cur)->mNumTextures != dest->mNumTextures) {
-                    // We need to update all texture indices of the mesh. So we need to search for
-                    // a material property called '$tex.file'
-
-                    for (unsigned int a = 0; a < (*pip)->mNumProperties; ++a) {
-                        aiMaterialProperty *prop = (*pip)->mProperties[a];
-                        if (!strncmp(prop->mKey.data, "$tex.file", 9)) {
-                            // Check whether this texture is an embedded texture.
-                            // In this case the property looks like this: *<n>,
-                            // where n is the index of the texture.
-                            // Copy here because we overwrite the string data in-place and the buffer inside of aiString
-                            // will be a lie if we just reinterpret from prop->mData. The size of mData is not guaranteed to be
-                            // MAXLEN in size.
-                            aiString s(*(aiString *)prop->mData);
-                            if ('*' == s.data[0]) {
-                                // Offset the index and write it back ..
-                                const unsigned int idx = strtoul10(&s.data[1]) + offset[n];
-                                const unsigned int oldLen = s.length;
-
-                                s.length = 1 + ASSIMP_itoa10(&s.data[1], sizeof(s.data) - 1, idx);
-
-                                // The string changed in size so we need to reallocate the buffer for the property.
-                                if (oldLen < s.length) {
-                                    prop->mDataLength += s.length - oldLen;
-                                    delete[] prop->mData;
-                                    prop->mData = new char[prop->mDataLength];
-                                }
-
-                                memcpy(prop->mData, static_cast<void*>(&s), prop->mDataLength);
-                            }
-                        }
-
-                        // Need to generate new, unique material names?
-                        else if (!::strcmp(prop->mKey.data, "$mat.name") && flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_MATNAMES) {
-                            aiString *pcSrc = (aiString *)prop->mData;
-                            PrefixString(*pcSrc, (*cur).id, (*cur).idlen);
-                        }
-                    }
+                    OffsetMaterialTextures(pip[i], texOffset[n], *cur, flags);
                 }
-                ++pip;
             }
-
-            offset[n] = cnt;
-            cnt = (unsigned int)(pip - dest->mMaterials);
-        }
+        };
+        ParallelFor(src.size(), numThreads, [&](size_t n) {
+            if (isOriginal(n)) {
+                mergeMaterials(n);
+            }
+        });
+        ParallelFor(src.size(), numThreads, [&](size_t n) {
+            if (isDeepCopy(n)) {
+                mergeMaterials(n);
+            }
+        });
     }
 
-    // generate the output mesh list + again an offset table for all mesh indices
+    // generate the output mesh list and update the material index of all meshes
     if (dest->mNumMeshes) {
-        aiMesh **pip = dest->mMeshes = new aiMesh *[dest->mNumMeshes];
-        cnt = 0;
-        for (unsigned int n = 0; n < src.size(); ++n) {
-            SceneHelper *cur = &src[n];
-            for (unsigned int i = 0; i < (*cur)->mNumMeshes; ++i) {
-                if (n != duplicates[n]) {
-                    if (flags & AI_INT_MERGE_SCENE_DUPLICATES_DEEP_CPY)
-                        Copy(pip, (*cur)->mMeshes[i]);
-
-                    else
-                        continue;
-                } else
-                    *pip = (*cur)->mMeshes[i];
-
-                // update the material index of the mesh
-                (*pip)->mMaterialIndex += offset[n];
-                ++pip;
+        dest->mMeshes = new aiMesh *[dest->mNumMeshes];
+        auto mergeMeshes = [&](size_t n) {
+            aiMesh **pip = dest->mMeshes + meshOffset[n];
+            for (unsigned int i = 0; i < src[n]->mNumMeshes; ++i) {
+                if (isOriginal(n)) {
+                    pip[i] = src[n]->mMeshes[i];
+                } else {
+                    Copy(&pip[i], src[n]->mMeshes[i]);
+                }
+                pip[i]->mMaterialIndex += matOffset[n];
             }
-
-            // reuse the offset array - store now the mesh offset in it
-            offset[n] = cnt;
-            cnt = (unsigned int)(pip - dest->mMeshes);
-        }
+        };
+        ParallelFor(src.size(), numThreads, [&](size_t n) {
+            if (isOriginal(n)) {
+                mergeMeshes(n);
+            }
+        });
+        ParallelFor(src.size(), numThreads, [&](size_t n) {
+            if (isDeepCopy(n)) {
+                mergeMeshes(n);
+            }
+        });
     }
 
-    std::vector<NodeAttachmentInfo> nodes;
-    nodes.reserve(srcList.size());
-
     // ----------------------------------------------------------------------------
     // Now generate the output node graph. We need to make those
     // names in the graph that are referenced by anims or lights
@@ -466,87 +485,99 @@ void SceneCombiner::MergeScenes(aiScene **_dest, aiScene *master, std::vector<At
     // ----------------------------------------------------------------------------
 
     // Allocate space for animations
+    dest->mAnimations = (dest->mNumAnimations ? new aiAnimation *[dest->mNumAnimations] : nullptr);
 
-    aiAnimation **ppAnims = dest->mAnimations = (dest->mNumAnimations ? new aiAnimation *[dest->mNumAnimations] : nullptr);
-
-    for (int n = static_cast<int>(src.size() - 1); n >= 0; --n) /* !!! important !!! */
-    {
+    // Copy the graphs and animations of duplicate scenes before their originals get renamed
+    std::vector<aiNode *> roots(src.size());
+    ParallelFor(src.size(), numThreads, [&](size_t n) {
         SceneHelper *cur = &src[n];
-        aiNode *node;
+        aiAnimation **ppAnims = dest->mAnimations + animOffset[n];
 
         // To offset or not to offset, this is the question
-        if (n != (int)duplicates[n]) {
+        if (!isOriginal(n)) {
             // Get full scene-graph copy
-            Copy(&node, (*cur)->mRootNode);
-            OffsetNodeMeshIndices(node, offset[duplicates[n]]);
+            Copy(&roots[n], (*cur)->mRootNode);
+            OffsetNodeMeshIndices(roots[n], meshOffset[duplicates[n]]);
 
             if (flags & AI_INT_MERGE_SCENE_DUPLICATES_DEEP_CPY) {
                 // (note:) they are already 'offseted' by offset[duplicates[n]]
-                OffsetNodeMeshIndices(node, offset[n] - offset[duplicates[n]]);
+                OffsetNodeMeshIndices(roots[n], meshOffset[n] - meshOffset[duplicates[n]]);
+            }
+
+            for (unsigned int i = 0; i < (*cur)->mNumAnimations; ++i) {
+                Copy(&ppAnims[i], (*cur)->mAnimations[i]);
+            }
+        } else {
+            roots[n] = (*cur)->mRootNode;
+            for (unsigned int i = 0; i < (*cur)->mNumAnimations; ++i) {
+                ppAnims[i] = (*cur)->mAnimations[i];
             }
-        } else // if (n == duplicates[n])
-        {
-            node = (*cur)->mRootNode;
-            OffsetNodeMeshIndices(node, offset[n]);
         }
-        if (n) // src[0] is the master node
-            nodes.emplace_back(node, srcList[n - 1].attachToNode, n);
+    });
 
-        // add name prefixes?
-        if (flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES) {
+    // Each scene now owns its graph and animations, so the scenes can be processed independently
+    ParallelFor(src.size(), numThreads, [&](size_t n) {
+        SceneHelper *cur = &src[n];
+        if (isOriginal(n)) {
+            OffsetNodeMeshIndices(roots[n], meshOffset[n]);
+        }
 
-            // or the whole scenegraph
-            if (flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES_IF_NECESSARY) {
-                AddNodePrefixesChecked(node, (*cur).id, (*cur).idlen, src, n);
-            } else
-                AddNodePrefixes(node, (*cur).id, (*cur).idlen);
+        // add name prefixes?
+        if (!(flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES)) {
+            return;
+        }
 
-            // meshes
-            for (unsigned int i = 0; i < (*cur)->mNumMeshes; ++i) {
-                aiMesh *mesh = (*cur)->mMeshes[i];
+        // or the whole scenegraph
+        if (flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES_IF_NECESSARY) {
+            AddNodePrefixesChecked(roots[n], (*cur).id, (*cur).idlen, hashCounts, *cur);
+        } else
+            AddNodePrefixes(roots[n], (*cur).id, (*cur).idlen);
 
-                // rename all bones
-                for (unsigned int a = 0; a < mesh->mNumBones; ++a) {
-                    if (flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES_IF_NECESSARY) {
-                        if (!FindNameMatch(mesh->mBones[a]->mName, src, n))
-                            continue;
-                    }
-                    PrefixString(mesh->mBones[a]->mName, (*cur).id, (*cur).idlen);
-                }
+        aiAnimation **ppAnims = dest->mAnimations + animOffset[n];
+        for (unsigned int i = 0; i < (*cur)->mNumAnimations; ++i) {
+            if (flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES_IF_NECESSARY) {
+                if (!FindNameMatch(ppAnims[i]->mName, hashCounts, *cur))
+                    continue;
             }
-        }
 
-        // --------------------------------------------------------------------
-        // Copy animations
-        for (unsigned int i = 0; i < (*cur)->mNumAnimations; ++i, ++ppAnims) {
-            if (n != (int)duplicates[n]) // duplicate scene?
-            {
-                Copy(ppAnims, (*cur)->mAnimations[i]);
-            } else
-                *ppAnims = (*cur)->mAnimations[i];
-
-            // Add name prefixes?
-            if (flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES) {
+            PrefixString(ppAnims[i]->mName, (*cur).id, (*cur).idlen);
+
+            // don't forget to update all node animation channels
+            for (unsigned int a = 0; a < ppAnims[i]->mNumChannels; ++a) {
                 if (flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES_IF_NECESSARY) {
-                    if (!FindNameMatch((*ppAnims)->mName, src, n))
+                    if (!FindNameMatch(ppAnims[i]->mChannels[a]->mNodeName, hashCounts, *cur))
                         continue;
                 }
 
-                PrefixString((*ppAnims)->mName, (*cur).id, (*cur).idlen);
+                PrefixString(ppAnims[i]->mChannels[a]->mNodeName, (*cur).id, (*cur).idlen);
+            }
+        }
+    });
 
-                // don't forget to update all node animation channels
-                for (unsigned int a = 0; a < (*ppAnims)->mNumChannels; ++a) {
+    // rename all bones. Duplicate scenes share their meshes, so this runs in the old order.
+    if (flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES) {
+        for (size_t n = src.size(); n-- > 0;) {
+            SceneHelper *cur = &src[n];
+            for (unsigned int i = 0; i < (*cur)->mNumMeshes; ++i) {
+                aiMesh *mesh = (*cur)->mMeshes[i];
+                for (unsigned int a = 0; a < mesh->mNumBones; ++a) {
                     if (flags & AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES_IF_NECESSARY) {
-                        if (!FindNameMatch((*ppAnims)->mChannels[a]->mNodeName, src, n))
+                        if (!FindNameMatch(mesh->mBones[a]->mName, hashCounts, *cur))
                             continue;
                     }
-
-                    PrefixString((*ppAnims)->mChannels[a]->mNodeName, (*cur).id, (*cur).idlen);
+                    PrefixString(mesh->mBones[a]->mName, (*cur).id, (*cur).idlen);
                 }
             }
         }
     }
 
+    // src[0] is the master node
+    std::vector<NodeAttachmentInfo> nodes;
+    nodes.reserve(srcList.size());
+    for (size_t n = src.size() - 1; n > 0; --n) {
+        nodes.emplace_back(roots[n], srcList[n - 1].attachToNode, n);
+    }
+
     // Now build the output graph
     AttachToGraph(master, nodes);
     dest->mRootNode = master->mRootNode;
@@ -899,6 +930,145 @@ inline void GetArrayCopy(Type *&dest, ai_uint num) {
     ::memcpy(dest, old, sizeof(Type) * num);
 }
 
+// ------------------------------------------------------------------------------------------------
+// Arrays shared by scenes copied with CopyScene(..., shareArrays = true). Every scene using an
+// array holds one reference to it; the last scene releasing an array frees it like any other
+// array of its own. The set never frees arrays itself, so an array which left its scene without
+// being released (e.g. a mesh moved to another scene) stays with its new owner.
+struct SharedSceneArrays {
+    std::mutex mMutex;
+    std::unordered_map<void *, unsigned int> mRefs;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Replace a shared array by a private copy of its first size bytes
+template <typename Type>
+inline void CopySharedArray(Type *&data, size_t size) {
+    Type *old = data;
+
+    data = new Type[(size + sizeof(Type) - 1) / sizeof(Type)];
+    ::memcpy(data, old, size);
+}
+
+// ------------------------------------------------------------------------------------------------
+inline void CopySharedArray(aiFace *&faces, size_t size) {
+    GetArrayCopy(faces, static_cast<ai_uint>(size / sizeof(aiFace)));
+    for (size_t i = 0; i < size / sizeof(aiFace); ++i) {
+        aiFace &f = faces[i];
+        GetArrayCopy(f.mIndices, f.mNumIndices);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Call visit(array, size in bytes) for all arrays of a mesh and its levels of detail
+template <typename Visitor>
+void VisitShareableMeshArrays(aiMesh *mesh, Visitor &visit) {
+    const size_t vecSize = sizeof(aiVector3D) * mesh->mNumVertices;
+    visit(mesh->mVertices, vecSize);
+    visit(mesh->mNormals, vecSize);
+    visit(mesh->mTangents, vecSize);
+    visit(mesh->mBitangents, vecSize);
+    for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++n) {
+        visit(mesh->mTextureCoords[n], vecSize);
+    }
+    visit(mesh->mFaces, sizeof(aiFace) * mesh->mNumFaces);
+
+    for (unsigned int n = 0; mesh->mBones && n < mesh->mNumBones; ++n) {
+        if (mesh->mBones[n]) {
+            visit(mesh->mBones[n]->mWeights, sizeof(aiVertexWeight) * mesh->mBones[n]->mNumWeights);
+        }
+    }
+
+    for (unsigned int n = 0; mesh->mAnimMeshes && n < mesh->mNumAnimMeshes; ++n) {
+        aiAnimMesh *anim = mesh->mAnimMeshes[n];
+        const size_t animSize = sizeof(aiVector3D) * anim->mNumVertices;
+        visit(anim->mVertices, animSize);
+        visit(anim->mNormals, animSize);
+        visit(anim->mTangents, animSize);
+        visit(anim->mBitangents, animSize);
+        for (unsigned int m = 0; m < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++m) {
+            visit(anim->mTextureCoords[m], animSize);
+        }
+    }
+
+    visit(mesh->mMeshlets, sizeof(aiMeshlet) * mesh->mNumMeshlets);
+    visit(mesh->mMeshletVertices, sizeof(unsigned int) * mesh->mNumMeshletVertices);
+    visit(mesh->mMeshletTriangles, size_t(3) * mesh->mNumMeshletTriangles);
+
+    for (unsigned int n = 0; mesh->mLODs && n < mesh->mNumLODs; ++n) {
+        if (mesh->mLODs[n]) {
+            VisitShareableMeshArrays(mesh->mLODs[n], visit);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Call visit(array, size in bytes) for all arrays of a scene which can be shared with other scenes
+template <typename Visitor>
+void VisitShareableArrays(aiScene *scene, Visitor &&visit) {
+    for (unsigned int i = 0; scene->mMeshes && i < scene->mNumMeshes; ++i) {
+        if (scene->mMeshes[i]) {
+            VisitShareableMeshArrays(scene->mMeshes[i], visit);
+        }
+    }
+
+    for (unsigned int i = 0; scene->mTextures && i < scene->mNumTextures; ++i) {
+        aiTexture *tex = scene->mTextures[i];
+        if (tex) {
+            visit(tex->pcData, tex->mHeight ? sizeof(aiTexel) * tex->mWidth * tex->mHeight : tex->mWidth);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Flat copy of a mesh, the arrays are shared with the source mesh
+void CopyMeshShared(aiMesh **_dest, const aiMesh *src) {
+    aiMesh *dest = *_dest = new aiMesh();
+
+    // get a flat copy
+    *dest = *src;
+
+    // bones and blend shapes are objects of their own, only their arrays are shared
+    if (dest->mNumBones && dest->mBones) {
+        dest->mBones = new aiBone *[dest->mNumBones];
+        for (unsigned int i = 0; i < dest->mNumBones; ++i) {
+            dest->mBones[i] = src->mBones[i] ? new aiBone() : nullptr;
+            if (dest->mBones[i]) {
+                dest->mBones[i]->mName = src->mBones[i]->mName;
+                dest->mBones[i]->mNumWeights = src->mBones[i]->mNumWeights;
+                dest->mBones[i]->mWeights = src->mBones[i]->mWeights;
+                dest->mBones[i]->mOffsetMatrix = src->mBones[i]->mOffsetMatrix;
+#ifndef ASSIMP_BUILD_NO_ARMATUREPOPULATE_PROCESS
+                dest->mBones[i]->mArmature = src->mBones[i]->mArmature;
+                dest->mBones[i]->mNode = src->mBones[i]->mNode;
+#endif
+            }
+        }
+    }
+
+    if (dest->mNumAnimMeshes && dest->mAnimMeshes) {
+        dest->mAnimMeshes = new aiAnimMesh *[dest->mNumAnimMeshes];
+        for (unsigned int i = 0; i < dest->mNumAnimMeshes; ++i) {
+            dest->mAnimMeshes[i] = new aiAnimMesh();
+            *dest->mAnimMeshes[i] = *src->mAnimMeshes[i];
+        }
+    }
+
+    if (src->mTextureCoordsNames != nullptr) {
+        dest->mTextureCoordsNames = new aiString *[AI_MAX_NUMBER_OF_TEXTURECOORDS] {};
+        for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+            SceneCombiner::Copy(&dest->mTextureCoordsNames[i], src->mTextureCoordsNames[i]);
+        }
+    }
+
+    if (dest->mNumLODs && dest->mLODs) {
+        dest->mLODs = new aiMesh *[dest->mNumLODs];
+        for (unsigned int i = 0; i < dest->mNumLODs; ++i) {
+            CopyMeshShared(&dest->mLODs[i], src->mLODs[i]);
+        }
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 void SceneCombiner::CopySceneFlat(aiScene **_dest, const aiScene *src) {
     if (nullptr == _dest || nullptr == src) {
@@ -916,11 +1086,17 @@ void SceneCombiner::CopySceneFlat(aiScene **_dest, const aiScene *src) {
 }
 
 // ------------------------------------------------------------------------------------------------
-void SceneCombiner::CopyScene(aiScene **_dest, const aiScene *src, bool allocate) {
+void SceneCombiner::CopyScene(aiScene **_dest, const aiScene *src, bool allocate, bool shareArrays) {
     if (nullptr == _dest || nullptr == src) {
         return;
     }
 
+    // sharing needs the private data of both scenes to keep track of the shared arrays
+    ScenePrivateData *srcPriv = static_cast<ScenePrivateData *>(src->mPrivate);
+    if (nullptr == srcPriv || (!allocate && nullptr == ScenePriv(*_dest))) {
+        shareArrays = false;
+    }
+
     if (allocate) {
         *_dest = new aiScene();
     }
@@ -938,8 +1114,16 @@ void SceneCombiner::CopyScene(aiScene **_dest, const aiScene *src, bool allocate
 
     // copy textures
     dest->mNumTextures = src->mNumTextures;
-    CopyPtrArray(dest->mTextures, src->mTextures,
-            dest->mNumTextures);
+    if (shareArrays && dest->mNumTextures) {
+        dest->mTextures = new aiTexture *[dest->mNumTextures];
+        for (unsigned int i = 0; i < dest->mNumTextures; ++i) {
+            dest->mTextures[i] = new aiTexture();
+            *dest->mTextures[i] = *src->mTextures[i];
+        }
+    } else {
+        CopyPtrArray(dest->mTextures, src->mTextures,
+                dest->mNumTextures);
+    }
 
     // copy materials
     dest->mNumMaterials = src->mNumMaterials;
@@ -948,8 +1132,33 @@ void SceneCombiner::CopyScene(aiScene **_dest, const aiScene *src, bool allocate
 
     // copy meshes
     dest->mNumMeshes = src->mNumMeshes;
-    CopyPtrArray(dest->mMeshes, src->mMeshes,
-            dest->mNumMeshes);
+    if (shareArrays && dest->mNumMeshes) {
+        dest->mMeshes = new aiMesh *[dest->mNumMeshes];
+        for (unsigned int i = 0; i < dest->mNumMeshes; ++i) {
+            CopyMeshShared(&dest->mMeshes[i], src->mMeshes[i]);
+        }
+    } else {
+        CopyPtrArray(dest->mMeshes, src->mMeshes,
+                dest->mNumMeshes);
+    }
+
+    // register the arrays, both scenes reference the same set
+    if (shareArrays) {
+        if (!srcPriv->mSharedArrays) {
+            srcPriv->mSharedArrays = std::make_shared<SharedSceneArrays>();
+        }
+        SharedSceneArrays &shared = *srcPriv->mSharedArrays;
+
+        std::lock_guard<std::mutex> lock(shared.mMutex);
+        VisitShareableArrays(dest, [&shared](auto *&data, size_t) {
+            if (data) {
+                // an array seen for the first time is referenced by the source scene, too
+                unsigned int &refs = shared.mRefs.emplace(data, 1).first->second;
+                ++refs;
+            }
+        });
+        ScenePriv(dest)->mSharedArrays = srcPriv->mSharedArrays;
+    }
 
     // now - copy the root node of the scene (deep copy, too)
     Copy(&dest->mRootNode, src->mRootNode);
@@ -963,6 +1172,61 @@ void SceneCombiner::CopyScene(aiScene **_dest, const aiScene *src, bool allocate
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+void SceneCombiner::UnshareScene(aiScene *scene) {
+    ScenePrivateData *priv = ScenePriv(scene);
+    if (nullptr == priv || !priv->mSharedArrays) {
+        return;
+    }
+
+    {
+        SharedSceneArrays &shared = *priv->mSharedArrays;
+        std::lock_guard<std::mutex> lock(shared.mMutex);
+
+        VisitShareableArrays(scene, [&shared](auto *&data, size_t size) {
+            auto it = shared.mRefs.find(data);
+            if (it == shared.mRefs.end()) {
+                return;
+            }
+
+            // the last reference takes the array over without copying it
+            if (--it->second == 0) {
+                shared.mRefs.erase(it);
+            } else {
+                CopySharedArray(data, size);
+            }
+        });
+    }
+    priv->mSharedArrays.reset();
+}
+
+// ------------------------------------------------------------------------------------------------
+void SceneCombiner::ReleaseSharedArrays(aiScene *scene) {
+    ScenePrivateData *priv = ScenePriv(scene);
+    if (nullptr == priv || !priv->mSharedArrays) {
+        return;
+    }
+
+    {
+        SharedSceneArrays &shared = *priv->mSharedArrays;
+        std::lock_guard<std::mutex> lock(shared.mMutex);
+        VisitShareableArrays(scene, [&shared](auto *&data, size_t) {
+            auto it = shared.mRefs.find(data);
+            if (it == shared.mRefs.end()) {
+                return;
+            }
+
+            // keep the last reference for the scene destructor to free
+            if (--it->second == 0) {
+                shared.mRefs.erase(it);
+            } else {
+                data = nullptr;
+            }
+        });
+    }
+    priv->mSharedArrays.reset();
+}
+
 // ------------------------------------------------------------------------------------------------
 void SceneCombiner::Copy(aiMesh **_dest, const aiMesh *src) {
     if (nullptr == _dest || nullptr == src) {
@@ -1007,6 +1271,14 @@ void SceneCombiner::Copy(aiMesh **_dest, const aiMesh *src) {
             Copy(&dest->mTextureCoordsNames[i], src->mTextureCoordsNames[i]);
         }
     }
+
+    // and of the meshlets
+    GetArrayCopy(dest->mMeshlets, dest->mNumMeshlets);
+    GetArrayCopy(dest->mMeshletVertices, dest->mNumMeshletVertices);
+    GetArrayCopy(dest->mMeshletTriangles, dest->mNumMeshletTriangles * 3);
+
+    // and of the levels of detail
+    CopyPtrArray(dest->mLODs, dest->mLODs, dest->mNumLODs);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -48,10 +48,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <assimp/scene.h>
 
+#include <memory>
+
 namespace Assimp {
 
 // Forward declarations
 class Importer;
+struct SharedSceneArrays;
 
 struct ScenePrivateData {
     //  The struct constructor.
@@ -70,13 +73,18 @@ struct ScenePrivateData {
     // and mOrigImporter are no longer safe to rely on and only
     // serve informative purposes.
     bool mIsCopy;
+
+    // Arrays shared with other scenes, see SceneCombiner::CopyScene().
+    // The arrays listed in it are not owned by the scene.
+    std::shared_ptr<SharedSceneArrays> mSharedArrays;
 };
 
 inline
 ScenePrivateData::ScenePrivateData() AI_NO_EXCEPT
 : mOrigImporter( nullptr )
 , mPPStepsApplied( 0 )
-, mIsCopy( false ) {
+, mIsCopy( false )
+, mSharedArrays() {
     // empty
 }
 
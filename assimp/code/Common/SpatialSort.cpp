@@ -43,6 +43,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <assimp/SpatialSort.h>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace Assimp;
 
 // CHAR_BIT seems to be defined under MVSC, but not under GCC. Pray that the correct value is 8.
@@ -52,12 +55,52 @@ using namespace Assimp;
 
 const aiVector3D PlaneInit(0.8523f, 0.34321f, 0.5736f);
 
+namespace {
+
+// Smallest number of positions for which a grid is considered at all.
+const size_t GridMinPositions = 1024;
+
+// Average number of positions in a search slab along the sorting plane above which the grid
+// pays off. The slab width is the typical search radius of 1e-4 of the bounding box diagonal.
+const size_t GridMinSlabPositions = 16;
+
+// Average number of positions per grid cell.
+const ai_real GridPositionsPerCell = ai_real(2.0);
+
+// Grid cell coordinates are clamped to 21 bits each so they can be packed into one key.
+const int64_t GridMaxCell = (int64_t(1) << 21) - 1;
+
+// Queries spanning more cells than this fall back to the sorting plane.
+const int64_t GridMaxQueryCells = 64;
+
+// --------------------------------------------------------------------------------------------
+// Returns the clamped grid cell coordinate of a scaled position component.
+int64_t ToCell(ai_real pValue) {
+    const ai_real cell = std::floor(pValue);
+    if (!(cell > ai_real(0.0))) {
+        return 0;
+    }
+    if (cell >= ai_real(GridMaxCell)) {
+        return GridMaxCell;
+    }
+    return static_cast<int64_t>(cell);
+}
+
+// --------------------------------------------------------------------------------------------
+// Packs grid cell coordinates into a single key.
+uint64_t ToCellKey(int64_t pX, int64_t pY, int64_t pZ) {
+    return (static_cast<uint64_t>(pX) << 42) | (static_cast<uint64_t>(pY) << 21) | static_cast<uint64_t>(pZ);
+}
+
+} // namespace
+
 // ------------------------------------------------------------------------------------------------
 // Constructs a spatially sorted representation from the given position array.
 // define the reference plane. We choose some arbitrary vector away from all basic axes
 // in the hope that no model spreads all its vertices along this plane.
 SpatialSort::SpatialSort(const aiVector3D *pPositions, unsigned int pNumPositions, unsigned int pElementOffset) :
         mPlaneNormal(PlaneInit),
+        mGridScale(0.0),
         mFinalized(false) {
     mPlaneNormal.Normalize();
     Fill(pPositions, pNumPositions, pElementOffset);
@@ -66,6 +109,7 @@ SpatialSort::SpatialSort(const aiVector3D *pPositions, unsigned int pNumPosition
 // ------------------------------------------------------------------------------------------------
 SpatialSort::SpatialSort() :
         mPlaneNormal(PlaneInit),
+        mGridScale(0.0),
         mFinalized(false) {
     mPlaneNormal.Normalize();
 }
@@ -79,6 +123,7 @@ void SpatialSort::Fill(const aiVector3D *pPositions, unsigned int pNumPositions,
         unsigned int pElementOffset,
         bool pFinalize /*= true */) {
     mPositions.clear();
+    mGrid.clear();
     mFinalized = false;
     Append(pPositions, pNumPositions, pElementOffset, pFinalize);
     mFinalized = pFinalize;
@@ -99,9 +144,131 @@ void SpatialSort::Finalize() {
         mPositions[i].mDistance = CalculateDistance(mPositions[i].mPosition);
     }
     std::sort(mPositions.begin(), mPositions.end());
+    BuildGrid();
     mFinalized = true;
 }
 
+// ------------------------------------------------------------------------------------------------
+// Builds a uniform grid over the sorted positions if searching along the sorting plane alone
+// would visit many positions per query, as it happens for large meshes or meshes which spread
+// their vertices along the plane.
+void SpatialSort::BuildGrid() {
+    mGrid.clear();
+    if (mPositions.size() < GridMinPositions) {
+        return;
+    }
+
+    aiVector3D minVec = mPositions[0].mPosition, maxVec = minVec;
+    for (const Entry &entry : mPositions) {
+        const aiVector3D &pos = entry.mPosition;
+        if (!std::isfinite(pos.x) || !std::isfinite(pos.y) || !std::isfinite(pos.z)) {
+            return;
+        }
+        for (unsigned int axis = 0; axis < 3; ++axis) {
+            minVec[axis] = std::min(minVec[axis], pos[axis]);
+            maxVec[axis] = std::max(maxVec[axis], pos[axis]);
+        }
+    }
+    const aiVector3D extent = maxVec - minVec;
+    const ai_real diagonal = extent.Length();
+    if (diagonal <= ai_real(0.0)) {
+        return;
+    }
+
+    // Estimate the average number of positions visited by FindPositions() along the sorting plane
+    // with the usual search radius. Uniformly spread meshes of moderate size stay on the plane.
+    const ai_real radius = diagonal * ai_real(1e-4);
+    size_t slabPositions = 0;
+    for (size_t i = 0, begin = 0, end = 0; i < mPositions.size(); ++i) {
+        while (mPositions[begin].mDistance < mPositions[i].mDistance - radius) {
+            ++begin;
+        }
+        while (end < mPositions.size() && mPositions[end].mDistance < mPositions[i].mDistance + radius) {
+            ++end;
+        }
+        slabPositions += end - begin;
+    }
+    if (slabPositions < GridMinSlabPositions * mPositions.size()) {
+        return;
+    }
+
+    // Pick the cell size so that the cells over all non-flat axes hold a few positions each.
+    ai_real measure = 1.0;
+    unsigned int numAxes = 0;
+    for (unsigned int axis = 0; axis < 3; ++axis) {
+        if (extent[axis] > diagonal * ai_real(1e-6)) {
+            measure *= extent[axis];
+            ++numAxes;
+        }
+    }
+    const ai_real numCells = static_cast<ai_real>(mPositions.size()) / GridPositionsPerCell;
+    const ai_real cellSize = std::max(std::pow(measure / numCells, ai_real(1.0) / numAxes), diagonal * ai_real(1e-6));
+    mGridOrigin = minVec;
+    mGridScale = ai_real(1.0) / cellSize;
+
+    mGrid.reserve(mPositions.size());
+    for (unsigned int i = 0; i < mPositions.size(); ++i) {
+        mGrid.emplace_back(CalculateCellKey(mPositions[i].mPosition), i);
+    }
+    std::sort(mGrid.begin(), mGrid.end());
+}
+
+// ------------------------------------------------------------------------------------------------
+uint64_t SpatialSort::CalculateCellKey(const aiVector3D &pPosition) const {
+    const aiVector3D scaled = (pPosition - mGridOrigin) * mGridScale;
+    return ToCellKey(ToCell(scaled.x), ToCell(scaled.y), ToCell(scaled.z));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Searches the grid cells overlapping the query sphere. The entries of each cell are sorted by
+// their distance to the sorting plane, so only the part of the cell inside the plane range is
+// visited.
+bool SpatialSort::FindPositionsInGrid(const aiVector3D &pPosition, ai_real pRadius,
+        std::vector<unsigned int> &poResults) const {
+    const aiVector3D scaledMin = (pPosition - aiVector3D(pRadius) - mGridOrigin) * mGridScale;
+    const aiVector3D scaledMax = (pPosition + aiVector3D(pRadius) - mGridOrigin) * mGridScale;
+    const int64_t minX = ToCell(scaledMin.x), minY = ToCell(scaledMin.y), minZ = ToCell(scaledMin.z);
+    const int64_t maxX = ToCell(scaledMax.x), maxY = ToCell(scaledMax.y), maxZ = ToCell(scaledMax.z);
+    if ((maxX - minX + 1) * (maxY - minY + 1) * (maxZ - minZ + 1) > GridMaxQueryCells) {
+        return false;
+    }
+
+    const ai_real dist = CalculateDistance(pPosition);
+    const ai_real minDist = dist - pRadius, maxDist = dist + pRadius;
+    const ai_real pSquared = pRadius * pRadius;
+    unsigned int numCells = 0;
+    for (int64_t x = minX; x <= maxX; ++x) {
+        for (int64_t y = minY; y <= maxY; ++y) {
+            for (int64_t z = minZ; z <= maxZ; ++z) {
+                const uint64_t key = ToCellKey(x, y, z);
+                auto it = std::lower_bound(mGrid.begin(), mGrid.end(), std::make_pair(key, 0u));
+                auto end = std::lower_bound(it, mGrid.end(), std::make_pair(key + 1, 0u));
+                it = std::lower_bound(it, end, minDist, [this](const std::pair<uint64_t, unsigned int> &cell, ai_real d) {
+                    return mPositions[cell.second].mDistance < d;
+                });
+                const size_t numResults = poResults.size();
+                for (; it != end && mPositions[it->second].mDistance < maxDist; ++it) {
+                    if ((mPositions[it->second].mPosition - pPosition).SquareLength() < pSquared) {
+                        poResults.push_back(it->second);
+                    }
+                }
+                if (poResults.size() != numResults) {
+                    ++numCells;
+                }
+            }
+        }
+    }
+
+    // keep the order of the search along the sorting plane
+    if (numCells > 1) {
+        std::sort(poResults.begin(), poResults.end());
+    }
+    for (unsigned int &result : poResults) {
+        result = mPositions[result].mIndex;
+    }
+    return true;
+}
+
 // ------------------------------------------------------------------------------------------------
 void SpatialSort::Append(const aiVector3D *pPositions, unsigned int pNumPositions,
         unsigned int pElementOffset,
@@ -140,6 +307,10 @@ void SpatialSort::FindPositions(const aiVector3D &pPosition,
     if (minDist > mPositions.back().mDistance)
         return;
 
+    if (!mGrid.empty() && FindPositionsInGrid(pPosition, pRadius, poResults)) {
+        return;
+    }
+
     // do a binary search for the minimal distance to start the iteration there
     unsigned int index = (unsigned int)mPositions.size() / 2;
     unsigned int binaryStepSize = (unsigned int)mPositions.size() / 4;
@@ -40,67 +40,103 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ----------------------------------------------------------------------
 */
 
+
 #include <assimp/Subdivision.h>
 #include <assimp/SceneCombiner.h>
 #include <assimp/SpatialSort.h>
 #include <assimp/Vertex.h>
 
+#include "Common/ParallelFor.h"
 #include "PostProcessing/ProcessHelper.h"
 
-#include <unordered_map>
+#include <algorithm>
 
 using namespace Assimp;
 
-void mydummy() {}
+namespace {
+
+// Number of elements a worker thread processes at once
+const size_t ParallelBlockSize = 4096;
+
+// ------------------------------------------------------------------------------------------------
+// Calls task(begin, end) for consecutive blocks of [0, count) on up to numThreads threads.
+template <class Task>
+void ParallelForBlocks(size_t count, unsigned int numThreads, Task &&task) {
+    const size_t numBlocks = (count + ParallelBlockSize - 1) / ParallelBlockSize;
+    ParallelFor(numBlocks, numThreads, [&](size_t block) {
+        task(block * ParallelBlockSize, std::min(count, (block + 1) * ParallelBlockSize));
+    });
+}
+
+} // namespace
 
-#ifdef _MSC_VER
-#pragma warning(disable : 4709)
-#endif // _MSC_VER
 // ------------------------------------------------------------------------------------------------
 /** Subdivider stub class to implement the Catmull-Clarke subdivision algorithm. The
  *  implementation is basing on recursive refinement. Directly evaluating the result is also
- *  possible and much quicker, but it depends on lengthy matrix lookup tables. */
+ *  possible and much quicker, but it depends on lengthy matrix lookup tables.
+ *
+ *  All meshes are refined as one surface, held in flat tables of shared points and face
+ *  corners. The points only describe the topology, the attributes are kept per corner so
+ *  texture seams and hard edges of the input survive. Only the last level is converted
+ *  back to meshes. */
 // ------------------------------------------------------------------------------------------------
 class CatmullClarkSubdivider : public Subdivider {
 public:
-    void Subdivide(aiMesh *mesh, aiMesh *&out, unsigned int num, bool discard_input);
+    void Subdivide(aiMesh *mesh, aiMesh *&out, unsigned int num, bool discard_input) override;
     void Subdivide(aiMesh **smesh, size_t nmesh,
-            aiMesh **out, unsigned int num, bool discard_input);
+            aiMesh **out, unsigned int num, bool discard_input) override;
 
+private:
     // ---------------------------------------------------------------------------
-    /** Intermediate description of an edge between two corners of a polygon*/
+    /** A polygon surface at one refinement level. Faces are stored as ranges of
+     *  corners, each corner refers to a point shared by all faces touching it
+     *  and to the vertex holding its attributes. */
     // ---------------------------------------------------------------------------
-    struct Edge {
-        Edge() :
-                ref(0) {}
-        Vertex edge_point, midpoint;
-        unsigned int ref;
+    struct Level {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> faceStart; // first corner of each face, plus the total
+        std::vector<unsigned int> corners; // point of each corner
+        std::vector<unsigned int> cornerVertices; // vertex of each corner, empty if it equals the point
+        std::vector<unsigned int> meshFaces; // first face of each input mesh, plus the total
+        unsigned int numPoints = 0;
     };
 
-    typedef std::vector<unsigned int> UIntVector;
-    typedef std::unordered_map<uint64_t, Edge> EdgeMap;
-
     // ---------------------------------------------------------------------------
-    // Hashing function to derive an index into an #EdgeMap from two given
-    // 'unsigned int' vertex coordinates (!!distinct coordinates - same
-    // vertex position == same index!!).
-    // NOTE - this leads to rare hash collisions if a) sizeof(unsigned int)>4
-    // and (id[0]>2^32-1 or id[0]>2^32-1).
-    // MAKE_EDGE_HASH() uses temporaries, so INIT_EDGE_HASH() needs to be put
-    // at the head of every function which is about to use MAKE_EDGE_HASH().
-    // Reason is that the hash is that hash construction needs to hold the
-    // invariant id0<id1 to identify an edge - else two hashes would refer
-    // to the same edge.
+    /** Adjacency of a level. A corner and the next corner of its face form a
+     *  half edge, all half edges between the same two points share one edge. */
     // ---------------------------------------------------------------------------
-#define MAKE_EDGE_HASH(id0, id1) (eh_tmp0__ = id0, eh_tmp1__ = id1, \
-        (eh_tmp0__ < eh_tmp1__ ? std::swap(eh_tmp0__, eh_tmp1__) : mydummy()), (uint64_t)eh_tmp0__ ^ ((uint64_t)eh_tmp1__ << 32u))
-
-#define INIT_EDGE_HASH_TEMPORARIES() \
-    unsigned int eh_tmp0__, eh_tmp1__;
+    struct Adjacency {
+        std::vector<unsigned int> cornerFace; // face of each corner
+        std::vector<unsigned int> pointStart; // first entry in pointCorners of each point, plus the total
+        std::vector<unsigned int> pointCorners; // corners grouped by their point
+        std::vector<unsigned int> cornerEdge; // edge of the half edge starting at each corner
+        std::vector<unsigned int> edgeCorner; // first corner of each edge
+    };
 
-private:
+    void BuildLevel(const aiMesh *const *smesh, size_t nmesh, Level &level) const;
+    void BuildAdjacency(const Level &level, Adjacency &adj) const;
+    void RefineLevel(const Level &in, const Adjacency &adj, Level &out) const;
     void InternSubdivide(const aiMesh *const *smesh,
             size_t nmesh, aiMesh **out, unsigned int num);
+
+    // ---------------------------------------------------------------------------
+    static unsigned int NextCorner(const Level &level, const Adjacency &adj, unsigned int c) {
+        const unsigned int f = adj.cornerFace[c];
+        return c + 1 == level.faceStart[f + 1] ? level.faceStart[f] : c + 1;
+    }
+
+    // ---------------------------------------------------------------------------
+    static unsigned int PrevCorner(const Level &level, const Adjacency &adj, unsigned int c) {
+        const unsigned int f = adj.cornerFace[c];
+        return c == level.faceStart[f] ? level.faceStart[f + 1] - 1 : c - 1;
+    }
+
+    // ---------------------------------------------------------------------------
+    static const Vertex &CornerVertex(const Level &level, unsigned int c) {
+        return level.vertices[level.cornerVertices.empty() ? level.corners[c] : level.cornerVertices[c]];
+    }
+
+    unsigned int mThreads = 1;
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -185,6 +221,8 @@ void CatmullClarkSubdivider::Subdivide(
     if (inmeshes.empty()) {
         return;
     }
+    // large meshes are refined on all cores, meshes below one block stay on the calling thread
+    mThreads = GetNumWorkerThreads(0);
     InternSubdivide(&inmeshes.front(), inmeshes.size(), &outmeshes.front(), num);
     for (unsigned int i = 0; i < maptbl.size(); ++i) {
         out[maptbl[i]] = outmeshes[i];
@@ -198,346 +236,346 @@ void CatmullClarkSubdivider::Subdivide(
 }
 
 // ------------------------------------------------------------------------------------------------
-// Note - this is an implementation of the standard (recursive) Cm-Cl algorithm without further
-// optimizations (except we're using some nice LUTs). A description of the algorithm can be found
-// here: http://en.wikipedia.org/wiki/Catmull-Clark_subdivision_surface
-//
-// The code is mostly O(n), however parts are O(nlogn) which is therefore the algorithm's
-// expected total runtime complexity. The implementation is able to work in-place on the same
-// mesh arrays. Calling #InternSubdivide() directly is not encouraged. The code can operate
-// in-place unless 'smesh' and 'out' are equal (no strange overlaps or reorderings).
-// Previous data is replaced/deleted then.
-// ------------------------------------------------------------------------------------------------
-void CatmullClarkSubdivider::InternSubdivide(
-        const aiMesh *const *smesh,
-        size_t nmesh,
-        aiMesh **out,
-        unsigned int num) {
-
-    INIT_EDGE_HASH_TEMPORARIES();
-
-    // no subdivision requested or end of recursive refinement
-    if (!num) {
-        return;
-    }
-
-    UIntVector maptbl;
+// Collects the faces of all meshes in one level. Vertices at the same position become one point,
+// every corner keeps the attributes of its own vertex.
+void CatmullClarkSubdivider::BuildLevel(const aiMesh *const *smesh, size_t nmesh, Level &level) const {
     SpatialSort spatial;
-
-    // ---------------------------------------------------------------------
-    // 0. Offset table to index all meshes continuously, generate a spatially
-    // sorted representation of all vertices in all meshes.
-    // ---------------------------------------------------------------------
-    typedef std::pair<unsigned int, unsigned int> IntPair;
-    std::vector<IntPair> moffsets(nmesh);
-    unsigned int totfaces = 0, totvert = 0;
+    std::vector<unsigned int> vertexOffsets(nmesh);
+    unsigned int totvert = 0, totfaces = 0, totcorners = 0;
     for (size_t t = 0; t < nmesh; ++t) {
         const aiMesh *mesh = smesh[t];
-
         spatial.Append(mesh->mVertices, mesh->mNumVertices, sizeof(aiVector3D), false);
-        moffsets[t] = IntPair(totfaces, totvert);
-
-        totfaces += mesh->mNumFaces;
+        vertexOffsets[t] = totvert;
         totvert += mesh->mNumVertices;
+        totfaces += mesh->mNumFaces;
+        for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+            totcorners += mesh->mFaces[i].mNumIndices;
+        }
     }
-
     spatial.Finalize();
+
+    std::vector<unsigned int> maptbl;
     const unsigned int num_unique = spatial.GenerateMappingTable(maptbl, ComputePositionEpsilon(smesh, nmesh));
 
-#define FLATTEN_VERTEX_IDX(mesh_idx, vert_idx) (moffsets[mesh_idx].second + vert_idx)
-#define FLATTEN_FACE_IDX(mesh_idx, face_idx) (moffsets[mesh_idx].first + face_idx)
+    level.numPoints = num_unique;
+    level.vertices.resize(totvert);
+    level.faceStart.resize(totfaces + 1);
+    level.corners.resize(totcorners);
+    level.cornerVertices.resize(totcorners);
+    level.meshFaces.resize(nmesh + 1);
 
-    // ---------------------------------------------------------------------
-    // 1. Compute the centroid point for all faces
-    // ---------------------------------------------------------------------
-    std::vector<Vertex> centroids(totfaces);
-    unsigned int nfacesout = 0;
-    for (size_t t = 0, n = 0; t < nmesh; ++t) {
+    unsigned int f = 0, c = 0;
+    for (size_t t = 0; t < nmesh; ++t) {
         const aiMesh *mesh = smesh[t];
-        for (unsigned int i = 0; i < mesh->mNumFaces; ++i, ++n) {
-            const aiFace &face = mesh->mFaces[i];
-            Vertex &c = centroids[n];
-
-            for (unsigned int a = 0; a < face.mNumIndices; ++a) {
-                c += Vertex(mesh, face.mIndices[a]);
+        Vertex *const vertices = &level.vertices[vertexOffsets[t]];
+        ParallelForBlocks(mesh->mNumVertices, mThreads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                vertices[i] = Vertex(mesh, static_cast<unsigned int>(i));
             }
+        });
 
-            c /= static_cast<float>(face.mNumIndices);
-            nfacesout += face.mNumIndices;
+        level.meshFaces[t] = f;
+        for (unsigned int i = 0; i < mesh->mNumFaces; ++i, ++f) {
+            const aiFace &face = mesh->mFaces[i];
+            level.faceStart[f] = c;
+            for (unsigned int a = 0; a < face.mNumIndices; ++a, ++c) {
+                const unsigned int v = vertexOffsets[t] + face.mIndices[a];
+                level.corners[c] = maptbl[v];
+                level.cornerVertices[c] = v;
+            }
         }
     }
+    level.faceStart[totfaces] = totcorners;
+    level.meshFaces[nmesh] = totfaces;
+}
 
-    {
-        // we want edges to go away before the recursive calls so begin a new scope
-        EdgeMap edges;
-
-        // ---------------------------------------------------------------------
-        // 2. Set each edge point to be the average of all neighbouring
-        // face points and original points. Every edge exists twice
-        // if there is a neighboring face.
-        // ---------------------------------------------------------------------
-        for (size_t t = 0; t < nmesh; ++t) {
-            const aiMesh *mesh = smesh[t];
-
-            for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
-                const aiFace &face = mesh->mFaces[i];
-
-                for (unsigned int p = 0; p < face.mNumIndices; ++p) {
-                    const unsigned int id[] = {
-                        face.mIndices[p],
-                        face.mIndices[p == face.mNumIndices - 1 ? 0 : p + 1]
-                    };
-                    const unsigned int mp[] = {
-                        maptbl[FLATTEN_VERTEX_IDX(t, id[0])],
-                        maptbl[FLATTEN_VERTEX_IDX(t, id[1])]
-                    };
-
-                    Edge &e = edges[MAKE_EDGE_HASH(mp[0], mp[1])];
-                    e.ref++;
-                    if (e.ref <= 2) {
-                        if (e.ref == 1) { // original points (end points) - add only once
-                            e.edge_point = e.midpoint = Vertex(mesh, id[0]) + Vertex(mesh, id[1]);
-                            e.midpoint *= 0.5f;
-                        }
-                        e.edge_point += centroids[FLATTEN_FACE_IDX(t, i)];
-                    }
-                }
+// ------------------------------------------------------------------------------------------------
+// Builds the corner-face, point-corner and corner-edge tables of a level
+void CatmullClarkSubdivider::BuildAdjacency(const Level &level, Adjacency &adj) const {
+    const unsigned int numFaces = static_cast<unsigned int>(level.faceStart.size() - 1);
+    const unsigned int numCorners = static_cast<unsigned int>(level.corners.size());
+    const unsigned int numPoints = level.numPoints;
+
+    adj.cornerFace.resize(numCorners);
+    ParallelForBlocks(numFaces, mThreads, [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; ++f) {
+            for (unsigned int c = level.faceStart[f]; c < level.faceStart[f + 1]; ++c) {
+                adj.cornerFace[c] = static_cast<unsigned int>(f);
             }
         }
+    });
+
+    // counting sort of the corners by their point
+    adj.pointStart.assign(numPoints + 1, 0);
+    for (unsigned int c = 0; c < numCorners; ++c) {
+        ++adj.pointStart[level.corners[c] + 1];
+    }
+    for (unsigned int p = 0; p < numPoints; ++p) {
+        adj.pointStart[p + 1] += adj.pointStart[p];
+    }
+    adj.pointCorners.resize(numCorners);
+    std::vector<unsigned int> fill(adj.pointStart.begin(), adj.pointStart.end() - 1);
+    for (unsigned int c = 0; c < numCorners; ++c) {
+        adj.pointCorners[fill[level.corners[c]]++] = c;
+    }
 
-        // ---------------------------------------------------------------------
-        // 3. Normalize edge points
-        // ---------------------------------------------------------------------
-        {
-            unsigned int bad_cnt = 0;
-            for (EdgeMap::iterator it = edges.begin(); it != edges.end(); ++it) {
-                if ((*it).second.ref < 2) {
-                    ++bad_cnt;
+    // every half edge refers to the lowest corner starting a half edge between the same points
+    adj.cornerEdge.resize(numCorners);
+    ParallelForBlocks(numCorners, mThreads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const unsigned int c = static_cast<unsigned int>(i);
+            const unsigned int p = level.corners[c], q = level.corners[NextCorner(level, adj, c)];
+            unsigned int first = c;
+            for (unsigned int k = adj.pointStart[p]; k < adj.pointStart[p + 1]; ++k) {
+                const unsigned int o = adj.pointCorners[k];
+                if (o < first && level.corners[NextCorner(level, adj, o)] == q) {
+                    first = o;
                 }
-                (*it).second.edge_point *= 1.f / ((*it).second.ref + 2.f);
             }
-        }
-
-        // ---------------------------------------------------------------------
-        // 4. Compute a vertex-face adjacency table. We can't reuse the code
-        // from VertexTriangleAdjacency because we need the table for multiple
-        // meshes and out vertex indices need to be mapped to distinct values
-        // first.
-        // ---------------------------------------------------------------------
-        UIntVector faceadjac(nfacesout), cntadjfac(maptbl.size(), 0), ofsadjvec(maptbl.size() + 1, 0);
-        {
-            for (size_t t = 0; t < nmesh; ++t) {
-                const aiMesh *const minp = smesh[t];
-                for (unsigned int i = 0; i < minp->mNumFaces; ++i) {
-
-                    const aiFace &f = minp->mFaces[i];
-                    for (unsigned int n = 0; n < f.mNumIndices; ++n) {
-                        ++cntadjfac[maptbl[FLATTEN_VERTEX_IDX(t, f.mIndices[n])]];
-                    }
+            for (unsigned int k = adj.pointStart[q]; k < adj.pointStart[q + 1]; ++k) {
+                const unsigned int o = adj.pointCorners[k];
+                if (o < first && level.corners[NextCorner(level, adj, o)] == p) {
+                    first = o;
                 }
             }
-            unsigned int cur = 0;
-            for (size_t i = 0; i < cntadjfac.size(); ++i) {
-                ofsadjvec[i + 1] = cur;
-                cur += cntadjfac[i];
+            adj.cornerEdge[c] = first;
+        }
+    });
+
+    // number the edges, the lowest corner of an edge is always visited first
+    adj.edgeCorner.clear();
+    for (unsigned int c = 0; c < numCorners; ++c) {
+        if (adj.cornerEdge[c] == c) {
+            adj.cornerEdge[c] = static_cast<unsigned int>(adj.edgeCorner.size());
+            adj.edgeCorner.push_back(c);
+        } else {
+            adj.cornerEdge[c] = adj.cornerEdge[adj.cornerEdge[c]];
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Note - this is an implementation of the standard (recursive) Cm-Cl algorithm. A description of
+// the algorithm can be found here: http://en.wikipedia.org/wiki/Catmull-Clark_subdivision_surface
+//
+// The refined level holds the moved original points first, followed by one point per edge and
+// one point per face. Every corner of the coarse level becomes a quad. Face points average the
+// corners of their face. Edge points, edge midpoints and moved points take the attributes of the
+// first corner referring to their edge or point, the refined level has one vertex per point.
+// ------------------------------------------------------------------------------------------------
+void CatmullClarkSubdivider::RefineLevel(const Level &in, const Adjacency &adj, Level &out) const {
+    const unsigned int numFaces = static_cast<unsigned int>(in.faceStart.size() - 1);
+    const unsigned int numCorners = static_cast<unsigned int>(in.corners.size());
+    const unsigned int numPoints = in.numPoints;
+    const unsigned int numEdges = static_cast<unsigned int>(adj.edgeCorner.size());
+    const unsigned int edgeBase = numPoints, faceBase = numPoints + numEdges;
+
+    out.numPoints = faceBase + numFaces;
+    out.vertices.resize(out.numPoints);
+    out.cornerVertices.clear();
+    Vertex *const facePoints = &out.vertices[faceBase];
+
+    // the midpoint of an edge, taken from the corners of its first half edge
+    auto midpoint = [&](unsigned int e) {
+        const unsigned int c = adj.edgeCorner[e];
+        return (CornerVertex(in, c) + CornerVertex(in, NextCorner(in, adj, c))) / ai_real(2.0);
+    };
+
+    // ---------------------------------------------------------------------
+    // 1. Compute the centroid point for all faces
+    // ---------------------------------------------------------------------
+    ParallelForBlocks(numFaces, mThreads, [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; ++f) {
+            Vertex c;
+            for (unsigned int k = in.faceStart[f]; k < in.faceStart[f + 1]; ++k) {
+                c += CornerVertex(in, k);
             }
-            for (size_t t = 0; t < nmesh; ++t) {
-                const aiMesh *const minp = smesh[t];
-                for (unsigned int i = 0; i < minp->mNumFaces; ++i) {
+            facePoints[f] = c / static_cast<ai_real>(in.faceStart[f + 1] - in.faceStart[f]);
+        }
+    });
 
-                    const aiFace &f = minp->mFaces[i];
-                    for (unsigned int n = 0; n < f.mNumIndices; ++n) {
-                        faceadjac[ofsadjvec[1 + maptbl[FLATTEN_VERTEX_IDX(t, f.mIndices[n])]]++] = FLATTEN_FACE_IDX(t, i);
+    // ---------------------------------------------------------------------
+    // 2. Set each edge point to be the average of the two end points and
+    // the centroids of the (at most two) first faces sharing the edge.
+    // ---------------------------------------------------------------------
+    ParallelForBlocks(numEdges, mThreads, [&](size_t begin, size_t end) {
+        for (size_t e = begin; e < end; ++e) {
+            const unsigned int c = adj.edgeCorner[e];
+            const unsigned int p = in.corners[c], q = in.corners[NextCorner(in, adj, c)];
+
+            unsigned int ref = 0, other = UINT_MAX;
+            for (unsigned int k = adj.pointStart[p]; k < adj.pointStart[p + 1]; ++k) {
+                const unsigned int o = adj.pointCorners[k];
+                if (adj.cornerEdge[o] == e) {
+                    ++ref;
+                    if (o != c) {
+                        other = std::min(other, o);
                     }
                 }
             }
-
-            // check the other way round for consistency
-#ifdef ASSIMP_BUILD_DEBUG
-
-            for (size_t t = 0; t < ofsadjvec.size() - 1; ++t) {
-                for (unsigned int m = 0; m < cntadjfac[t]; ++m) {
-                    const unsigned int fidx = faceadjac[ofsadjvec[t] + m];
-                    ai_assert(fidx < totfaces);
-                    for (size_t n = 1; n < nmesh; ++n) {
-
-                        if (moffsets[n].first > fidx) {
-                            const aiMesh *msh = smesh[--n];
-                            const aiFace &f = msh->mFaces[fidx - moffsets[n].first];
-
-                            bool haveit = false;
-                            for (unsigned int i = 0; i < f.mNumIndices; ++i) {
-                                if (maptbl[FLATTEN_VERTEX_IDX(n, f.mIndices[i])] == (unsigned int)t) {
-                                    haveit = true;
-                                    break;
-                                }
-                            }
-                            ai_assert(haveit);
-                            break;
-                        }
+            if (p != q) {
+                for (unsigned int k = adj.pointStart[q]; k < adj.pointStart[q + 1]; ++k) {
+                    const unsigned int o = adj.pointCorners[k];
+                    if (adj.cornerEdge[o] == e) {
+                        ++ref;
+                        other = std::min(other, o);
                     }
                 }
             }
 
-#endif
-        }
-
-#define GET_ADJACENT_FACES_AND_CNT(vidx, fstartout, numout) \
-    fstartout = &faceadjac[ofsadjvec[vidx]], numout = cntadjfac[vidx]
-
-        typedef std::pair<bool, Vertex> TouchedOVertex;
-        std::vector<TouchedOVertex> new_points(num_unique, TouchedOVertex(false, Vertex()));
-        // ---------------------------------------------------------------------
-        // 5. Spawn a quad from each face point to the corresponding edge points
-        // the original points being the fourth quad points.
-        // ---------------------------------------------------------------------
-        for (size_t t = 0; t < nmesh; ++t) {
-            const aiMesh *const minp = smesh[t];
-            aiMesh *const mout = out[t] = new aiMesh();
-
-            for (unsigned int a = 0; a < minp->mNumFaces; ++a) {
-                mout->mNumFaces += minp->mFaces[a].mNumIndices;
-            }
-
-            // We need random access to the old face buffer, so reuse is not possible.
-            mout->mFaces = new aiFace[mout->mNumFaces];
-
-            mout->mNumVertices = mout->mNumFaces * 4;
-            mout->mVertices = new aiVector3D[mout->mNumVertices];
-
-            // quads only, keep material index
-            mout->mPrimitiveTypes = aiPrimitiveType_POLYGON;
-            mout->mMaterialIndex = minp->mMaterialIndex;
-
-            if (minp->HasNormals()) {
-                mout->mNormals = new aiVector3D[mout->mNumVertices];
+            Vertex ep = CornerVertex(in, c) + CornerVertex(in, NextCorner(in, adj, c)) + facePoints[adj.cornerFace[c]];
+            if (UINT_MAX != other) {
+                ep += facePoints[adj.cornerFace[other]];
             }
+            out.vertices[edgeBase + e] = ep / (static_cast<ai_real>(ref) + ai_real(2.0));
+        }
+    });
 
-            if (minp->HasTangentsAndBitangents()) {
-                mout->mTangents = new aiVector3D[mout->mNumVertices];
-                mout->mBitangents = new aiVector3D[mout->mNumVertices];
+    // ---------------------------------------------------------------------
+    // 3. Normalize the original points
+    // F := average of the centroids of the n faces touching P
+    // R := average of the midpoints of the edges touching P
+    // (F+2R+(n-3)P)/n
+    // ---------------------------------------------------------------------
+    ParallelForBlocks(numPoints, mThreads, [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) {
+            const unsigned int cnt = adj.pointStart[p + 1] - adj.pointStart[p];
+            if (0 == cnt) {
+                // not referenced by any face
+                continue;
             }
 
-            for (unsigned int i = 0; minp->HasTextureCoords(i); ++i) {
-                mout->mTextureCoords[i] = new aiVector3D[mout->mNumVertices];
-                mout->mNumUVComponents[i] = minp->mNumUVComponents[i];
+            const Vertex &org = CornerVertex(in, adj.pointCorners[adj.pointStart[p]]);
+            if (cnt < 3) {
+                out.vertices[p] = org;
+                continue;
             }
 
-            mout->mNumVertices = mout->mNumFaces << 2u;
-            for (unsigned int i = 0, v = 0, n = 0; i < minp->mNumFaces; ++i) {
-
-                const aiFace &face = minp->mFaces[i];
-                for (unsigned int a = 0; a < face.mNumIndices; ++a) {
-
-                    // Get a clean new face.
-                    aiFace &faceOut = mout->mFaces[n++];
-                    faceOut.mIndices = new unsigned int[faceOut.mNumIndices = 4];
-
-                    // Spawn a new quadrilateral (ccw winding) for this original point between:
-                    // a) face centroid
-                    centroids[FLATTEN_FACE_IDX(t, i)].SortBack(mout, faceOut.mIndices[0] = v++);
-
-                    // b) adjacent edge on the left, seen from the centroid
-                    const Edge &e0 = edges[MAKE_EDGE_HASH(maptbl[FLATTEN_VERTEX_IDX(t, face.mIndices[a])],
-                            maptbl[FLATTEN_VERTEX_IDX(t, face.mIndices[a == face.mNumIndices - 1 ? 0 : a + 1])])]; // fixme: replace with mod face.mNumIndices?
-
-                    // c) adjacent edge on the right, seen from the centroid
-                    const Edge &e1 = edges[MAKE_EDGE_HASH(maptbl[FLATTEN_VERTEX_IDX(t, face.mIndices[a])],
-                            maptbl[FLATTEN_VERTEX_IDX(t, face.mIndices[!a ? face.mNumIndices - 1 : a - 1])])]; // fixme: replace with mod face.mNumIndices?
-
-                    e0.edge_point.SortBack(mout, faceOut.mIndices[3] = v++);
-                    e1.edge_point.SortBack(mout, faceOut.mIndices[1] = v++);
-
-                    // d= original point P with distinct index i
-                    // F := 0
-                    // R := 0
-                    // n := 0
-                    // for each face f containing i
-                    //    F := F+ centroid of f
-                    //    R := R+ midpoint of edge of f from i to i+1
-                    //    n := n+1
-                    //
-                    // (F+2R+(n-3)P)/n
-                    const unsigned int org = maptbl[FLATTEN_VERTEX_IDX(t, face.mIndices[a])];
-                    TouchedOVertex &ov = new_points[org];
-
-                    if (!ov.first) {
-                        ov.first = true;
-
-                        const unsigned int *adj;
-                        unsigned int cnt;
-                        GET_ADJACENT_FACES_AND_CNT(org, adj, cnt);
-
-                        if (cnt < 3) {
-                            ov.second = Vertex(minp, face.mIndices[a]);
-                        } else {
-
-                            Vertex F, R;
-                            for (unsigned int o = 0; o < cnt; ++o) {
-                                F += centroids[adj[o]];
-
-                                // adj[0] is a global face index - search the face in the mesh list
-                                const aiMesh *mp = nullptr;
-                                size_t nidx;
-
-                                if (adj[o] < moffsets[0].first) {
-                                    mp = smesh[nidx = 0];
-                                } else {
-                                    for (nidx = 1; nidx <= nmesh; ++nidx) {
-                                        if (nidx == nmesh || moffsets[nidx].first > adj[o]) {
-                                            mp = smesh[--nidx];
-                                            break;
-                                        }
-                                    }
-                                }
-
-                                const aiFace &f = mp->mFaces[adj[o] - moffsets[nidx].first];
-                                bool haveit = false;
-
-                                // find our original point in the face
-                                for (unsigned int m = 0; m < f.mNumIndices; ++m) {
-                                    if (maptbl[FLATTEN_VERTEX_IDX(nidx, f.mIndices[m])] == org) {
-
-                                        // add *both* edges. this way, we can be sure that we add
-                                        // *all* adjacent edges to R. In a closed shape, every
-                                        // edge is added twice - so we simply leave out the
-                                        // factor 2.f in the amove formula and get the right
-                                        // result.
-
-                                        const Edge &c0 = edges[MAKE_EDGE_HASH(org, maptbl[FLATTEN_VERTEX_IDX(
-                                                                                           nidx, f.mIndices[!m ? f.mNumIndices - 1 : m - 1])])];
-                                        // fixme: replace with mod face.mNumIndices?
-
-                                        const Edge &c1 = edges[MAKE_EDGE_HASH(org, maptbl[FLATTEN_VERTEX_IDX(
-                                                                                           nidx, f.mIndices[m == f.mNumIndices - 1 ? 0 : m + 1])])];
-                                        // fixme: replace with mod face.mNumIndices?
-                                        R += c0.midpoint + c1.midpoint;
-
-                                        haveit = true;
-                                        break;
-                                    }
-                                }
-                            }
-
-                            const float div = static_cast<float>(cnt), divsq = 1.f / (div * div);
-                            ov.second = Vertex(minp, face.mIndices[a]) * ((div - 3.f) / div) + R * divsq + F * divsq;
-                        }
-                    }
-                    ov.second.SortBack(mout, faceOut.mIndices[2] = v++);
+            // add *both* edges of every face. this way, we can be sure that we add
+            // *all* adjacent edges to R. In a closed shape, every edge is added
+            // twice - so we simply leave out the factor 2 in the above formula.
+            // A face touching P more than once adds the edges at its first corner
+            // on P each time.
+            Vertex F, R;
+            for (unsigned int k = adj.pointStart[p]; k < adj.pointStart[p + 1]; ++k) {
+                const unsigned int f = adj.cornerFace[adj.pointCorners[k]];
+                unsigned int c = in.faceStart[f];
+                while (in.corners[c] != p) {
+                    ++c;
                 }
+                F += facePoints[f];
+                R += midpoint(adj.cornerEdge[PrevCorner(in, adj, c)]);
+                R += midpoint(adj.cornerEdge[c]);
             }
+
+            const ai_real div = static_cast<ai_real>(cnt), divsq = ai_real(1.0) / (div * div);
+            out.vertices[p] = org * ((div - ai_real(3.0)) / div) + R * divsq + F * divsq;
         }
-    } // end of scope for edges, freeing its memory
+    });
 
     // ---------------------------------------------------------------------
-    // 7. Apply the next subdivision step.
+    // 4. Spawn a quad from each face point to the corresponding edge points,
+    // the moved original point being the third quad point.
     // ---------------------------------------------------------------------
-    if (num != 1) {
-        std::vector<aiMesh *> tmp(nmesh);
-        InternSubdivide(out, nmesh, &tmp.front(), num - 1);
-        for (size_t i = 0; i < nmesh; ++i) {
-            delete out[i];
-            out[i] = tmp[i];
+    out.corners.resize(static_cast<size_t>(numCorners) * 4);
+    out.faceStart.resize(static_cast<size_t>(numCorners) + 1);
+    ParallelForBlocks(numCorners, mThreads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const unsigned int c = static_cast<unsigned int>(i);
+            unsigned int *quad = &out.corners[i * 4];
+            quad[0] = faceBase + adj.cornerFace[c];
+            quad[1] = edgeBase + adj.cornerEdge[PrevCorner(in, adj, c)];
+            quad[2] = in.corners[c];
+            quad[3] = edgeBase + adj.cornerEdge[c];
+            out.faceStart[i] = c * 4;
+        }
+    });
+    out.faceStart[numCorners] = numCorners * 4;
+
+    // the quads follow the corners of the coarse faces, so every mesh stays contiguous
+    out.meshFaces.resize(in.meshFaces.size());
+    for (size_t t = 0; t < in.meshFaces.size(); ++t) {
+        out.meshFaces[t] = in.faceStart[in.meshFaces[t]];
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Refines the meshes num times and converts the last level back to meshes. The output meshes
+// consist of quads in verbose format.
+// ------------------------------------------------------------------------------------------------
+void CatmullClarkSubdivider::InternSubdivide(
+        const aiMesh *const *smesh,
+        size_t nmesh,
+        aiMesh **out,
+        unsigned int num) {
+
+    // no subdivision requested
+    if (!num) {
+        return;
+    }
+
+    // intermediate levels only live in the two ping-pong buffers
+    Level coarse, fine;
+    Adjacency adj;
+    BuildLevel(smesh, nmesh, coarse);
+    for (unsigned int i = 0; i < num; ++i) {
+        BuildAdjacency(coarse, adj);
+        RefineLevel(coarse, adj, fine);
+        std::swap(coarse, fine);
+    }
+
+    // allocate the output meshes, the attribute layout follows the input meshes
+    for (size_t t = 0; t < nmesh; ++t) {
+        const aiMesh *const minp = smesh[t];
+        aiMesh *const mout = out[t] = new aiMesh();
+
+        // quads only, keep material index
+        mout->mNumFaces = coarse.meshFaces[t + 1] - coarse.meshFaces[t];
+        mout->mFaces = new aiFace[mout->mNumFaces];
+        mout->mNumVertices = mout->mNumFaces << 2u;
+        mout->mVertices = new aiVector3D[mout->mNumVertices];
+        mout->mPrimitiveTypes = aiPrimitiveType_POLYGON;
+        mout->mMaterialIndex = minp->mMaterialIndex;
+
+        if (minp->HasNormals()) {
+            mout->mNormals = new aiVector3D[mout->mNumVertices];
+        }
+
+        if (minp->HasTangentsAndBitangents()) {
+            mout->mTangents = new aiVector3D[mout->mNumVertices];
+            mout->mBitangents = new aiVector3D[mout->mNumVertices];
+        }
+
+        for (unsigned int i = 0; minp->HasTextureCoords(i); ++i) {
+            mout->mTextureCoords[i] = new aiVector3D[mout->mNumVertices];
+            mout->mNumUVComponents[i] = minp->mNumUVComponents[i];
         }
     }
+
+    // write the quads of all meshes, a block of faces may span several meshes
+    const size_t numFaces = coarse.faceStart.size() - 1;
+    ParallelForBlocks(numFaces, mThreads, [&](size_t begin, size_t end) {
+        size_t t = std::upper_bound(coarse.meshFaces.begin(), coarse.meshFaces.end(), begin) - coarse.meshFaces.begin() - 1;
+        for (size_t f = begin; f < end; ++f) {
+            while (f >= coarse.meshFaces[t + 1]) {
+                ++t;
+            }
+            aiMesh *const mout = out[t];
+            const unsigned int n = static_cast<unsigned int>(f - coarse.meshFaces[t]);
+            const unsigned int k = coarse.faceStart[f];
+            const unsigned int v = n * 4;
+
+            // vertices are written as centroid, right edge, left edge, original point
+            aiFace &face = mout->mFaces[n];
+            face.mIndices = new unsigned int[face.mNumIndices = 4];
+            face.mIndices[0] = v;
+            face.mIndices[1] = v + 2;
+            face.mIndices[2] = v + 3;
+            face.mIndices[3] = v + 1;
+            CornerVertex(coarse, k).SortBack(mout, v);
+            CornerVertex(coarse, k + 3).SortBack(mout, v + 1);
+            CornerVertex(coarse, k + 1).SortBack(mout, v + 2);
+            CornerVertex(coarse, k + 2).SortBack(mout, v + 3);
+        }
+    });
 }
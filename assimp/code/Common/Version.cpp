@@ -42,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Actually just a dummy, used by the compiler to build the pre-compiled header.
 
 #include "ScenePrivate.h"
+#include <assimp/SceneCombiner.h>
 #include <assimp/scene.h>
 
 #include "revision.h"
@@ -133,6 +134,9 @@ aiScene::aiScene() :
 
 // ------------------------------------------------------------------------------------------------
 aiScene::~aiScene() {
+    // arrays shared with other scenes are freed by the last scene using them
+    Assimp::SceneCombiner::ReleaseSharedArrays(this);
+
     // delete all sub-objects recursively
     delete mRootNode;
 
@@ -53,6 +53,17 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 using namespace Assimp;
 
+// ------------------------------------------------------------------------------------------------
+// Hash of a property as used by the property index, FNV-1a over the key, type and index
+static uint32_t ComputePropertyHash(const char *pKey, unsigned int type, unsigned int index) {
+    uint32_t hash = 2166136261u;
+    for (; *pKey; ++pKey) {
+        hash = (hash ^ static_cast<unsigned char>(*pKey)) * 16777619u;
+    }
+    hash = (hash ^ type) * 16777619u;
+    return (hash ^ index) * 16777619u;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Get a specific property from a material
 aiReturn aiGetMaterialProperty(const aiMaterial *pMat,
@@ -61,10 +72,31 @@ aiReturn aiGetMaterialProperty(const aiMaterial *pMat,
         unsigned int index,
         const aiMaterialProperty **pPropOut) {
 
+    // Use the property index if there is one and no wild-card is given. The property list
+    // is public and may have been edited without dropping the index, so every entry is
+    // checked against the current list and misses fall back to the linear search.
+    if (nullptr != pMat->mPropertyIndex && UINT_MAX != type && UINT_MAX != index) {
+        const uint32_t hash = ComputePropertyHash(pKey, type, index);
+        const unsigned int mask = pMat->mNumPropertyIndexSlots - 1;
+        for (unsigned int slot = hash & mask;; slot = (slot + 1) & mask) {
+            const unsigned int *entry = pMat->mPropertyIndex + slot * 2;
+            if (0 == entry[1]) {
+                break;
+            }
+            if (entry[0] != hash || entry[1] - 1 >= pMat->mNumProperties) {
+                continue;
+            }
+            aiMaterialProperty *prop = pMat->mProperties[entry[1] - 1];
+            if (prop && 0 == strcmp(prop->mKey.data, pKey) && prop->mSemantic == type && prop->mIndex == index) {
+                *pPropOut = prop;
+                return AI_SUCCESS;
+            }
+        }
+    }
+
     /*  Just search for a property with exactly this name ..
-     *  could be improved by hashing, but it's possibly
-     *  no worth the effort (we're bound to C structures,
-     *  thus std::map or derivates are not applicable. */
+     *  BuildPropertyIndex() allows faster lookups, but the index
+     *  can't serve wild-cards. */
     for (unsigned int i = 0; i < pMat->mNumProperties; ++i) {
         aiMaterialProperty *prop = pMat->mProperties[i];
 
@@ -360,10 +392,17 @@ aiReturn aiGetMaterialTexture(const aiMaterial *mat,
 
 static const unsigned int DefaultNumAllocated = 5;
 
+// Materials with fewer properties are faster to scan than to hash
+static const unsigned int MinIndexedProperties = 8;
+
 // ------------------------------------------------------------------------------------------------
 // Construction. Actually the one and only way to get an aiMaterial instance
 aiMaterial::aiMaterial() :
-        mProperties(nullptr), mNumProperties(0), mNumAllocated(DefaultNumAllocated) {
+        mProperties(nullptr),
+        mNumProperties(0),
+        mNumAllocated(DefaultNumAllocated),
+        mPropertyIndex(nullptr),
+        mNumPropertyIndexSlots(0) {
     // Allocate 5 entries by default
     mProperties = new aiMaterialProperty *[DefaultNumAllocated];
 }
@@ -375,6 +414,52 @@ aiMaterial::~aiMaterial() {
     delete[] mProperties;
 }
 
+// ------------------------------------------------------------------------------------------------
+void aiMaterial::BuildPropertyIndex() {
+    ClearPropertyIndex();
+    if (mNumProperties < MinIndexedProperties) {
+        return;
+    }
+
+    // keep the table at most half full
+    unsigned int numSlots = 16;
+    while (numSlots < mNumProperties * 2) {
+        numSlots *= 2;
+    }
+    unsigned int *table = new unsigned int[numSlots * 2]();
+    const unsigned int mask = numSlots - 1;
+    for (unsigned int i = 0; i < mNumProperties; ++i) {
+        const aiMaterialProperty *prop = mProperties[i];
+        if (nullptr == prop) {
+            continue;
+        }
+
+        // the first of several equal properties wins, just like in the linear search
+        const uint32_t hash = ComputePropertyHash(prop->mKey.data, prop->mSemantic, prop->mIndex);
+        unsigned int slot = hash & mask;
+        for (; 0 != table[slot * 2 + 1]; slot = (slot + 1) & mask) {
+            const aiMaterialProperty *other = mProperties[table[slot * 2 + 1] - 1];
+            if (table[slot * 2] == hash && other->mKey == prop->mKey &&
+                    other->mSemantic == prop->mSemantic && other->mIndex == prop->mIndex) {
+                break;
+            }
+        }
+        if (0 == table[slot * 2 + 1]) {
+            table[slot * 2] = hash;
+            table[slot * 2 + 1] = i + 1;
+        }
+    }
+    mPropertyIndex = table;
+    mNumPropertyIndexSlots = numSlots;
+}
+
+// ------------------------------------------------------------------------------------------------
+void aiMaterial::ClearPropertyIndex() {
+    delete[] mPropertyIndex;
+    mPropertyIndex = nullptr;
+    mNumPropertyIndexSlots = 0;
+}
+
 // ------------------------------------------------------------------------------------------------
 aiString aiMaterial::GetName() const {
     aiString name;
@@ -385,6 +470,7 @@ aiString aiMaterial::GetName() const {
 
 // ------------------------------------------------------------------------------------------------
 void aiMaterial::Clear() {
+    ClearPropertyIndex();
     for (unsigned int i = 0; i < mNumProperties; ++i) {
         // delete this entry
         delete mProperties[i];
@@ -397,6 +483,7 @@ void aiMaterial::Clear() {
 
 // ------------------------------------------------------------------------------------------------
 aiReturn aiMaterial::RemoveProperty(const char *pKey, unsigned int type, unsigned int index) {
+    ClearPropertyIndex();
 
     for (unsigned int i = 0; i < mNumProperties; ++i) {
         aiMaterialProperty *prop = mProperties[i];
@@ -429,6 +516,7 @@ aiReturn aiMaterial::AddBinaryProperty(const void *pInput,
     if (0 == pSizeInBytes) {
         return AI_FAILURE;
     }
+    ClearPropertyIndex();
 
     // first search the list whether there is already an entry with this key
     unsigned int iOutIndex(UINT_MAX);
@@ -526,6 +614,7 @@ uint32_t Assimp::ComputeMaterialHash(const aiMaterial *mat, bool includeMatName
 // ------------------------------------------------------------------------------------------------
 void aiMaterial::CopyPropertyList(aiMaterial *const pcDest,
         const aiMaterial *pcSrc) {
+    pcDest->ClearPropertyIndex();
 
     const unsigned int iOldNum = pcDest->mNumProperties;
     pcDest->mNumAllocated += pcSrc->mNumAllocated;
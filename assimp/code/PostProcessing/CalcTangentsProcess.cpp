@@ -87,6 +87,18 @@ void CalcTangentsProcess::Execute(aiScene *pScene) {
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// The step processes each mesh on its own
+bool CalcTangentsProcess::IsPerMeshStep() const {
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on a single mesh
+void CalcTangentsProcess::ExecutePerMesh(aiScene *pScene, unsigned int meshIndex) {
+    ProcessMesh(pScene->mMeshes[meshIndex], meshIndex);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Calculates tangents and bi-tangents for the given mesh
 bool CalcTangentsProcess::ProcessMesh(aiMesh *pMesh, unsigned int meshIndex) {
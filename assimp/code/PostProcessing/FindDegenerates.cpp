@@ -84,18 +84,39 @@ void FindDegeneratesProcess::Execute( aiScene* pScene) {
         return;
     }
 
+    for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
+        ExecutePerMesh(pScene, i);
+    }
+    FinishPerMesh(pScene);
+}
+
+// ------------------------------------------------------------------------------------------------
+// The step processes each mesh on its own
+bool FindDegeneratesProcess::IsPerMeshStep() const {
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on a single mesh
+void FindDegeneratesProcess::ExecutePerMesh( aiScene* pScene, unsigned int meshIndex) {
+    // Do not process point cloud, ExecuteOnMesh works only with faces data
+    aiMesh* mesh = pScene->mMeshes[meshIndex];
+    if ((mesh->mPrimitiveTypes != aiPrimitiveType::aiPrimitiveType_POINT) && ExecuteOnMesh(mesh)) {
+        delete mesh;
+        pScene->mMeshes[meshIndex] = nullptr;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Removes the meshes deleted by ExecutePerMesh() and updates the scene graph
+void FindDegeneratesProcess::FinishPerMesh( aiScene* pScene) {
     std::unordered_map<unsigned int, unsigned int> meshMap;
     meshMap.reserve(pScene->mNumMeshes);
 
     const unsigned int originalNumMeshes = pScene->mNumMeshes;
     unsigned int targetIndex = 0;
     for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
-        // Do not process point cloud, ExecuteOnMesh works only with faces data
-        if ((pScene->mMeshes[i]->mPrimitiveTypes != aiPrimitiveType::aiPrimitiveType_POINT) && ExecuteOnMesh(pScene->mMeshes[i])) {
-            delete pScene->mMeshes[i];
-            // Not strictly required, but clean:
-            pScene->mMeshes[i] = nullptr;
-        } else {
+        if (pScene->mMeshes[i] != nullptr) {
             meshMap[i] = targetIndex;
             pScene->mMeshes[targetIndex] = pScene->mMeshes[i];
             ++targetIndex;
@@ -69,6 +69,18 @@ public:
     // Execute step on a given scene
     void Execute( aiScene* pScene) override;
 
+    // -------------------------------------------------------------------
+    // The step processes each mesh on its own
+    bool IsPerMeshStep() const override;
+
+    // -------------------------------------------------------------------
+    // Execute step on a given mesh of the scene, deletes the mesh if required
+    void ExecutePerMesh( aiScene* pScene, unsigned int meshIndex) override;
+
+    // -------------------------------------------------------------------
+    // Remove the deleted meshes from the scene
+    void FinishPerMesh( aiScene* pScene) override;
+
     // -------------------------------------------------------------------
     // Setup import settings
     void SetupProperties(const Importer* pImp) override;
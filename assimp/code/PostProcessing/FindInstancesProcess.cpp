@@ -47,10 +47,28 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include "FindInstancesProcess.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
 #include <memory>
+#include <unordered_map>
 
 using namespace Assimp;
 
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Meshes kept so far which share the same pseudo hash, sorted by the x coordinate of their first
+// vertex. Meshes without a finite first vertex are kept apart and always compared.
+struct InstanceBucket {
+    typedef std::multimap<ai_real, unsigned int> KeyMap;
+    KeyMap sorted;
+    std::vector<unsigned int> unsorted;
+};
+
+} // namespace
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 FindInstancesProcess::FindInstancesProcess()
@@ -109,6 +127,40 @@ void UpdateMeshIndices(aiNode* node, unsigned int* lookup)
         UpdateMeshIndices(node->mChildren[n],lookup);
 }
 
+// ------------------------------------------------------------------------------------------------
+// Get the x coordinate of the first vertex of a mesh, false if it has none or it is not finite
+static bool GetCandidateKey(const aiMesh* mesh, ai_real& key)
+{
+    if (!mesh->HasPositions()) {
+        return false;
+    }
+    key = mesh->mVertices[0].x;
+    return std::isfinite(key);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Collect the meshes of a bucket which may be equal to the given one, highest index first
+static void CollectCandidates(const InstanceBucket& bucket, const aiMesh* inst, ai_real range,
+        std::vector<unsigned int>& candidates)
+{
+    candidates.assign(bucket.unsorted.begin(), bucket.unsorted.end());
+
+    // the positions of equal meshes differ by less than the epsilon, so do their first x coordinates
+    ai_real key;
+    if (GetCandidateKey(inst, key) && std::isfinite(range)) {
+        InstanceBucket::KeyMap::const_iterator it = bucket.sorted.lower_bound(key - range);
+        const InstanceBucket::KeyMap::const_iterator end = bucket.sorted.upper_bound(key + range);
+        for (; it != end; ++it) {
+            candidates.push_back(it->second);
+        }
+    } else {
+        for (const InstanceBucket::KeyMap::value_type& entry : bucket.sorted) {
+            candidates.push_back(entry.second);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), std::greater<unsigned int>());
+}
+
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 void FindInstancesProcess::Execute( aiScene* pScene)
@@ -120,116 +172,120 @@ void FindInstancesProcess::Execute( aiScene* pScene)
         // in the pipeline, so we could, depending on the file format,
         // have several thousand small meshes. That's too much for a brute
         // everyone-against-everyone check involving up to 10 comparisons
-        // each.
-        std::unique_ptr<uint64_t[]> hashes (new uint64_t[pScene->mNumMeshes]);
+        // each. The meshes we keep are collected in one bucket per hash.
+        std::unordered_map<uint64_t, InstanceBucket> buckets;
         std::unique_ptr<unsigned int[]> remapping (new unsigned int[pScene->mNumMeshes]);
+        std::vector<unsigned int> candidates;
 
         unsigned int numMeshesOut = 0;
         for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
 
             aiMesh* inst = pScene->mMeshes[i];
-            hashes[i] = GetMeshHash(inst);
+            InstanceBucket& bucket = buckets[GetMeshHash(inst)];
 
             // Find an appropriate epsilon
             // to compare position differences against
             float epsilon = ComputePositionEpsilon(inst);
+            CollectCandidates(bucket, inst, epsilon * 1.01f, candidates);
             epsilon *= epsilon;
 
-            for (int a = i-1; a >= 0; --a) {
-                if (hashes[i] == hashes[a])
-                {
-                    aiMesh* orig = pScene->mMeshes[a];
-                    if (!orig)
+            for (unsigned int a : candidates) {
+                aiMesh* orig = pScene->mMeshes[a];
+
+                // check for hash collision .. we needn't check
+                // the vertex format, it *must* match due to the
+                // (brilliant) construction of the hash
+                if (orig->mNumBones       != inst->mNumBones      ||
+                    orig->mNumFaces       != inst->mNumFaces      ||
+                    orig->mNumVertices    != inst->mNumVertices   ||
+                    orig->mMaterialIndex  != inst->mMaterialIndex ||
+                    orig->mPrimitiveTypes != inst->mPrimitiveTypes)
+                    continue;
+
+                // up to now the meshes are equal. Now compare vertex positions, normals,
+                // tangents and bitangents using this epsilon.
+                if (orig->HasPositions()) {
+                    if(!CompareArrays(orig->mVertices,inst->mVertices,orig->mNumVertices,epsilon))
                         continue;
-
-                    // check for hash collision .. we needn't check
-                    // the vertex format, it *must* match due to the
-                    // (brilliant) construction of the hash
-                    if (orig->mNumBones       != inst->mNumBones      ||
-                        orig->mNumFaces       != inst->mNumFaces      ||
-                        orig->mNumVertices    != inst->mNumVertices   ||
-                        orig->mMaterialIndex  != inst->mMaterialIndex ||
-                        orig->mPrimitiveTypes != inst->mPrimitiveTypes)
+                }
+                if (orig->HasNormals()) {
+                    if(!CompareArrays(orig->mNormals,inst->mNormals,orig->mNumVertices,epsilon))
+                        continue;
+                }
+                if (orig->HasTangentsAndBitangents()) {
+                    if (!CompareArrays(orig->mTangents,inst->mTangents,orig->mNumVertices,epsilon) ||
+                        !CompareArrays(orig->mBitangents,inst->mBitangents,orig->mNumVertices,epsilon))
                         continue;
+                }
 
-                    // up to now the meshes are equal. Now compare vertex positions, normals,
-                    // tangents and bitangents using this epsilon.
-                    if (orig->HasPositions()) {
-                        if(!CompareArrays(orig->mVertices,inst->mVertices,orig->mNumVertices,epsilon))
-                            continue;
-                    }
-                    if (orig->HasNormals()) {
-                        if(!CompareArrays(orig->mNormals,inst->mNormals,orig->mNumVertices,epsilon))
-                            continue;
-                    }
-                    if (orig->HasTangentsAndBitangents()) {
-                        if (!CompareArrays(orig->mTangents,inst->mTangents,orig->mNumVertices,epsilon) ||
-                            !CompareArrays(orig->mBitangents,inst->mBitangents,orig->mNumVertices,epsilon))
+                // use a constant epsilon for colors and UV coordinates
+                static const float uvEpsilon = 10e-4f;
+                {
+                    unsigned int j, end = orig->GetNumUVChannels();
+                    for(j = 0; j < end; ++j) {
+                        if (!orig->mTextureCoords[j]) {
                             continue;
-                    }
-
-                    // use a constant epsilon for colors and UV coordinates
-                    static const float uvEpsilon = 10e-4f;
-                    {
-                        unsigned int j, end = orig->GetNumUVChannels();
-                        for(j = 0; j < end; ++j) {
-                            if (!orig->mTextureCoords[j]) {
-                                continue;
-                            }
-                            if(!CompareArrays(orig->mTextureCoords[j],inst->mTextureCoords[j],orig->mNumVertices,uvEpsilon)) {
-                                break;
-                            }
                         }
-                        if (j != end) {
-                            continue;
+                        if(!CompareArrays(orig->mTextureCoords[j],inst->mTextureCoords[j],orig->mNumVertices,uvEpsilon)) {
+                            break;
                         }
                     }
+                    if (j != end) {
+                        continue;
+                    }
+                }
 
-                    // These two checks are actually quite expensive and almost *never* required.
-                    // Almost. That's why they're still here. But there's no reason to do them
-                    // in speed-targeted imports.
-                    if (!configSpeedFlag) {
-
-                        // It seems to be strange, but we really need to check whether the
-                        // bones are identical too. Although it's extremely unprobable
-                        // that they're not if control reaches here, we need to deal
-                        // with unprobable cases, too. It could still be that there are
-                        // equal shapes which are deformed differently.
-                        if (!CompareBones(orig,inst))
-                            continue;
+                // These two checks are actually quite expensive and almost *never* required.
+                // Almost. That's why they're still here. But there's no reason to do them
+                // in speed-targeted imports.
+                if (!configSpeedFlag) {
+
+                    // It seems to be strange, but we really need to check whether the
+                    // bones are identical too. Although it's extremely unprobable
+                    // that they're not if control reaches here, we need to deal
+                    // with unprobable cases, too. It could still be that there are
+                    // equal shapes which are deformed differently.
+                    if (!CompareBones(orig,inst))
+                        continue;
 
-                        // For completeness ... compare even the index buffers for equality
-                        // face order & winding order doesn't care. Input data is in verbose format.
-                        std::unique_ptr<unsigned int[]> ftbl_orig(new unsigned int[orig->mNumVertices]);
-                        std::unique_ptr<unsigned int[]> ftbl_inst(new unsigned int[orig->mNumVertices]);
+                    // For completeness ... compare even the index buffers for equality
+                    // face order & winding order doesn't care. Input data is in verbose format.
+                    std::unique_ptr<unsigned int[]> ftbl_orig(new unsigned int[orig->mNumVertices]);
+                    std::unique_ptr<unsigned int[]> ftbl_inst(new unsigned int[orig->mNumVertices]);
 
-                        for (unsigned int tt = 0; tt < orig->mNumFaces;++tt) {
-                            aiFace& f = orig->mFaces[tt];
-                            for (unsigned int nn = 0; nn < f.mNumIndices;++nn)
-                                ftbl_orig[f.mIndices[nn]] = tt;
+                    for (unsigned int tt = 0; tt < orig->mNumFaces;++tt) {
+                        aiFace& f = orig->mFaces[tt];
+                        for (unsigned int nn = 0; nn < f.mNumIndices;++nn)
+                            ftbl_orig[f.mIndices[nn]] = tt;
 
-                            aiFace& f2 = inst->mFaces[tt];
-                            for (unsigned int nn = 0; nn < f2.mNumIndices;++nn)
-                                ftbl_inst[f2.mIndices[nn]] = tt;
-                        }
-                        if (0 != ::memcmp(ftbl_inst.get(),ftbl_orig.get(),orig->mNumVertices*sizeof(unsigned int)))
-                            continue;
+                        aiFace& f2 = inst->mFaces[tt];
+                        for (unsigned int nn = 0; nn < f2.mNumIndices;++nn)
+                            ftbl_inst[f2.mIndices[nn]] = tt;
                     }
+                    if (0 != ::memcmp(ftbl_inst.get(),ftbl_orig.get(),orig->mNumVertices*sizeof(unsigned int)))
+                        continue;
+                }
 
-                    // We're still here. Or in other words: 'inst' is an instance of 'orig'.
-                    // Place a marker in our list that we can easily update mesh indices.
-                    remapping[i] = remapping[a];
+                // We're still here. Or in other words: 'inst' is an instance of 'orig'.
+                // Place a marker in our list that we can easily update mesh indices.
+                remapping[i] = remapping[a];
 
-                    // Delete the instanced mesh, we don't need it anymore
-                    delete inst;
-                    pScene->mMeshes[i] = nullptr;
-                    break;
-                }
+                // Delete the instanced mesh, we don't need it anymore
+                delete inst;
+                pScene->mMeshes[i] = nullptr;
+                break;
             }
 
             // If we didn't find a match for the current mesh: keep it
             if (pScene->mMeshes[i]) {
                 remapping[i] = numMeshesOut++;
+
+                ai_real key;
+                if (GetCandidateKey(inst, key)) {
+                    bucket.sorted.insert(InstanceBucket::KeyMap::value_type(key, i));
+                } else {
+                    bucket.unsorted.push_back(i);
+                }
             }
         }
         if (numMeshesOut != pScene->mNumMeshes) {
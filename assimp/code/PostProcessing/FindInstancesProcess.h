@@ -49,6 +49,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Common/BaseProcess.h"
 #include "PostProcessing/ProcessHelper.h"
 
+#include <algorithm>
+
 class FindInstancesProcessTest;
 
 namespace Assimp {
@@ -84,8 +86,15 @@ inline uint64_t GetMeshHash(aiMesh* in) {
  */
 inline bool CompareArrays(const aiVector3D* first, const aiVector3D* second,
         unsigned int size, float e) {
-    for (const aiVector3D* end = first+size; first != end; ++first,++second) {
-        if ( (*first - *second).SquareLength() >= e)
+    // no early out within a block of elements, so the compiler can vectorize the inner loop
+    static const unsigned int BlockSize = 64;
+    for (unsigned int i = 0; i < size; i += BlockSize) {
+        const unsigned int end = std::min(size, i + BlockSize);
+        bool differ = false;
+        for (unsigned int n = i; n < end; ++n) {
+            differ |= (first[n] - second[n]).SquareLength() >= e;
+        }
+        if (differ)
             return false;
     }
     return true;
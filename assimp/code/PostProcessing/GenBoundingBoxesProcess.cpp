@@ -43,15 +43,126 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "PostProcessing/GenBoundingBoxesProcess.h"
 
+#include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 namespace Assimp {
 
+namespace {
+
+static const unsigned int NoIndex = ~0u;
+
+// local indices are stored in 8 bits
+static const unsigned int MaxMeshletVertices = 256;
+static const unsigned int MaxMeshletTriangles = 512;
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the mesh consists of valid triangles only
+bool IsTriangleMesh(const aiMesh *mesh) {
+    if (!mesh->HasPositions() || !mesh->HasFaces()) {
+        return false;
+    }
+    for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+        const aiFace &face = mesh->mFaces[f];
+        if (face.mNumIndices != 3) {
+            return false;
+        }
+        for (unsigned int i = 0; i < 3; ++i) {
+            if (face.mIndices[i] >= mesh->mNumVertices) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Computes the bounding sphere and the normal cone of a finished meshlet
+void ComputeMeshletBounds(const aiMesh *mesh, const std::vector<unsigned int> &vertices,
+        const std::vector<unsigned char> &triangles, aiMeshlet &meshlet) {
+    const unsigned int *localVertices = &vertices[meshlet.mVertexOffset];
+    const unsigned char *localTriangles = &triangles[meshlet.mTriangleOffset * 3];
+
+    aiVector3D min = mesh->mVertices[localVertices[0]], max = min;
+    for (unsigned int i = 1; i < meshlet.mVertexCount; ++i) {
+        const aiVector3D &p = mesh->mVertices[localVertices[i]];
+        min = aiVector3D(std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z));
+        max = aiVector3D(std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z));
+    }
+    meshlet.mCenter = (min + max) * ai_real(0.5);
+    meshlet.mRadius = 0;
+    for (unsigned int i = 0; i < meshlet.mVertexCount; ++i) {
+        meshlet.mRadius = std::max(meshlet.mRadius, (mesh->mVertices[localVertices[i]] - meshlet.mCenter).Length());
+    }
+
+    // the cone axis is the average direction of the triangles
+    std::vector<aiVector3D> normals(meshlet.mTriangleCount);
+    aiVector3D axis;
+    for (unsigned int t = 0; t < meshlet.mTriangleCount; ++t) {
+        const aiVector3D &p0 = mesh->mVertices[localVertices[localTriangles[t * 3]]];
+        const aiVector3D &p1 = mesh->mVertices[localVertices[localTriangles[t * 3 + 1]]];
+        const aiVector3D &p2 = mesh->mVertices[localVertices[localTriangles[t * 3 + 2]]];
+        normals[t] = ((p1 - p0) ^ (p2 - p0)).NormalizeSafe();
+        axis += normals[t];
+    }
+    meshlet.mConeApex = meshlet.mCenter;
+    meshlet.mConeAxis = aiVector3D();
+    meshlet.mConeCutoff = 1;
+    const ai_real axisLength = axis.Length();
+    if (!(axisLength > 0)) {
+        return;
+    }
+    axis /= axisLength;
+
+    ai_real minDot = 1;
+    for (const aiVector3D &normal : normals) {
+        if (normal.SquareLength() > 0) {
+            minDot = std::min(minDot, normal * axis);
+        }
+    }
+    // triangles facing wildly different directions are hardly ever all back-facing
+    if (minDot <= ai_real(0.1)) {
+        return;
+    }
+
+    // move the apex back along the axis until all triangle planes lie in front of it
+    ai_real maxDistance = 0;
+    for (unsigned int t = 0; t < meshlet.mTriangleCount; ++t) {
+        const aiVector3D &normal = normals[t];
+        if (normal.SquareLength() > 0) {
+            const aiVector3D &p0 = mesh->mVertices[localVertices[localTriangles[t * 3]]];
+            maxDistance = std::max(maxDistance, ((meshlet.mCenter - p0) * normal) / (axis * normal));
+        }
+    }
+    meshlet.mConeApex = meshlet.mCenter - axis * maxDistance;
+    meshlet.mConeAxis = axis;
+    meshlet.mConeCutoff = std::sqrt(1 - minDot * minDot);
+}
+
+} // namespace
+
+GenBoundingBoxesProcess::GenBoundingBoxesProcess() :
+        mGenMeshlets(false), mMaxVertices(AI_MESHLET_DEFAULT_MAX_VERTICES), mMaxTriangles(AI_MESHLET_DEFAULT_MAX_TRIANGLES) {
+    // empty
+}
+
 bool GenBoundingBoxesProcess::IsActive(unsigned int pFlags) const {
     return 0 != ( pFlags & aiProcess_GenBoundingBoxes );
 }
 
+void GenBoundingBoxesProcess::SetupProperties(const Importer *pImp) {
+    mGenMeshlets = pImp->GetPropertyBool(AI_CONFIG_PP_GBB_MESHLETS, false);
+    const int maxVertices = pImp->GetPropertyInteger(AI_CONFIG_PP_GBB_MESHLET_MAX_VERTICES, AI_MESHLET_DEFAULT_MAX_VERTICES);
+    mMaxVertices = static_cast<unsigned int>(std::min(std::max(maxVertices, 3), static_cast<int>(MaxMeshletVertices)));
+    const int maxTriangles = pImp->GetPropertyInteger(AI_CONFIG_PP_GBB_MESHLET_MAX_TRIANGLES, AI_MESHLET_DEFAULT_MAX_TRIANGLES);
+    mMaxTriangles = static_cast<unsigned int>(std::min(std::max(maxTriangles, 1), static_cast<int>(MaxMeshletTriangles)));
+}
+
 void checkMesh(aiMesh* mesh, aiVector3D& min, aiVector3D& max) {
 
     if (0 == mesh->mNumVertices) {
@@ -88,16 +199,151 @@ void GenBoundingBoxesProcess::Execute(aiScene* pScene) {
     }
 
     for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
-        aiMesh* mesh = pScene->mMeshes[i];
-        if (nullptr == mesh) {
-            continue;
+        ExecutePerMesh(pScene, i);
+    }
+}
+
+bool GenBoundingBoxesProcess::IsPerMeshStep() const {
+    return true;
+}
+
+void GenBoundingBoxesProcess::ExecutePerMesh(aiScene* pScene, unsigned int meshIndex) {
+    aiMesh* mesh = pScene->mMeshes[meshIndex];
+    if (nullptr == mesh) {
+        return;
+    }
+
+    aiVector3D min(999999, 999999, 999999), max(-999999, -999999, -999999);
+    checkMesh(mesh, min, max);
+    mesh->mAABB.mMin = min;
+    mesh->mAABB.mMax = max;
+
+    if (mGenMeshlets) {
+        GenerateMeshlets(mesh);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Splits a single mesh into meshlets
+void GenBoundingBoxesProcess::GenerateMeshlets(aiMesh *pMesh) const {
+    // meshlets of an earlier run refer to the faces as they were back then,
+    // they are dropped even if the mesh is no triangle mesh anymore
+    delete[] pMesh->mMeshlets;
+    delete[] pMesh->mMeshletVertices;
+    delete[] pMesh->mMeshletTriangles;
+    pMesh->mMeshlets = nullptr;
+    pMesh->mMeshletVertices = nullptr;
+    pMesh->mMeshletTriangles = nullptr;
+    pMesh->mNumMeshlets = pMesh->mNumMeshletVertices = pMesh->mNumMeshletTriangles = 0;
+
+    if (!IsTriangleMesh(pMesh)) {
+        return;
+    }
+
+    // triangles using each vertex, the ones not yet in a meshlet are kept at the front
+    const unsigned int numVertices = pMesh->mNumVertices;
+    const unsigned int numTriangles = pMesh->mNumFaces;
+    std::vector<unsigned int> numLive(numVertices, 0);
+    for (unsigned int t = 0; t < numTriangles; ++t) {
+        for (unsigned int k = 0; k < 3; ++k) {
+            ++numLive[pMesh->mFaces[t].mIndices[k]];
         }
+    }
+    std::vector<unsigned int> offsets(numVertices + 1, 0);
+    for (unsigned int v = 0; v < numVertices; ++v) {
+        offsets[v + 1] = offsets[v] + numLive[v];
+    }
+    std::vector<unsigned int> adjacency(numTriangles * 3);
+    {
+        std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+        for (unsigned int t = 0; t < numTriangles; ++t) {
+            for (unsigned int k = 0; k < 3; ++k) {
+                adjacency[cursor[pMesh->mFaces[t].mIndices[k]]++] = t;
+            }
+        }
+    }
 
-        aiVector3D min(999999, 999999, 999999), max(-999999, -999999, -999999);
-        checkMesh(mesh, min, max);
-        mesh->mAABB.mMin = min;
-        mesh->mAABB.mMax = max;
+    std::vector<aiMeshlet> meshlets;
+    std::vector<unsigned int> vertices;
+    std::vector<unsigned char> triangles;
+    vertices.reserve(numTriangles);
+    triangles.reserve(numTriangles * 3);
+
+    std::vector<unsigned int> localIndex(numVertices, NoIndex);
+    std::vector<bool> used(numTriangles, false);
+    aiMeshlet meshlet;
+    unsigned int scanCursor = 0;
+
+    auto countNewVertices = [&](unsigned int t) {
+        const unsigned int *tri = pMesh->mFaces[t].mIndices;
+        return (localIndex[tri[0]] == NoIndex ? 1u : 0u) + (localIndex[tri[1]] == NoIndex ? 1u : 0u) +
+               (localIndex[tri[2]] == NoIndex ? 1u : 0u);
+    };
+
+    for (unsigned int n = 0; n < numTriangles; ++n) {
+        // grow over the triangle adding the fewest vertices to the meshlet
+        unsigned int best = NoIndex;
+        unsigned int bestNew = 4;
+        for (unsigned int i = 0; i < meshlet.mVertexCount && bestNew > 0; ++i) {
+            const unsigned int v = vertices[meshlet.mVertexOffset + i];
+            for (unsigned int a = offsets[v]; a < offsets[v] + numLive[v]; ++a) {
+                const unsigned int t = adjacency[a];
+                const unsigned int numNew = countNewVertices(t);
+                if (numNew < bestNew && meshlet.mVertexCount + numNew <= mMaxVertices) {
+                    best = t;
+                    bestNew = numNew;
+                }
+            }
+        }
+        if (best == NoIndex) {
+            // no neighbour fits, continue with the next triangle in face order
+            while (used[scanCursor]) {
+                ++scanCursor;
+            }
+            best = scanCursor;
+            bestNew = countNewVertices(best);
+        }
+
+        if (meshlet.mVertexCount + bestNew > mMaxVertices || meshlet.mTriangleCount == mMaxTriangles) {
+            ComputeMeshletBounds(pMesh, vertices, triangles, meshlet);
+            meshlets.push_back(meshlet);
+            for (unsigned int i = 0; i < meshlet.mVertexCount; ++i) {
+                localIndex[vertices[meshlet.mVertexOffset + i]] = NoIndex;
+            }
+            meshlet = aiMeshlet();
+            meshlet.mVertexOffset = static_cast<unsigned int>(vertices.size());
+            meshlet.mTriangleOffset = static_cast<unsigned int>(triangles.size() / 3);
+        }
+
+        const unsigned int *tri = pMesh->mFaces[best].mIndices;
+        for (unsigned int k = 0; k < 3; ++k) {
+            const unsigned int v = tri[k];
+            if (localIndex[v] == NoIndex) {
+                localIndex[v] = meshlet.mVertexCount++;
+                vertices.push_back(v);
+            }
+            triangles.push_back(static_cast<unsigned char>(localIndex[v]));
+
+            unsigned int *begin = &adjacency[offsets[v]];
+            unsigned int *end = begin + numLive[v];
+            std::swap(*std::find(begin, end, best), *(end - 1));
+            --numLive[v];
+        }
+        ++meshlet.mTriangleCount;
+        used[best] = true;
     }
+    ComputeMeshletBounds(pMesh, vertices, triangles, meshlet);
+    meshlets.push_back(meshlet);
+
+    pMesh->mNumMeshlets = static_cast<unsigned int>(meshlets.size());
+    pMesh->mMeshlets = new aiMeshlet[meshlets.size()];
+    std::copy(meshlets.begin(), meshlets.end(), pMesh->mMeshlets);
+    pMesh->mNumMeshletVertices = static_cast<unsigned int>(vertices.size());
+    pMesh->mMeshletVertices = new unsigned int[vertices.size()];
+    std::copy(vertices.begin(), vertices.end(), pMesh->mMeshletVertices);
+    pMesh->mNumMeshletTriangles = static_cast<unsigned int>(triangles.size() / 3);
+    pMesh->mMeshletTriangles = new unsigned char[triangles.size()];
+    std::copy(triangles.begin(), triangles.end(), pMesh->mMeshletTriangles);
 }
 
 } // Namespace Assimp
@@ -52,26 +52,56 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Common/BaseProcess.h"
 
+struct aiMesh;
+
 namespace Assimp {
 
 /** 
  * @brief Post-processing process to find axis-aligned bounding volumes for amm meshes
  *        used in a scene.
+ *
+ * If #AI_CONFIG_PP_GBB_MESHLETS is enabled, the triangles of each mesh are also
+ * partitioned into meshlets with a bounded number of vertices and triangles, each
+ * with a bounding sphere and a normal cone for cluster culling. Meshlets grow
+ * greedily over adjacent triangles, preferring triangles which add the fewest
+ * new vertices.
  */
 class GenBoundingBoxesProcess : public BaseProcess {
 public:
     // -------------------------------------------------------------------
     /// The default class constructor / destructor.
-    GenBoundingBoxesProcess() = default;
+    GenBoundingBoxesProcess();
     ~GenBoundingBoxesProcess() override = default;
 
     // -------------------------------------------------------------------
     /// @brief Will return true, if aiProcess_GenBoundingBoxes is defined.
     bool IsActive(unsigned int pFlags) const override;
 
+    // -------------------------------------------------------------------
+    /// @brief Reads the meshlet configuration.
+    void SetupProperties(const Importer* pImp) override;
+
     // -------------------------------------------------------------------
     /// @brief The execution callback.
     void Execute(aiScene* pScene) override;
+
+    // -------------------------------------------------------------------
+    /// @brief The step processes each mesh on its own.
+    bool IsPerMeshStep() const override;
+
+    // -------------------------------------------------------------------
+    /// @brief The execution callback for a single mesh.
+    void ExecutePerMesh(aiScene* pScene, unsigned int meshIndex) override;
+
+    // -------------------------------------------------------------------
+    /// @brief Splits a single mesh into meshlets, replacing the meshlets of
+    ///        an earlier run. Only triangle meshes get meshlets.
+    void GenerateMeshlets(aiMesh* pMesh) const;
+
+private:
+    bool mGenMeshlets;
+    unsigned int mMaxVertices;
+    unsigned int mMaxTriangles;
 };
 
 } // Namespace Assimp
@@ -72,6 +72,18 @@ void GenFaceNormalsProcess::Execute(aiScene *pScene) {
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// The step processes each mesh on its own
+bool GenFaceNormalsProcess::IsPerMeshStep() const {
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on a single mesh
+void GenFaceNormalsProcess::ExecutePerMesh(aiScene *pScene, unsigned int meshIndex) {
+    GenMeshFaceNormals(pScene->mMeshes[meshIndex]);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 bool GenFaceNormalsProcess::GenMeshFaceNormals(aiMesh *pMesh) {
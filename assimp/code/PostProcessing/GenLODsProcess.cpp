@@ -0,0 +1,623 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file Implementation of the post processing step to generate levels
+ *  of detail for all meshes.
+ *
+ *  The simplifier follows Garland and Heckbert's quadric error metrics, with
+ *  half-edge collapses only: a vertex is merged into one of its neighbours,
+ *  which keeps all per-vertex attributes of the surviving vertices intact.
+ *  Collapses run in passes; each pass sorts all candidate collapses by error
+ *  and applies the cheapest ones which do not touch the same triangles.
+ */
+
+#include "GenLODsProcess.h"
+#include "ProcessHelper.h"
+#include "Common/ParallelFor.h"
+#include <assimp/Importer.hpp>
+#include <assimp/fast_atof.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+using namespace Assimp;
+
+namespace {
+
+static const unsigned int NoIndex = ~0u;
+
+// border planes are weighted higher to keep the silhouette of open meshes
+static const double BorderWeight = 10.0;
+
+enum VertexKind : unsigned char {
+    VertexKind_Manifold, // may collapse into any neighbour
+    VertexKind_Border, // may only collapse along a border edge
+    VertexKind_Locked // must not be moved at all
+};
+
+// ------------------------------------------------------------------------------------------------
+// Symmetric 4x4 matrix summing up the squared distances to a set of planes
+struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+    double a11 = 0, a12 = 0, a13 = 0;
+    double a22 = 0, a23 = 0;
+    double a33 = 0;
+    double weight = 0;
+
+    void AddPlane(double nx, double ny, double nz, double d, double w) {
+        a00 += w * nx * nx;
+        a01 += w * nx * ny;
+        a02 += w * nx * nz;
+        a03 += w * nx * d;
+        a11 += w * ny * ny;
+        a12 += w * ny * nz;
+        a13 += w * ny * d;
+        a22 += w * nz * nz;
+        a23 += w * nz * d;
+        a33 += w * d * d;
+        weight += w;
+    }
+
+    void Add(const Quadric &other) {
+        a00 += other.a00;
+        a01 += other.a01;
+        a02 += other.a02;
+        a03 += other.a03;
+        a11 += other.a11;
+        a12 += other.a12;
+        a13 += other.a13;
+        a22 += other.a22;
+        a23 += other.a23;
+        a33 += other.a33;
+        weight += other.weight;
+    }
+
+    // mean squared distance of the point to the planes
+    double Evaluate(const aiVector3D &p) const {
+        const double x = p.x, y = p.y, z = p.z;
+        const double error = a00 * x * x + a11 * y * y + a22 * z * z + a33 +
+                2.0 * (a01 * x * y + a02 * x * z + a12 * y * z + a03 * x + a13 * y + a23 * z);
+        return weight > 0.0 ? std::abs(error) / weight : 0.0;
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+struct Collapse {
+    double error;
+    unsigned int from, to;
+
+    bool operator<(const Collapse &other) const {
+        if (error != other.error) {
+            return error < other.error;
+        }
+        return from != other.from ? from < other.from : to < other.to;
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+// Triangles around each vertex, stored as offsets into a shared list
+struct VertexTriangles {
+    std::vector<unsigned int> offsets;
+    std::vector<unsigned int> triangles;
+
+    void Build(const std::vector<unsigned int> &indices, unsigned int numVertices) {
+        offsets.assign(numVertices + 1, 0);
+        for (unsigned int index : indices) {
+            ++offsets[index + 1];
+        }
+        for (unsigned int v = 0; v < numVertices; ++v) {
+            offsets[v + 1] += offsets[v];
+        }
+        triangles.resize(indices.size());
+        std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+        for (unsigned int i = 0; i < indices.size(); ++i) {
+            triangles[cursor[indices[i]]++] = i / 3;
+        }
+    }
+
+    // number of triangles using the edge between two vertices
+    unsigned int CountEdge(const std::vector<unsigned int> &indices, unsigned int a, unsigned int b) const {
+        unsigned int count = 0;
+        for (unsigned int i = offsets[a]; i < offsets[a + 1]; ++i) {
+            const unsigned int *tri = &indices[triangles[i] * 3];
+            count += (tri[0] == b || tri[1] == b || tri[2] == b) ? 1 : 0;
+        }
+        return count;
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+inline aiVector3D TriangleNormal(const aiVector3D &a, const aiVector3D &b, const aiVector3D &c) {
+    return (b - a) ^ (c - a);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the mesh consists of valid triangles only
+bool IsTriangleMesh(const aiMesh *mesh) {
+    if (!mesh->HasPositions() || !mesh->HasFaces()) {
+        return false;
+    }
+    for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+        const aiFace &face = mesh->mFaces[f];
+        if (face.mNumIndices != 3) {
+            return false;
+        }
+        for (unsigned int i = 0; i < 3; ++i) {
+            if (face.mIndices[i] >= mesh->mNumVertices) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Edge collapse simplifier for a single mesh, reducing one index buffer level by level
+class MeshSimplifier {
+public:
+    MeshSimplifier(const aiMesh *mesh, std::vector<unsigned int> &indices) :
+            mPositions(mesh->mVertices), mNumVertices(mesh->mNumVertices), mIndices(indices) {
+        ClassifyVertices();
+        ComputeQuadrics();
+    }
+
+    // Collapses edges until the target triangle count or the maximum error is reached
+    void Simplify(unsigned int targetTriangles, double maxError) {
+        std::vector<Collapse> candidates;
+        std::vector<unsigned int> collapseTo(mNumVertices, NoIndex);
+        std::vector<bool> touched(mNumVertices);
+        VertexTriangles adjacency;
+
+        unsigned int numTriangles = static_cast<unsigned int>(mIndices.size() / 3);
+        while (numTriangles > targetTriangles) {
+            adjacency.Build(mIndices, mNumVertices);
+            CollectCandidates(adjacency, candidates);
+            std::sort(candidates.begin(), candidates.end());
+
+            std::fill(touched.begin(), touched.end(), false);
+            unsigned int removed = 0;
+            for (const Collapse &collapse : candidates) {
+                if (collapse.error > maxError || numTriangles - removed <= targetTriangles) {
+                    break;
+                }
+                if (touched[collapse.from] || touched[collapse.to]) {
+                    continue;
+                }
+                const unsigned int removes = CheckCollapse(adjacency, collapse.from, collapse.to);
+                if (removes == 0 || removes >= numTriangles - removed) {
+                    continue;
+                }
+
+                // the triangles around the collapsed vertex are changed, keep them out of this pass
+                for (unsigned int i = adjacency.offsets[collapse.from]; i < adjacency.offsets[collapse.from + 1]; ++i) {
+                    const unsigned int *tri = &mIndices[adjacency.triangles[i] * 3];
+                    touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = true;
+                }
+                collapseTo[collapse.from] = collapse.to;
+                mQuadrics[collapse.to].Add(mQuadrics[collapse.from]);
+                removed += removes;
+            }
+            if (removed == 0) {
+                break;
+            }
+
+            // apply the collapses and drop the triangles which became degenerate
+            unsigned int out = 0;
+            for (size_t i = 0; i < mIndices.size(); i += 3) {
+                unsigned int tri[3];
+                for (unsigned int k = 0; k < 3; ++k) {
+                    const unsigned int index = mIndices[i + k];
+                    tri[k] = collapseTo[index] != NoIndex ? collapseTo[index] : index;
+                }
+                if (tri[0] != tri[1] && tri[1] != tri[2] && tri[0] != tri[2]) {
+                    std::copy(tri, tri + 3, &mIndices[out]);
+                    out += 3;
+                }
+            }
+            mIndices.resize(out);
+            std::fill(collapseTo.begin(), collapseTo.end(), NoIndex);
+            numTriangles = out / 3;
+        }
+    }
+
+private:
+    // Locks vertices on attribute seams and non-manifold edges, detects borders
+    void ClassifyVertices() {
+        mKinds.assign(mNumVertices, VertexKind_Manifold);
+
+        // vertices sharing a position with another vertex are split by an attribute seam
+        std::vector<unsigned int> order;
+        order.reserve(mNumVertices);
+        for (unsigned int v = 0; v < mNumVertices; ++v) {
+            const aiVector3D &p = mPositions[v];
+            if (std::isfinite(p.x) && std::isfinite(p.y) && std::isfinite(p.z)) {
+                order.push_back(v);
+            } else {
+                mKinds[v] = VertexKind_Locked;
+            }
+        }
+        const aiVector3D *positions = mPositions;
+        std::sort(order.begin(), order.end(), [positions](unsigned int a, unsigned int b) {
+            return positions[a] < positions[b];
+        });
+        for (size_t i = 1; i < order.size(); ++i) {
+            if (positions[order[i]] == positions[order[i - 1]]) {
+                mKinds[order[i]] = mKinds[order[i - 1]] = VertexKind_Locked;
+            }
+        }
+
+        VertexTriangles adjacency;
+        adjacency.Build(mIndices, mNumVertices);
+        for (size_t i = 0; i < mIndices.size(); ++i) {
+            const unsigned int a = mIndices[i];
+            const unsigned int b = mIndices[i - i % 3 + (i + 1) % 3];
+            const unsigned int count = adjacency.CountEdge(mIndices, a, b);
+            if (count == 1) {
+                for (unsigned int v : { a, b }) {
+                    if (mKinds[v] == VertexKind_Manifold) {
+                        mKinds[v] = VertexKind_Border;
+                    }
+                }
+            } else if (count > 2) {
+                mKinds[a] = mKinds[b] = VertexKind_Locked;
+            }
+        }
+    }
+
+    // Sums up the planes of the adjacent triangles, and of the border edges, per vertex
+    void ComputeQuadrics() {
+        mQuadrics.assign(mNumVertices, Quadric());
+
+        VertexTriangles adjacency;
+        adjacency.Build(mIndices, mNumVertices);
+        for (size_t t = 0; t < mIndices.size(); t += 3) {
+            const unsigned int *tri = &mIndices[t];
+            const aiVector3D &p0 = mPositions[tri[0]];
+            aiVector3D normal = TriangleNormal(p0, mPositions[tri[1]], mPositions[tri[2]]);
+            const ai_real length = normal.Length();
+            if (!(length > 0)) {
+                continue;
+            }
+            normal /= length;
+            const double d = -(normal * p0);
+            for (unsigned int k = 0; k < 3; ++k) {
+                mQuadrics[tri[k]].AddPlane(normal.x, normal.y, normal.z, d, 0.5 * length);
+            }
+
+            for (unsigned int k = 0; k < 3; ++k) {
+                const unsigned int a = tri[k], b = tri[(k + 1) % 3];
+                if (adjacency.CountEdge(mIndices, a, b) != 1) {
+                    continue;
+                }
+                const aiVector3D edge = mPositions[b] - mPositions[a];
+                aiVector3D borderNormal = edge ^ normal;
+                const ai_real borderLength = borderNormal.Length();
+                if (!(borderLength > 0)) {
+                    continue;
+                }
+                borderNormal /= borderLength;
+                const double borderD = -(borderNormal * mPositions[a]);
+                const double weight = BorderWeight * edge.SquareLength();
+                mQuadrics[a].AddPlane(borderNormal.x, borderNormal.y, borderNormal.z, borderD, weight);
+                mQuadrics[b].AddPlane(borderNormal.x, borderNormal.y, borderNormal.z, borderD, weight);
+            }
+        }
+    }
+
+    // Gathers the allowed collapses along all edges of the current triangles
+    void CollectCandidates(const VertexTriangles &adjacency, std::vector<Collapse> &candidates) const {
+        candidates.clear();
+        for (size_t i = 0; i < mIndices.size(); ++i) {
+            const unsigned int a = mIndices[i];
+            const unsigned int b = mIndices[i - i % 3 + (i + 1) % 3];
+
+            // each interior edge is seen once per direction, border edges only once
+            const bool border = mKinds[a] != VertexKind_Manifold && mKinds[b] != VertexKind_Manifold &&
+                    adjacency.CountEdge(mIndices, a, b) == 1;
+            if (mKinds[a] == VertexKind_Manifold || (border && mKinds[a] == VertexKind_Border)) {
+                candidates.push_back({ mQuadrics[a].Evaluate(mPositions[b]), a, b });
+            }
+            if (border && mKinds[b] == VertexKind_Border) {
+                candidates.push_back({ mQuadrics[b].Evaluate(mPositions[a]), b, a });
+            }
+        }
+    }
+
+    // Returns the number of triangles the collapse removes, 0 if it would fold over a triangle
+    unsigned int CheckCollapse(const VertexTriangles &adjacency, unsigned int from, unsigned int to) const {
+        unsigned int removes = 0;
+        for (unsigned int i = adjacency.offsets[from]; i < adjacency.offsets[from + 1]; ++i) {
+            const unsigned int *tri = &mIndices[adjacency.triangles[i] * 3];
+            if (tri[0] == to || tri[1] == to || tri[2] == to) {
+                ++removes;
+                continue;
+            }
+            aiVector3D p[3] = { mPositions[tri[0]], mPositions[tri[1]], mPositions[tri[2]] };
+            const aiVector3D before = TriangleNormal(p[0], p[1], p[2]);
+            for (unsigned int k = 0; k < 3; ++k) {
+                if (tri[k] == from) {
+                    p[k] = mPositions[to];
+                }
+            }
+            // reject flipped triangles as well as those turning by more than about 75 degrees
+            const aiVector3D after = TriangleNormal(p[0], p[1], p[2]);
+            const double dot = before * after;
+            if (!(dot > 0) || dot * dot < 0.0625 * before.SquareLength() * after.SquareLength()) {
+                return 0;
+            }
+        }
+        return removes;
+    }
+
+    const aiVector3D *mPositions;
+    const unsigned int mNumVertices;
+    std::vector<unsigned int> &mIndices;
+    std::vector<VertexKind> mKinds;
+    std::vector<Quadric> mQuadrics;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Copies the values of the used vertices of an attribute array
+template <typename T>
+T *GatherArray(const T *array, const std::vector<unsigned int> &used) {
+    if (nullptr == array) {
+        return nullptr;
+    }
+    T *gathered = new T[used.size()];
+    for (size_t i = 0; i < used.size(); ++i) {
+        gathered[i] = array[used[i]];
+    }
+    return gathered;
+}
+
+// ------------------------------------------------------------------------------------------------
+std::string GetLODName(const aiMesh *mesh, unsigned int level) {
+    return std::string(mesh->mName.C_Str()) + "_LOD" + std::to_string(level);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Builds a new mesh from the vertices of the base mesh referenced by the simplified triangles
+aiMesh *CreateLODMesh(const aiMesh *base, const std::vector<unsigned int> &indices, unsigned int level) {
+    std::vector<unsigned int> remap(base->mNumVertices, NoIndex);
+    std::vector<unsigned int> used;
+    for (unsigned int index : indices) {
+        if (remap[index] == NoIndex) {
+            remap[index] = static_cast<unsigned int>(used.size());
+            used.push_back(index);
+        }
+    }
+
+    std::unique_ptr<aiMesh> mesh(new aiMesh());
+    mesh->mName.Set(GetLODName(base, level));
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    mesh->mMaterialIndex = base->mMaterialIndex;
+    mesh->mMethod = base->mMethod;
+    mesh->mNumVertices = static_cast<unsigned int>(used.size());
+    mesh->mVertices = GatherArray(base->mVertices, used);
+    mesh->mNormals = GatherArray(base->mNormals, used);
+    mesh->mTangents = GatherArray(base->mTangents, used);
+    mesh->mBitangents = GatherArray(base->mBitangents, used);
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        mesh->mTextureCoords[i] = GatherArray(base->mTextureCoords[i], used);
+        mesh->mNumUVComponents[i] = base->mNumUVComponents[i];
+        if (base->HasTextureCoordsName(i)) {
+            mesh->SetTextureCoordsName(i, *base->GetTextureCoordsName(i));
+        }
+    }
+
+    mesh->mNumFaces = static_cast<unsigned int>(indices.size() / 3);
+    mesh->mFaces = new aiFace[mesh->mNumFaces];
+    for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+        aiFace &face = mesh->mFaces[f];
+        face.mNumIndices = 3;
+        face.mIndices = new unsigned int[3];
+        for (unsigned int k = 0; k < 3; ++k) {
+            face.mIndices[k] = remap[indices[f * 3 + k]];
+        }
+    }
+
+    // all bones are kept, so bone indices match between the levels
+    if (base->mNumBones) {
+        mesh->mNumBones = base->mNumBones;
+        mesh->mBones = new aiBone *[mesh->mNumBones]();
+        for (unsigned int b = 0; b < base->mNumBones; ++b) {
+            const aiBone *srcBone = base->mBones[b];
+            aiBone *bone = mesh->mBones[b] = new aiBone();
+            bone->mName = srcBone->mName;
+            bone->mOffsetMatrix = srcBone->mOffsetMatrix;
+#ifndef ASSIMP_BUILD_NO_ARMATUREPOPULATE_PROCESS
+            bone->mArmature = srcBone->mArmature;
+            bone->mNode = srcBone->mNode;
+#endif
+            for (unsigned int w = 0; w < srcBone->mNumWeights; ++w) {
+                const unsigned int vertexId = srcBone->mWeights[w].mVertexId;
+                bone->mNumWeights += (vertexId < base->mNumVertices && remap[vertexId] != NoIndex) ? 1 : 0;
+            }
+            if (0 == bone->mNumWeights) {
+                continue;
+            }
+            bone->mWeights = new aiVertexWeight[bone->mNumWeights];
+            unsigned int numWeights = 0;
+            for (unsigned int w = 0; w < srcBone->mNumWeights; ++w) {
+                const unsigned int vertexId = srcBone->mWeights[w].mVertexId;
+                if (vertexId < base->mNumVertices && remap[vertexId] != NoIndex) {
+                    bone->mWeights[numWeights++] = aiVertexWeight(remap[vertexId], srcBone->mWeights[w].mWeight);
+                }
+            }
+        }
+    }
+
+    if (base->mNumAnimMeshes) {
+        mesh->mNumAnimMeshes = base->mNumAnimMeshes;
+        mesh->mAnimMeshes = new aiAnimMesh *[mesh->mNumAnimMeshes]();
+        for (unsigned int m = 0; m < base->mNumAnimMeshes; ++m) {
+            const aiAnimMesh *srcAnimMesh = base->mAnimMeshes[m];
+            aiAnimMesh *animMesh = mesh->mAnimMeshes[m] = new aiAnimMesh();
+            animMesh->mName = srcAnimMesh->mName;
+            animMesh->mWeight = srcAnimMesh->mWeight;
+            animMesh->mNumVertices = mesh->mNumVertices;
+            animMesh->mVertices = GatherArray(srcAnimMesh->mVertices, used);
+            animMesh->mNormals = GatherArray(srcAnimMesh->mNormals, used);
+            animMesh->mTangents = GatherArray(srcAnimMesh->mTangents, used);
+            animMesh->mBitangents = GatherArray(srcAnimMesh->mBitangents, used);
+            for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+                animMesh->mTextureCoords[i] = GatherArray(srcAnimMesh->mTextureCoords[i], used);
+            }
+        }
+    }
+    return mesh.release();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether all anim meshes match the vertex count of the mesh
+bool HasValidAnimMeshes(const aiMesh *mesh) {
+    for (unsigned int m = 0; m < mesh->mNumAnimMeshes; ++m) {
+        if (mesh->mAnimMeshes[m]->mNumVertices != mesh->mNumVertices) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+// Constructor to be privately used by Importer
+GenLODsProcess::GenLODsProcess() :
+        mMaxError(0), mNumThreads(1) {
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+// The step has no flag of its own
+bool GenLODsProcess::IsActive(unsigned int /*pFlags*/) const {
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether levels of detail were requested
+bool GenLODsProcess::IsRequested(const Importer *pImp) const {
+    return pImp->GetPropertyBool(AI_CONFIG_PP_LOD_GENERATE, false);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Setup properties for the step
+void GenLODsProcess::SetupProperties(const Importer *pImp) {
+    std::list<std::string> ratios;
+    ConvertListToStrings(pImp->GetPropertyString(AI_CONFIG_PP_LOD_RATIOS, AI_LOD_DEFAULT_RATIOS), ratios);
+    mRatios.clear();
+    for (const std::string &ratio : ratios) {
+        const ai_real value = fast_atof(ratio.c_str());
+        if (value > 0 && value < 1) {
+            mRatios.push_back(value);
+        }
+    }
+
+    mMaxError = std::max(pImp->GetPropertyFloat(AI_CONFIG_PP_LOD_MAX_ERROR, 0.f), (ai_real)0.0);
+    mNumThreads = GetNumWorkerThreads(pImp->GetPropertyInteger(AI_CONFIG_PP_NUM_THREADS, 1));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given imported data.
+void GenLODsProcess::Execute(aiScene *pScene) {
+    const unsigned int numLevels = static_cast<unsigned int>(mRatios.size());
+    if (0 == numLevels) {
+        return;
+    }
+
+    ParallelFor(pScene->mNumMeshes, mNumThreads, [&](size_t i) {
+        aiMesh *mesh = pScene->mMeshes[i];
+
+        // levels of an earlier run are replaced, they are always built from the mesh itself
+        for (unsigned int l = 0; l < mesh->mNumLODs; ++l) {
+            delete mesh->mLODs[l];
+        }
+        delete[] mesh->mLODs;
+        mesh->mLODs = nullptr;
+        mesh->mNumLODs = 0;
+
+        std::unique_ptr<aiMesh *[]> lods(new aiMesh *[numLevels]());
+        try {
+            if (!GenerateLODs(mesh, lods.get())) {
+                return;
+            }
+        } catch (...) {
+            for (unsigned int l = 0; l < numLevels; ++l) {
+                delete lods[l];
+            }
+            throw;
+        }
+        mesh->mLODs = lods.release();
+        mesh->mNumLODs = numLevels;
+    });
+}
+
+// ------------------------------------------------------------------------------------------------
+// Generates the levels of detail of a single mesh
+bool GenLODsProcess::GenerateLODs(const aiMesh *pMesh, aiMesh **pLODs) const {
+    const unsigned int numLevels = static_cast<unsigned int>(mRatios.size());
+
+    if (!IsTriangleMesh(pMesh) || !HasValidAnimMeshes(pMesh)) {
+        return false;
+    }
+
+    aiVector3D min, max;
+    ArrayBounds(pMesh->mVertices, pMesh->mNumVertices, min, max);
+    const double maxError = mMaxError > 0 ? std::pow(mMaxError * (max - min).Length(), 2) : HUGE_VAL;
+
+    std::vector<unsigned int> indices(pMesh->mNumFaces * 3);
+    for (unsigned int f = 0; f < pMesh->mNumFaces; ++f) {
+        std::copy(pMesh->mFaces[f].mIndices, pMesh->mFaces[f].mIndices + 3, &indices[f * 3]);
+    }
+
+    // every level continues from the previous one
+    MeshSimplifier simplifier(pMesh, indices);
+    for (unsigned int l = 0; l < numLevels; ++l) {
+        const unsigned int target = std::max(1u, static_cast<unsigned int>(mRatios[l] * pMesh->mNumFaces));
+        simplifier.Simplify(target, maxError);
+        pLODs[l] = CreateLODMesh(pMesh, indices, l + 1);
+    }
+    return true;
+}
@@ -0,0 +1,131 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file Defines a post processing step to generate simplified
+ *  levels of detail for all meshes
+ */
+#ifndef AI_GENLODSPROCESS_H_INC
+#define AI_GENLODSPROCESS_H_INC
+
+#include "Common/BaseProcess.h"
+#include <assimp/types.h>
+
+#include <vector>
+
+struct aiMesh;
+
+namespace Assimp {
+
+// ---------------------------------------------------------------------------
+/** The GenLODsProcess generates simplified versions of all meshes by
+ * quadric error metric edge collapses. Vertices are only ever collapsed
+ * into one of their neighbours, so the surviving vertices keep their
+ * normals, texture coordinates and bone weights. Vertices on texture seams
+ * or other attribute discontinuities are not moved, border vertices only
+ * slide along the border.
+ *
+ * The levels are stored in aiMesh::mLODs of each mesh, the mesh list of
+ * the scene is left as it is. Meshes which are not pure triangle meshes
+ * get no levels. Levels of an earlier run are replaced, so running the
+ * step again gives the same result.
+ *
+ * The step has no #aiPostProcessSteps flag, it runs whenever the
+ * #AI_CONFIG_PP_LOD_GENERATE property is enabled.
+ */
+class GenLODsProcess : public BaseProcess {
+public:
+    // -------------------------------------------------------------------
+    /// The default class constructor / destructor.
+    GenLODsProcess();
+    ~GenLODsProcess() override = default;
+
+    // -------------------------------------------------------------------
+    /** Returns whether the processing step is present in the given flag field.
+     * @param pFlags The processing flags the importer was called with. A bitwise
+     *   combination of #aiPostProcessSteps.
+     * @return true if the process is present in this flag fields, false if not.
+    */
+    bool IsActive( unsigned int pFlags) const override;
+
+    // -------------------------------------------------------------------
+    /** Returns whether levels of detail were requested by the
+     * #AI_CONFIG_PP_LOD_GENERATE property.
+     */
+    bool IsRequested(const Importer* pImp) const override;
+
+    // -------------------------------------------------------------------
+    /** Called prior to ExecuteOnScene().
+    * The function is a request to the process to update its configuration
+    * basing on the Importer's configuration property list.
+    */
+    void SetupProperties(const Importer* pImp) override;
+
+    // -------------------------------------------------------------------
+    /** Executes the post processing step on the given imported data.
+    * At the moment a process is not supposed to fail.
+    * @param pScene The imported data to work at.
+    */
+    void Execute( aiScene* pScene) override;
+
+    // -------------------------------------------------------------------
+    /** Generates the levels of detail of a single mesh.
+     * @param pMesh The mesh to simplify.
+     * @param pLODs Receives one new mesh per configured ratio.
+     * @return false if the mesh cannot be simplified, pLODs is left
+     *   untouched then.
+     */
+    bool GenerateLODs( const aiMesh* pMesh, aiMesh** pLODs) const;
+
+private:
+    /** Configuration option: target triangle ratio of each level */
+    std::vector<ai_real> mRatios;
+
+    /** Configuration option: maximum error relative to the mesh extent */
+    ai_real mMaxError;
+
+    /** Number of threads to simplify meshes on */
+    unsigned int mNumThreads;
+};
+
+} // end of namespace Assimp
+
+#endif // AI_GENLODSPROCESS_H_INC
@@ -87,6 +87,18 @@ void GenVertexNormalsProcess::Execute(aiScene *pScene) {
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// The step processes each mesh on its own
+bool GenVertexNormalsProcess::IsPerMeshStep() const {
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on a single mesh
+void GenVertexNormalsProcess::ExecutePerMesh(aiScene *pScene, unsigned int meshIndex) {
+    GenMeshVertexNormals(pScene->mMeshes[meshIndex], meshIndex);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 bool GenVertexNormalsProcess::GenMeshVertexNormals(aiMesh *pMesh, unsigned int meshIndex) {
@@ -87,6 +87,19 @@ public:
     */
     void Execute( aiScene* pScene) override;
 
+    // -------------------------------------------------------------------
+    /** The step processes each mesh on its own.
+     * @see BaseProcess::IsPerMeshStep()
+     */
+    bool IsPerMeshStep() const override;
+
+    // -------------------------------------------------------------------
+    /** Executes the post processing step on a single mesh.
+     * @param pScene The imported data to work at.
+     * @param meshIndex The index of the mesh to process.
+     */
+    void ExecutePerMesh( aiScene* pScene, unsigned int meshIndex) override;
+
     // setter for configMaxAngle
     inline void SetMaxSmoothAngle(ai_real f) {
         configMaxAngle =f;
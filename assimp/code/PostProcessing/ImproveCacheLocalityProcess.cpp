@@ -0,0 +1,428 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file Implementation of the post processing step to improve the
+ *  post-transform vertex cache locality of all meshes.
+ *
+ *  The face order is optimized with Tom Forsyth's "Linear-Speed Vertex Cache
+ *  Optimisation": every vertex gets a score from its position in a simulated
+ *  LRU cache and from the number of triangles still using it, and the
+ *  triangle with the highest score around the cache is emitted next.
+ */
+
+#include "ImproveCacheLocalityProcess.h"
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace Assimp;
+
+namespace {
+
+static const unsigned int MaxCacheSize = 64;
+static const unsigned int MaxValence = 32;
+static const unsigned int NoIndex = ~0u;
+
+// ------------------------------------------------------------------------------------------------
+// Precomputed vertex scores, by cache position and by the number of remaining triangles
+struct VertexScoreTable {
+    float cache[MaxCacheSize];
+    float valence[MaxValence];
+
+    explicit VertexScoreTable(unsigned int cacheSize) {
+        const float CacheDecayPower = 1.5f;
+        const float LastTriScore = 0.75f;
+        const float ValenceBoostScale = 2.0f;
+        const float ValenceBoostPower = 0.5f;
+
+        for (unsigned int i = 0; i < MaxCacheSize; ++i) {
+            if (i < 3) {
+                // the vertices of the last triangle are scored equally, no matter
+                // in which order they have been added to the cache
+                cache[i] = LastTriScore;
+            } else if (i < cacheSize) {
+                const float scale = 1.0f / static_cast<float>(cacheSize - 3);
+                cache[i] = std::pow(1.0f - static_cast<float>(i - 3) * scale, CacheDecayPower);
+            } else {
+                cache[i] = 0.0f;
+            }
+        }
+        valence[0] = 0.0f;
+        for (unsigned int i = 1; i < MaxValence; ++i) {
+            // vertices with few triangles left are preferred to get rid of them
+            valence[i] = ValenceBoostScale * std::pow(static_cast<float>(i), -ValenceBoostPower);
+        }
+    }
+
+    float Score(unsigned int numActiveTris, unsigned int cachePosition) const {
+        if (numActiveTris == 0) {
+            return -1.0f;
+        }
+        const float score = cachePosition < MaxCacheSize ? cache[cachePosition] : 0.0f;
+        return score + valence[std::min(numActiveTris, MaxValence - 1)];
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the mesh consists of valid triangles only
+bool IsTriangleMesh(const aiMesh *mesh) {
+    if (!mesh->HasPositions() || !mesh->HasFaces()) {
+        return false;
+    }
+    for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+        const aiFace &face = mesh->mFaces[f];
+        if (face.mNumIndices != 3) {
+            return false;
+        }
+        for (unsigned int i = 0; i < 3; ++i) {
+            if (face.mIndices[i] >= mesh->mNumVertices) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void CollectIndices(const aiMesh *mesh, std::vector<unsigned int> &indices) {
+    indices.resize(mesh->mNumFaces * 3);
+    for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+        std::copy(mesh->mFaces[f].mIndices, mesh->mFaces[f].mIndices + 3, &indices[f * 3]);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Simulates a FIFO vertex cache and counts the vertices which have to be transformed
+unsigned int CountCacheMisses(const std::vector<unsigned int> &indices, unsigned int numVertices,
+        unsigned int cacheSize, unsigned int *numReferenced = nullptr) {
+    // a vertex is in the cache if it has been added less than cacheSize misses ago
+    std::vector<unsigned int> addedAt(numVertices, 0);
+    unsigned int misses = 0;
+    unsigned int referenced = 0;
+    for (unsigned int index : indices) {
+        if (addedAt[index] == 0) {
+            ++referenced;
+        } else if (misses - addedAt[index] < cacheSize) {
+            continue;
+        }
+        addedAt[index] = ++misses;
+    }
+    if (nullptr != numReferenced) {
+        *numReferenced = referenced;
+    }
+    return misses;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Reorders the triangles for the vertex cache, after Tom Forsyth
+void OptimizeTriangleOrder(const std::vector<unsigned int> &indices, unsigned int numVertices,
+        unsigned int cacheSize, std::vector<unsigned int> &out) {
+    const unsigned int numTris = static_cast<unsigned int>(indices.size() / 3);
+    const VertexScoreTable table(cacheSize);
+
+    // triangles using each vertex, the active ones are kept at the front
+    std::vector<unsigned int> numActiveTris(numVertices, 0);
+    for (unsigned int index : indices) {
+        ++numActiveTris[index];
+    }
+    std::vector<unsigned int> offsets(numVertices + 1, 0);
+    for (unsigned int v = 0; v < numVertices; ++v) {
+        offsets[v + 1] = offsets[v] + numActiveTris[v];
+    }
+    std::vector<unsigned int> adjacency(indices.size());
+    {
+        std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+        for (unsigned int i = 0; i < indices.size(); ++i) {
+            adjacency[cursor[indices[i]]++] = i / 3;
+        }
+    }
+
+    std::vector<unsigned int> cachePosition(numVertices, NoIndex);
+    std::vector<float> vertexScore(numVertices);
+    for (unsigned int v = 0; v < numVertices; ++v) {
+        vertexScore[v] = table.Score(numActiveTris[v], NoIndex);
+    }
+
+    std::vector<float> triScore(numTris);
+    std::vector<bool> emitted(numTris, false);
+    unsigned int best = 0;
+    for (unsigned int t = 0; t < numTris; ++t) {
+        triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+        if (triScore[t] > triScore[best]) {
+            best = t;
+        }
+    }
+
+    // the cache holds up to three more entries while a triangle is added
+    std::vector<unsigned int> cache, newCache;
+    cache.reserve(cacheSize + 3);
+    newCache.reserve(cacheSize + 3);
+
+    out.clear();
+    out.reserve(indices.size());
+    unsigned int scanCursor = 0;
+    for (unsigned int n = 0; n < numTris; ++n) {
+        if (best == NoIndex) {
+            // no candidates around the cache, continue with the next triangle in input order
+            while (emitted[scanCursor]) {
+                ++scanCursor;
+            }
+            best = scanCursor;
+        }
+
+        emitted[best] = true;
+        const unsigned int *tri = &indices[best * 3];
+        out.insert(out.end(), tri, tri + 3);
+
+        // drop the triangle from the active lists of its vertices
+        newCache.clear();
+        for (unsigned int i = 0; i < 3; ++i) {
+            const unsigned int v = tri[i];
+            unsigned int *begin = &adjacency[offsets[v]];
+            unsigned int *end = begin + numActiveTris[v];
+            std::swap(*std::find(begin, end, best), *(end - 1));
+            --numActiveTris[v];
+            newCache.push_back(v);
+        }
+        for (unsigned int v : cache) {
+            if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                newCache.push_back(v);
+            }
+        }
+
+        // rescore all vertices which were or are in the cache
+        for (unsigned int i = 0; i < newCache.size(); ++i) {
+            const unsigned int v = newCache[i];
+            cachePosition[v] = i < cacheSize ? i : NoIndex;
+            const float score = table.Score(numActiveTris[v], cachePosition[v]);
+            const float delta = score - vertexScore[v];
+            vertexScore[v] = score;
+            for (unsigned int a = offsets[v]; a < offsets[v] + numActiveTris[v]; ++a) {
+                triScore[adjacency[a]] += delta;
+            }
+        }
+        if (newCache.size() > cacheSize) {
+            newCache.resize(cacheSize);
+        }
+        cache.swap(newCache);
+
+        // pick the best triangle around the cache
+        best = NoIndex;
+        float bestScore = -1.0f;
+        for (unsigned int v : cache) {
+            for (unsigned int a = offsets[v]; a < offsets[v] + numActiveTris[v]; ++a) {
+                const unsigned int t = adjacency[a];
+                if (triScore[t] > bestScore) {
+                    bestScore = triScore[t];
+                    best = t;
+                }
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Moves the elements of a vertex attribute array to their new indices
+template <typename T>
+void PermuteArray(T *&array, const std::vector<unsigned int> &remap) {
+    if (nullptr == array) {
+        return;
+    }
+    T *permuted = new T[remap.size()];
+    for (size_t i = 0; i < remap.size(); ++i) {
+        permuted[remap[i]] = array[i];
+    }
+    delete[] array;
+    array = permuted;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Renumbers the vertices in the order of their first use, unused vertices go to the end
+void OptimizeVertexFetch(aiMesh *mesh, std::vector<unsigned int> &indices) {
+    for (unsigned int m = 0; m < mesh->mNumAnimMeshes; ++m) {
+        if (mesh->mAnimMeshes[m]->mNumVertices != mesh->mNumVertices) {
+            return;
+        }
+    }
+
+    std::vector<unsigned int> remap(mesh->mNumVertices, NoIndex);
+    unsigned int next = 0;
+    for (unsigned int &index : indices) {
+        if (remap[index] == NoIndex) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+    for (unsigned int &index : remap) {
+        if (index == NoIndex) {
+            index = next++;
+        }
+    }
+
+    PermuteArray(mesh->mVertices, remap);
+    PermuteArray(mesh->mNormals, remap);
+    PermuteArray(mesh->mTangents, remap);
+    PermuteArray(mesh->mBitangents, remap);
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        PermuteArray(mesh->mTextureCoords[i], remap);
+    }
+    for (unsigned int m = 0; m < mesh->mNumAnimMeshes; ++m) {
+        aiAnimMesh *animMesh = mesh->mAnimMeshes[m];
+        PermuteArray(animMesh->mVertices, remap);
+        PermuteArray(animMesh->mNormals, remap);
+        PermuteArray(animMesh->mTangents, remap);
+        PermuteArray(animMesh->mBitangents, remap);
+        for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+            PermuteArray(animMesh->mTextureCoords[i], remap);
+        }
+    }
+    for (unsigned int b = 0; b < mesh->mNumBones; ++b) {
+        aiBone *bone = mesh->mBones[b];
+        for (unsigned int w = 0; w < bone->mNumWeights; ++w) {
+            if (bone->mWeights[w].mVertexId < mesh->mNumVertices) {
+                bone->mWeights[w].mVertexId = remap[bone->mWeights[w].mVertexId];
+            }
+        }
+    }
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+// Constructor to be privately used by Importer
+ImproveCacheLocalityProcess::ImproveCacheLocalityProcess() :
+        mConfigCacheDepth(PP_ICL_PTCACHE_SIZE) {
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the processing step is present in the given flag field.
+bool ImproveCacheLocalityProcess::IsActive(unsigned int pFlags) const {
+    return (pFlags & aiProcess_ImproveCacheLocality) != 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Setup properties for the step
+void ImproveCacheLocalityProcess::SetupProperties(const Importer *pImp) {
+    // the cache must at least hold the vertices of the last triangle
+    const int cacheDepth = pImp->GetPropertyInteger(AI_CONFIG_PP_ICL_PTCACHE_SIZE, PP_ICL_PTCACHE_SIZE);
+    mConfigCacheDepth = static_cast<unsigned int>(std::min(std::max(cacheDepth, 4), static_cast<int>(MaxCacheSize)));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given imported data.
+void ImproveCacheLocalityProcess::Execute(aiScene *pScene) {
+    for (unsigned int a = 0; a < pScene->mNumMeshes; ++a) {
+        ProcessMesh(pScene->mMeshes[a]);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// The step processes each mesh on its own
+bool ImproveCacheLocalityProcess::IsPerMeshStep() const {
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on a single mesh
+void ImproveCacheLocalityProcess::ExecutePerMesh(aiScene *pScene, unsigned int meshIndex) {
+    ProcessMesh(pScene->mMeshes[meshIndex]);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Optimizes the face and vertex order of a single mesh
+ai_real ImproveCacheLocalityProcess::ProcessMesh(aiMesh *pMesh) {
+    if (!IsTriangleMesh(pMesh)) {
+        return 0.0;
+    }
+
+    std::vector<unsigned int> indices;
+    CollectIndices(pMesh, indices);
+    const unsigned int missesIn = CountCacheMisses(indices, pMesh->mNumVertices, mConfigCacheDepth);
+
+    // keep the input order if it is already better than ours
+    std::vector<unsigned int> optimized;
+    OptimizeTriangleOrder(indices, pMesh->mNumVertices, mConfigCacheDepth, optimized);
+    unsigned int misses = CountCacheMisses(optimized, pMesh->mNumVertices, mConfigCacheDepth);
+    if (misses < missesIn) {
+        indices.swap(optimized);
+    } else {
+        misses = missesIn;
+    }
+
+    OptimizeVertexFetch(pMesh, indices);
+    for (unsigned int f = 0; f < pMesh->mNumFaces; ++f) {
+        std::copy(&indices[f * 3], &indices[f * 3] + 3, pMesh->mFaces[f].mIndices);
+    }
+
+    return static_cast<ai_real>(misses) / static_cast<ai_real>(pMesh->mNumFaces);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Computes the average cache miss ratio of a triangle mesh
+ai_real ImproveCacheLocalityProcess::CalculateACMR(const aiMesh *pMesh, unsigned int cacheSize) {
+    if (!IsTriangleMesh(pMesh)) {
+        return 0.0;
+    }
+    std::vector<unsigned int> indices;
+    CollectIndices(pMesh, indices);
+    const unsigned int misses = CountCacheMisses(indices, pMesh->mNumVertices, cacheSize);
+    return static_cast<ai_real>(misses) / static_cast<ai_real>(pMesh->mNumFaces);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Computes the average transform to vertex ratio of a triangle mesh
+ai_real ImproveCacheLocalityProcess::CalculateATVR(const aiMesh *pMesh, unsigned int cacheSize) {
+    if (!IsTriangleMesh(pMesh)) {
+        return 0.0;
+    }
+    std::vector<unsigned int> indices;
+    CollectIndices(pMesh, indices);
+    unsigned int referenced = 0;
+    const unsigned int misses = CountCacheMisses(indices, pMesh->mNumVertices, cacheSize, &referenced);
+    return static_cast<ai_real>(misses) / static_cast<ai_real>(referenced);
+}
@@ -0,0 +1,142 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file Defines a post processing step to reorder faces and vertices
+ *  for a better use of the post-transform vertex cache
+ */
+#ifndef AI_IMPROVECACHELOCALITYPROCESS_H_INC
+#define AI_IMPROVECACHELOCALITYPROCESS_H_INC
+
+#include "Common/BaseProcess.h"
+#include <assimp/types.h>
+
+struct aiMesh;
+
+namespace Assimp {
+
+// ---------------------------------------------------------------------------
+/** The ImproveCacheLocalityProcess reorders the triangles of all meshes to
+ * improve the hit rate of the post-transform vertex cache of the GPU, using
+ * Tom Forsyth's linear-speed vertex cache optimisation. Afterwards the
+ * vertices are renumbered in the order of their first use by the faces, so
+ * that vertex fetches run mostly sequentially through memory.
+ * Meshes with non-triangle faces are left untouched.
+ */
+class ImproveCacheLocalityProcess : public BaseProcess {
+public:
+    // -------------------------------------------------------------------
+    /// The default class constructor / destructor.
+    ImproveCacheLocalityProcess();
+    ~ImproveCacheLocalityProcess() override = default;
+
+    // -------------------------------------------------------------------
+    /** Returns whether the processing step is present in the given flag field.
+     * @param pFlags The processing flags the importer was called with. A bitwise
+     *   combination of #aiPostProcessSteps.
+     * @return true if the process is present in this flag fields, false if not.
+    */
+    bool IsActive( unsigned int pFlags) const override;
+
+    // -------------------------------------------------------------------
+    /** Called prior to ExecuteOnScene().
+    * The function is a request to the process to update its configuration
+    * basing on the Importer's configuration property list.
+    */
+    void SetupProperties(const Importer* pImp) override;
+
+    // -------------------------------------------------------------------
+    /** Executes the post processing step on the given imported data.
+    * At the moment a process is not supposed to fail.
+    * @param pScene The imported data to work at.
+    */
+    void Execute( aiScene* pScene) override;
+
+    // -------------------------------------------------------------------
+    /** The step processes each mesh on its own.
+     * @see BaseProcess::IsPerMeshStep()
+     */
+    bool IsPerMeshStep() const override;
+
+    // -------------------------------------------------------------------
+    /** Executes the post processing step on a single mesh.
+     * @param pScene The imported data to work at.
+     * @param meshIndex The index of the mesh to process.
+     */
+    void ExecutePerMesh( aiScene* pScene, unsigned int meshIndex) override;
+
+    // -------------------------------------------------------------------
+    /** Optimizes the face and vertex order of a single mesh.
+     * @param pMesh The mesh to process.
+     * @return The average cache miss ratio of the mesh afterwards, 0 if
+     *   the mesh could not be processed.
+     */
+    ai_real ProcessMesh( aiMesh* pMesh);
+
+    // -------------------------------------------------------------------
+    /** Computes the average cache miss ratio (ACMR) of a triangle mesh,
+     *  the number of vertex shader invocations per triangle when rendered
+     *  with a FIFO cache of the given size. It ranges from 3 (no reuse at
+     *  all) down to about 0.5 for a regular grid.
+     * @param pMesh The mesh, all faces must be triangles.
+     * @param cacheSize The size of the vertex cache, in vertices.
+     * @return The ACMR of the mesh.
+     */
+    static ai_real CalculateACMR( const aiMesh* pMesh, unsigned int cacheSize);
+
+    // -------------------------------------------------------------------
+    /** Computes the average transform to vertex ratio (ATVR) of a triangle
+     *  mesh, the number of vertex shader invocations per referenced vertex.
+     *  1 is the optimum, every vertex is transformed exactly once.
+     * @param pMesh The mesh, all faces must be triangles.
+     * @param cacheSize The size of the vertex cache, in vertices.
+     * @return The ATVR of the mesh.
+     */
+    static ai_real CalculateATVR( const aiMesh* pMesh, unsigned int cacheSize);
+
+private:
+    /** Configuration option: size of the post-transform vertex cache */
+    unsigned int mConfigCacheDepth;
+};
+
+} // end of namespace Assimp
+
+#endif // AI_IMPROVECACHELOCALITYPROCESS_H_INC
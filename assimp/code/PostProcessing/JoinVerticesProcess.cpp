@@ -0,0 +1,393 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file Implementation of the post processing step to join identical
+ *  vertices for all imported meshes.
+ */
+
+#include "JoinVerticesProcess.h"
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+using namespace Assimp;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Cell of the position hash. In exact mode it holds the bit patterns of the coordinates,
+// otherwise the coordinates quantized to the epsilon.
+struct VertexKey {
+    int64_t x, y, z;
+
+    bool operator==(const VertexKey &other) const {
+        return x == other.x && y == other.y && z == other.z;
+    }
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey &key) const {
+        uint64_t hash = static_cast<uint64_t>(key.x) * 0x9e3779b97f4a7c15ull;
+        hash = (hash ^ (hash >> 29) ^ static_cast<uint64_t>(key.y)) * 0xbf58476d1ce4e5b9ull;
+        hash = (hash ^ (hash >> 32) ^ static_cast<uint64_t>(key.z)) * 0x94d049bb133111ebull;
+        return static_cast<size_t>(hash ^ (hash >> 31));
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+// Bone weights of all vertices, the weights of vertex i are entries[offsets[i]] to entries[offsets[i+1]]
+struct VertexWeights {
+    std::vector<unsigned int> offsets;
+    std::vector<std::pair<unsigned int, ai_real>> entries;
+};
+
+static const unsigned int NoVertex = ~0u;
+
+// ------------------------------------------------------------------------------------------------
+int64_t GetExactKey(ai_real value) {
+    // -0 and +0 compare equal, so they must share a key
+    value += ai_real(0.0);
+    int64_t bits = 0;
+    ::memcpy(&bits, &value, sizeof(ai_real));
+    return bits;
+}
+
+// ------------------------------------------------------------------------------------------------
+int64_t GetCellKey(ai_real value, ai_real epsilon) {
+    const double cell = std::floor(static_cast<double>(value) / epsilon);
+    if (!(cell > -4e18)) {
+        return cell != cell ? 0 : -4000000000000000000ll;
+    }
+    return cell < 4e18 ? static_cast<int64_t>(cell) : 4000000000000000000ll;
+}
+
+// ------------------------------------------------------------------------------------------------
+inline bool IsEqual(ai_real a, ai_real b, ai_real epsilon) {
+    return epsilon == 0 ? a == b : std::abs(a - b) <= epsilon;
+}
+
+inline bool IsEqual(const aiVector3D &a, const aiVector3D &b, ai_real epsilon) {
+    return IsEqual(a.x, b.x, epsilon) && IsEqual(a.y, b.y, epsilon) && IsEqual(a.z, b.z, epsilon);
+}
+
+inline bool IsEqual(const aiVector3D *array, unsigned int a, unsigned int b, ai_real epsilon) {
+    return nullptr == array || IsEqual(array[a], array[b], epsilon);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Compare all attributes of two vertices of a mesh
+bool IsEqualVertex(const aiMesh *mesh, const VertexWeights &weights, unsigned int a, unsigned int b, ai_real epsilon) {
+    if (!IsEqual(mesh->mVertices, a, b, epsilon) ||
+            !IsEqual(mesh->mNormals, a, b, epsilon) ||
+            !IsEqual(mesh->mTangents, a, b, epsilon) ||
+            !IsEqual(mesh->mBitangents, a, b, epsilon)) {
+        return false;
+    }
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        if (!IsEqual(mesh->mTextureCoords[i], a, b, epsilon)) {
+            return false;
+        }
+    }
+
+    if (!weights.offsets.empty()) {
+        const unsigned int count = weights.offsets[a + 1] - weights.offsets[a];
+        if (count != weights.offsets[b + 1] - weights.offsets[b]) {
+            return false;
+        }
+        for (unsigned int i = 0; i < count; ++i) {
+            const std::pair<unsigned int, ai_real> &wa = weights.entries[weights.offsets[a] + i];
+            const std::pair<unsigned int, ai_real> &wb = weights.entries[weights.offsets[b] + i];
+            if (wa.first != wb.first || !IsEqual(wa.second, wb.second, epsilon)) {
+                return false;
+            }
+        }
+    }
+
+    for (unsigned int m = 0; m < mesh->mNumAnimMeshes; ++m) {
+        const aiAnimMesh *animMesh = mesh->mAnimMeshes[m];
+        if (!IsEqual(animMesh->mVertices, a, b, epsilon) ||
+                !IsEqual(animMesh->mNormals, a, b, epsilon) ||
+                !IsEqual(animMesh->mTangents, a, b, epsilon) ||
+                !IsEqual(animMesh->mBitangents, a, b, epsilon)) {
+            return false;
+        }
+        for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+            if (!IsEqual(animMesh->mTextureCoords[i], a, b, epsilon)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Gather the bone weights per vertex, in the order of the bones
+void CollectVertexWeights(const aiMesh *mesh, VertexWeights &weights) {
+    if (!mesh->HasBones()) {
+        return;
+    }
+
+    weights.offsets.assign(mesh->mNumVertices + 1, 0);
+    for (unsigned int b = 0; b < mesh->mNumBones; ++b) {
+        const aiBone *bone = mesh->mBones[b];
+        for (unsigned int w = 0; w < bone->mNumWeights; ++w) {
+            if (bone->mWeights[w].mVertexId < mesh->mNumVertices) {
+                ++weights.offsets[bone->mWeights[w].mVertexId + 1];
+            }
+        }
+    }
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        weights.offsets[i + 1] += weights.offsets[i];
+    }
+
+    weights.entries.resize(weights.offsets.back());
+    std::vector<unsigned int> cursor(weights.offsets.begin(), weights.offsets.end() - 1);
+    for (unsigned int b = 0; b < mesh->mNumBones; ++b) {
+        const aiBone *bone = mesh->mBones[b];
+        for (unsigned int w = 0; w < bone->mNumWeights; ++w) {
+            const aiVertexWeight &weight = bone->mWeights[w];
+            if (weight.mVertexId < mesh->mNumVertices) {
+                weights.entries[cursor[weight.mVertexId]++] = std::make_pair(b, weight.mWeight);
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Replace a vertex attribute array by the values of the unique vertices
+template <typename T>
+void CompactArray(T *&array, const std::vector<unsigned int> &uniqueVertices) {
+    if (nullptr == array) {
+        return;
+    }
+    T *compacted = new T[uniqueVertices.size()];
+    for (size_t i = 0; i < uniqueVertices.size(); ++i) {
+        compacted[i] = array[uniqueVertices[i]];
+    }
+    delete[] array;
+    array = compacted;
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+// Constructor to be privately used by Importer
+JoinVerticesProcess::JoinVerticesProcess() :
+        mEpsilon(0) {
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the processing step is present in the given flag field.
+bool JoinVerticesProcess::IsActive(unsigned int pFlags) const {
+    return (pFlags & aiProcess_JoinIdenticalVertices) != 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// The step joins indexed meshes as well
+bool JoinVerticesProcess::RequireVerboseFormat() const {
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Setup properties for the step
+void JoinVerticesProcess::SetupProperties(const Importer *pImp) {
+    mEpsilon = std::max(pImp->GetPropertyFloat(AI_CONFIG_PP_JIV_EPSILON, 0.f), (ai_real)0.0);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given imported data.
+void JoinVerticesProcess::Execute(aiScene *pScene) {
+    for (unsigned int a = 0; a < pScene->mNumMeshes; ++a) {
+        ProcessMesh(pScene->mMeshes[a]);
+    }
+    FinishPerMesh(pScene);
+}
+
+// ------------------------------------------------------------------------------------------------
+// The step processes each mesh on its own
+bool JoinVerticesProcess::IsPerMeshStep() const {
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on a single mesh
+void JoinVerticesProcess::ExecutePerMesh(aiScene *pScene, unsigned int meshIndex) {
+    ProcessMesh(pScene->mMeshes[meshIndex]);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Vertices may be shared between faces from now on
+void JoinVerticesProcess::FinishPerMesh(aiScene *pScene) {
+    pScene->mFlags |= AI_SCENE_FLAGS_NON_VERBOSE_FORMAT;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Unites identical vertices in the given mesh
+unsigned int JoinVerticesProcess::ProcessMesh(aiMesh *pMesh) {
+    const unsigned int numVertices = pMesh->mNumVertices;
+    if (!pMesh->HasPositions() || !pMesh->HasFaces()) {
+        return numVertices;
+    }
+    for (unsigned int m = 0; m < pMesh->mNumAnimMeshes; ++m) {
+        if (pMesh->mAnimMeshes[m]->mNumVertices != numVertices) {
+            return numVertices;
+        }
+    }
+
+    VertexWeights weights;
+    CollectVertexWeights(pMesh, weights);
+
+    // the unique vertices of each cell are chained, newest first
+    std::unordered_map<VertexKey, unsigned int, VertexKeyHash> cells;
+    cells.reserve(numVertices);
+    std::vector<unsigned int> nextInCell;
+    nextInCell.reserve(numVertices);
+
+    std::vector<unsigned int> uniqueVertices;
+    uniqueVertices.reserve(numVertices);
+    std::vector<unsigned int> replaceIndex(numVertices);
+
+    // with an epsilon, equal vertices may lie in any of the neighbouring cells
+    const int range = mEpsilon > 0 ? 1 : 0;
+    for (unsigned int v = 0; v < numVertices; ++v) {
+        const aiVector3D &position = pMesh->mVertices[v];
+        VertexKey key;
+        if (mEpsilon > 0) {
+            key.x = GetCellKey(position.x, mEpsilon);
+            key.y = GetCellKey(position.y, mEpsilon);
+            key.z = GetCellKey(position.z, mEpsilon);
+        } else {
+            key.x = GetExactKey(position.x);
+            key.y = GetExactKey(position.y);
+            key.z = GetExactKey(position.z);
+        }
+
+        unsigned int found = NoVertex;
+        for (int dx = -range; dx <= range && found == NoVertex; ++dx) {
+            for (int dy = -range; dy <= range && found == NoVertex; ++dy) {
+                for (int dz = -range; dz <= range && found == NoVertex; ++dz) {
+                    const VertexKey cell = { key.x + dx, key.y + dy, key.z + dz };
+                    auto it = cells.find(cell);
+                    if (it == cells.end()) {
+                        continue;
+                    }
+                    for (unsigned int u = it->second; u != NoVertex; u = nextInCell[u]) {
+                        if (IsEqualVertex(pMesh, weights, uniqueVertices[u], v, mEpsilon)) {
+                            found = u;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (found != NoVertex) {
+            replaceIndex[v] = found;
+            continue;
+        }
+
+        const unsigned int unique = static_cast<unsigned int>(uniqueVertices.size());
+        auto it = cells.emplace(key, NoVertex).first;
+        nextInCell.push_back(it->second);
+        it->second = unique;
+        uniqueVertices.push_back(v);
+        replaceIndex[v] = unique;
+    }
+
+    if (uniqueVertices.size() == numVertices) {
+        return numVertices;
+    }
+
+    // replace the vertex data by the unique vertices
+    CompactArray(pMesh->mVertices, uniqueVertices);
+    CompactArray(pMesh->mNormals, uniqueVertices);
+    CompactArray(pMesh->mTangents, uniqueVertices);
+    CompactArray(pMesh->mBitangents, uniqueVertices);
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        CompactArray(pMesh->mTextureCoords[i], uniqueVertices);
+    }
+    for (unsigned int m = 0; m < pMesh->mNumAnimMeshes; ++m) {
+        aiAnimMesh *animMesh = pMesh->mAnimMeshes[m];
+        CompactArray(animMesh->mVertices, uniqueVertices);
+        CompactArray(animMesh->mNormals, uniqueVertices);
+        CompactArray(animMesh->mTangents, uniqueVertices);
+        CompactArray(animMesh->mBitangents, uniqueVertices);
+        for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+            CompactArray(animMesh->mTextureCoords[i], uniqueVertices);
+        }
+        animMesh->mNumVertices = static_cast<unsigned int>(uniqueVertices.size());
+    }
+    pMesh->mNumVertices = static_cast<unsigned int>(uniqueVertices.size());
+
+    // adjust the indices of all faces
+    for (unsigned int f = 0; f < pMesh->mNumFaces; ++f) {
+        aiFace &face = pMesh->mFaces[f];
+        for (unsigned int i = 0; i < face.mNumIndices; ++i) {
+            face.mIndices[i] = replaceIndex[face.mIndices[i]];
+        }
+    }
+
+    // joined vertices carry the same weights, keep those of the unique vertex only
+    for (unsigned int b = 0; b < pMesh->mNumBones; ++b) {
+        aiBone *bone = pMesh->mBones[b];
+        unsigned int numWeights = 0;
+        for (unsigned int w = 0; w < bone->mNumWeights; ++w) {
+            const unsigned int vertexId = bone->mWeights[w].mVertexId;
+            if (vertexId < numVertices && uniqueVertices[replaceIndex[vertexId]] == vertexId) {
+                bone->mWeights[numWeights].mVertexId = replaceIndex[vertexId];
+                bone->mWeights[numWeights].mWeight = bone->mWeights[w].mWeight;
+                ++numWeights;
+            }
+        }
+        bone->mNumWeights = numWeights;
+    }
+
+    return pMesh->mNumVertices;
+}
@@ -70,6 +70,18 @@ void LimitBoneWeightsProcess::Execute( aiScene* pScene) {
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// The step processes each mesh on its own
+bool LimitBoneWeightsProcess::IsPerMeshStep() const {
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on a single mesh
+void LimitBoneWeightsProcess::ExecutePerMesh( aiScene* pScene, unsigned int meshIndex) {
+    ProcessMesh(pScene->mMeshes[meshIndex]);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 void LimitBoneWeightsProcess::SetupProperties(const Importer* pImp) {
@@ -249,6 +249,7 @@ void TextureTransformStep::Execute( aiScene* pScene) {
                         ::memcpy(&info.mTranslation.x,prop2->mData,sizeof(float)*5);
 
                         // Directly remove this property from the list
+                        mat->ClearPropertyIndex();
                         mat->mNumProperties--;
                         for (unsigned int a3 = a2; a3 < mat->mNumProperties;++a3) {
                             mat->mProperties[a3] = mat->mProperties[a3+1];
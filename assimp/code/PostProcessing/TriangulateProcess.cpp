@@ -63,7 +63,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PostProcessing/ProcessHelper.h"
 #include "Common/PolyTools.h"
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 //#define AI_BUILD_TRIANGULATE_COLOR_FACE_WINDING
 //#define AI_BUILD_TRIANGULATE_DEBUG_POLYS
@@ -146,6 +148,446 @@ namespace {
         unsigned int mLastNGONFirstIndex;
     };
 
+    /**
+     * @brief Polygons with more vertices than this are triangulated by the LargePolygonTriangulator.
+     */
+    const int LargePolygonThreshold = 64;
+
+    /**
+     * @brief Ear clipping for polygons with many vertices, following the earcut algorithm.
+     *
+     * The vertices are sorted along a z-order curve, so an ear is only tested against the
+     * vertices inside its bounding box instead of the whole polygon. If no ear is found,
+     * duplicate and collinear vertices are removed, local self-intersections are cut off and
+     * finally the polygon is split along a valid diagonal.
+     */
+    class LargePolygonTriangulator {
+    public:
+        /**
+         * @brief Triangulates a projected polygon.
+         *
+         * @param pts The 2d vertices of the polygon.
+         * @param num Number of vertices.
+         * @param out Receives at most num-2 triangles, indexing into pts. The triangles keep the
+         *   winding order of the polygon.
+         * @return The number of triangles written.
+         */
+        unsigned int Triangulate(const aiVector2D *pts, unsigned int num, aiFace *out) {
+            mOut = out;
+            mNumOut = 0;
+            mMaxOut = num - 2;
+            mBlocks.resize(1);
+            mBlocks[0].clear();
+            mBlocks[0].reserve(num * 3);
+
+            // build the ring so that the ears have a negative area
+            double area = 0.0;
+            for (unsigned int i = 0, j = num - 1; i < num; j = i++) {
+                area += ((double)pts[j].x - pts[i].x) * ((double)pts[i].y + pts[j].y);
+            }
+            mReversed = area <= 0.0;
+            Node *last = nullptr;
+            for (unsigned int k = 0; k < num; ++k) {
+                const unsigned int i = mReversed ? num - 1 - k : k;
+                last = InsertNode(i, pts[i].x, pts[i].y, last);
+            }
+            if (nullptr != last && Equals(last, last->next)) {
+                RemoveNode(last);
+                last = last->next;
+            }
+            if (nullptr == last || last->next == last->prev) {
+                return 0;
+            }
+
+            // the z-order range covers the bounding box of the polygon
+            mMinX = mMaxX = pts[0].x;
+            mMinY = mMaxY = pts[0].y;
+            for (unsigned int i = 1; i < num; ++i) {
+                mMinX = std::min(mMinX, (double)pts[i].x);
+                mMinY = std::min(mMinY, (double)pts[i].y);
+                mMaxX = std::max(mMaxX, (double)pts[i].x);
+                mMaxY = std::max(mMaxY, (double)pts[i].y);
+            }
+            const double size = std::max(mMaxX - mMinX, mMaxY - mMinY);
+            mInvSize = size != 0.0 ? 32767.0 / size : 0.0;
+
+            EarcutLinked(last, 0);
+            return mNumOut;
+        }
+
+    private:
+        struct Node {
+            unsigned int i;
+            double x, y;
+            Node *prev, *next;
+            uint32_t z;
+            Node *prevZ, *nextZ;
+        };
+
+        Node *InsertNode(unsigned int i, double x, double y, Node *last) {
+            if (mBlocks.back().size() == mBlocks.back().capacity()) {
+                // more splits than estimated, add a block instead of moving the linked nodes
+                const size_t capacity = mBlocks.back().capacity();
+                mBlocks.emplace_back();
+                mBlocks.back().reserve(std::max<size_t>(capacity, 64));
+            }
+            std::vector<Node> &block = mBlocks.back();
+            block.push_back({ i, x, y, nullptr, nullptr, 0, nullptr, nullptr });
+            Node *p = &block.back();
+            if (nullptr == last) {
+                p->prev = p;
+                p->next = p;
+            } else {
+                p->next = last->next;
+                p->prev = last;
+                last->next->prev = p;
+                last->next = p;
+            }
+            return p;
+        }
+
+        static void RemoveNode(Node *p) {
+            p->next->prev = p->prev;
+            p->prev->next = p->next;
+            if (p->prevZ) {
+                p->prevZ->nextZ = p->nextZ;
+            }
+            if (p->nextZ) {
+                p->nextZ->prevZ = p->prevZ;
+            }
+        }
+
+        static double Area(const Node *p, const Node *q, const Node *r) {
+            return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+        }
+
+        static bool Equals(const Node *a, const Node *b) {
+            return a->x == b->x && a->y == b->y;
+        }
+
+        static bool PointInTriangle(const Node *a, const Node *b, const Node *c, const Node *p) {
+            return (c->x - p->x) * (a->y - p->y) >= (a->x - p->x) * (c->y - p->y) &&
+                   (a->x - p->x) * (b->y - p->y) >= (b->x - p->x) * (a->y - p->y) &&
+                   (b->x - p->x) * (c->y - p->y) >= (c->x - p->x) * (b->y - p->y);
+        }
+
+        static int Sign(double v) {
+            return (v > 0.0) - (v < 0.0);
+        }
+
+        static bool OnSegment(const Node *p, const Node *q, const Node *r) {
+            return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x) &&
+                   q->y <= std::max(p->y, r->y) && q->y >= std::min(p->y, r->y);
+        }
+
+        static bool Intersects(const Node *p1, const Node *q1, const Node *p2, const Node *q2) {
+            const int o1 = Sign(Area(p1, q1, p2));
+            const int o2 = Sign(Area(p1, q1, q2));
+            const int o3 = Sign(Area(p2, q2, p1));
+            const int o4 = Sign(Area(p2, q2, q1));
+            return (o1 != o2 && o3 != o4) ||
+                   (0 == o1 && OnSegment(p1, p2, q1)) || (0 == o2 && OnSegment(p1, q2, q1)) ||
+                   (0 == o3 && OnSegment(p2, p1, q2)) || (0 == o4 && OnSegment(p2, q1, q2));
+        }
+
+        static bool IntersectsPolygon(const Node *a, const Node *b) {
+            const Node *p = a;
+            do {
+                if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i &&
+                        Intersects(p, p->next, a, b)) {
+                    return true;
+                }
+                p = p->next;
+            } while (p != a);
+            return false;
+        }
+
+        static bool LocallyInside(const Node *a, const Node *b) {
+            return Area(a->prev, a, a->next) < 0.0 ?
+                    Area(a, b, a->next) >= 0.0 && Area(a, a->prev, b) >= 0.0 :
+                    Area(a, b, a->prev) < 0.0 || Area(a, a->next, b) < 0.0;
+        }
+
+        static bool MiddleInside(const Node *a, const Node *b) {
+            const Node *p = a;
+            bool inside = false;
+            const double px = (a->x + b->x) / 2.0, py = (a->y + b->y) / 2.0;
+            do {
+                if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+                        (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x)) {
+                    inside = !inside;
+                }
+                p = p->next;
+            } while (p != a);
+            return inside;
+        }
+
+        static bool IsValidDiagonal(const Node *a, const Node *b) {
+            return a->next->i != b->i && a->prev->i != b->i && !IntersectsPolygon(a, b) &&
+                   ((LocallyInside(a, b) && LocallyInside(b, a) && MiddleInside(a, b) &&
+                            (Area(a->prev, a, b->prev) != 0.0 || Area(a, b->prev, b) != 0.0)) ||
+                           (Equals(a, b) && Area(a->prev, a, a->next) > 0.0 && Area(b->prev, b, b->next) > 0.0));
+        }
+
+        uint32_t ZOrder(double x, double y) const {
+            uint32_t ix = static_cast<uint32_t>((x - mMinX) * mInvSize);
+            uint32_t iy = static_cast<uint32_t>((y - mMinY) * mInvSize);
+
+            ix = (ix | (ix << 8)) & 0x00FF00FF;
+            ix = (ix | (ix << 4)) & 0x0F0F0F0F;
+            ix = (ix | (ix << 2)) & 0x33333333;
+            ix = (ix | (ix << 1)) & 0x55555555;
+
+            iy = (iy | (iy << 8)) & 0x00FF00FF;
+            iy = (iy | (iy << 4)) & 0x0F0F0F0F;
+            iy = (iy | (iy << 2)) & 0x33333333;
+            iy = (iy | (iy << 1)) & 0x55555555;
+
+            return ix | (iy << 1);
+        }
+
+        void Emit(const Node *a, const Node *b, const Node *c) {
+            if (mNumOut == mMaxOut) {
+                return;
+            }
+            aiFace &face = mOut[mNumOut++];
+            face.mNumIndices = 3;
+            if (!face.mIndices) {
+                face.mIndices = new unsigned int[3];
+            }
+            face.mIndices[0] = mReversed ? c->i : a->i;
+            face.mIndices[1] = b->i;
+            face.mIndices[2] = mReversed ? a->i : c->i;
+        }
+
+        // Removes duplicate and collinear vertices between start and end
+        static Node *FilterPoints(Node *start, Node *end = nullptr) {
+            if (nullptr == end) {
+                end = start;
+            }
+            Node *p = start;
+            bool again;
+            do {
+                again = false;
+                if (Equals(p, p->next) || Area(p->prev, p, p->next) == 0.0) {
+                    RemoveNode(p);
+                    p = end = p->prev;
+                    if (p == p->next) {
+                        break;
+                    }
+                    again = true;
+                } else {
+                    p = p->next;
+                }
+            } while (again || p != end);
+            return end;
+        }
+
+        // Links the vertices along the z-order curve
+        void IndexCurve(Node *start) {
+            Node *p = start;
+            do {
+                p->z = ZOrder(p->x, p->y);
+                p->prevZ = p->prev;
+                p->nextZ = p->next;
+                p = p->next;
+            } while (p != start);
+            p->prevZ->nextZ = nullptr;
+            p->prevZ = nullptr;
+            SortLinked(p);
+        }
+
+        // Bottom-up merge sort of the z-order list
+        static Node *SortLinked(Node *list) {
+            unsigned int inSize = 1;
+            unsigned int numMerges;
+            do {
+                Node *p = list;
+                Node *tail = nullptr;
+                list = nullptr;
+                numMerges = 0;
+                while (p) {
+                    ++numMerges;
+                    Node *q = p;
+                    unsigned int pSize = 0;
+                    for (unsigned int i = 0; i < inSize && q; ++i) {
+                        ++pSize;
+                        q = q->nextZ;
+                    }
+                    unsigned int qSize = inSize;
+                    while (pSize > 0 || (qSize > 0 && q)) {
+                        Node *e;
+                        if (pSize != 0 && (qSize == 0 || !q || p->z <= q->z)) {
+                            e = p;
+                            p = p->nextZ;
+                            --pSize;
+                        } else {
+                            e = q;
+                            q = q->nextZ;
+                            --qSize;
+                        }
+                        if (tail) {
+                            tail->nextZ = e;
+                        } else {
+                            list = e;
+                        }
+                        e->prevZ = tail;
+                        tail = e;
+                    }
+                    p = q;
+                }
+                tail->nextZ = nullptr;
+                inSize *= 2;
+            } while (numMerges > 1);
+            return list;
+        }
+
+        bool IsEar(const Node *ear) const {
+            const Node *a = ear->prev, *b = ear, *c = ear->next;
+            if (Area(a, b, c) >= 0.0) {
+                return false; // reflex
+            }
+
+            // only vertices inside the bounding box of the triangle can be in it
+            const double minTX = std::min(a->x, std::min(b->x, c->x));
+            const double minTY = std::min(a->y, std::min(b->y, c->y));
+            const double maxTX = std::max(a->x, std::max(b->x, c->x));
+            const double maxTY = std::max(a->y, std::max(b->y, c->y));
+            const uint32_t minZ = ZOrder(minTX, minTY);
+            const uint32_t maxZ = ZOrder(maxTX, maxTY);
+
+            auto blocks = [&](const Node *p) {
+                return p->x >= minTX && p->x <= maxTX && p->y >= minTY && p->y <= maxTY &&
+                       p != a && p != c && !Equals(p, a) && !Equals(p, c) && PointInTriangle(a, b, c, p) &&
+                       Area(p->prev, p, p->next) >= 0.0;
+            };
+
+            // look for points in both directions of the z-order curve
+            const Node *p = ear->prevZ;
+            const Node *n = ear->nextZ;
+            while (p && p->z >= minZ && n && n->z <= maxZ) {
+                if (blocks(p)) {
+                    return false;
+                }
+                p = p->prevZ;
+                if (blocks(n)) {
+                    return false;
+                }
+                n = n->nextZ;
+            }
+            for (; p && p->z >= minZ; p = p->prevZ) {
+                if (blocks(p)) {
+                    return false;
+                }
+            }
+            for (; n && n->z <= maxZ; n = n->nextZ) {
+                if (blocks(n)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Cuts off triangles which belong to local self-intersections
+        Node *CureLocalIntersections(Node *start) {
+            Node *p = start;
+            do {
+                Node *a = p->prev, *b = p->next->next;
+                if (!Equals(a, b) && Intersects(a, p, p->next, b) && LocallyInside(a, b) && LocallyInside(b, a)) {
+                    Emit(a, p, b);
+                    RemoveNode(p);
+                    RemoveNode(p->next);
+                    p = start = b;
+                }
+                p = p->next;
+            } while (p != start);
+            return FilterPoints(p);
+        }
+
+        // Links a to b with a diagonal, which splits the ring into two
+        Node *SplitPolygon(Node *a, Node *b) {
+            Node *a2 = InsertNode(a->i, a->x, a->y, nullptr);
+            Node *b2 = InsertNode(b->i, b->x, b->y, nullptr);
+            Node *an = a->next;
+            Node *bp = b->prev;
+
+            a->next = b;
+            b->prev = a;
+            a2->next = an;
+            an->prev = a2;
+            b2->next = a2;
+            a2->prev = b2;
+            bp->next = b2;
+            b2->prev = bp;
+            return b2;
+        }
+
+        void SplitEarcut(Node *start) {
+            Node *a = start;
+            do {
+                Node *b = a->next->next;
+                while (b != a->prev) {
+                    if (a->i != b->i && IsValidDiagonal(a, b)) {
+                        Node *c = SplitPolygon(a, b);
+                        a = FilterPoints(a, a->next);
+                        c = FilterPoints(c, c->next);
+                        EarcutLinked(a, 0);
+                        EarcutLinked(c, 0);
+                        return;
+                    }
+                    b = b->next;
+                }
+                a = a->next;
+            } while (a != start);
+        }
+
+        void EarcutLinked(Node *ear, int pass) {
+            if (nullptr == ear) {
+                return;
+            }
+            if (0 == pass) {
+                IndexCurve(ear);
+            }
+
+            Node *stop = ear;
+            while (ear->prev != ear->next) {
+                Node *prev = ear->prev;
+                Node *next = ear->next;
+                if (IsEar(ear)) {
+                    Emit(prev, ear, next);
+                    RemoveNode(ear);
+
+                    // skipping the next vertex leads to less sliver triangles
+                    ear = next->next;
+                    stop = next->next;
+                    continue;
+                }
+                ear = next;
+
+                // no ear found in a whole loop, try to clean up the polygon
+                if (ear == stop) {
+                    if (0 == pass) {
+                        EarcutLinked(FilterPoints(ear), 1);
+                    } else if (1 == pass) {
+                        EarcutLinked(CureLocalIntersections(FilterPoints(ear)), 2);
+                    } else {
+                        SplitEarcut(ear);
+                    }
+                    break;
+                }
+            }
+        }
+
+        // the nodes are linked by pointer, so a block is never grown beyond its capacity
+        std::vector<std::vector<Node>> mBlocks;
+        aiFace *mOut = nullptr;
+        unsigned int mNumOut = 0;
+        unsigned int mMaxOut = 0;
+        bool mReversed = false;
+        double mMinX = 0.0, mMinY = 0.0, mMaxX = 0.0, mMaxY = 0.0;
+        double mInvSize = 0.0;
+    };
+
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -170,6 +612,20 @@ void TriangulateProcess::Execute( aiScene* pScene)
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// The step processes each mesh on its own
+bool TriangulateProcess::IsPerMeshStep() const
+{
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on a single mesh
+void TriangulateProcess::ExecutePerMesh( aiScene* pScene, unsigned int meshIndex)
+{
+    TriangulateMesh( pScene->mMeshes[ meshIndex ] );
+}
+
 // ------------------------------------------------------------------------------------------------
 // Triangulates the given mesh.
 bool TriangulateProcess::TriangulateMesh( aiMesh* pMesh)
@@ -231,6 +687,7 @@ bool TriangulateProcess::TriangulateMesh( aiMesh* pMesh)
     std::vector<aiVector2D> temp_verts(max_out+2);
 
     NGONEncoder ngonEncoder;
+    LargePolygonTriangulator largePolygonTriangulator;
 
     // Apply vertex colors to represent the face winding?
 #ifdef AI_BUILD_TRIANGULATE_COLOR_FACE_WINDING
@@ -416,6 +873,12 @@ bool TriangulateProcess::TriangulateMesh( aiMesh* pMesh)
             fprintf(fout,"\ntriangulation sequence: ");
 #endif
 
+            // Large polygons are cut along a z-order curve, the loop below is quadratic
+            if (max > LargePolygonThreshold) {
+                curOut += largePolygonTriangulator.Triangulate(&temp_verts.front(), max, curOut);
+                num = 0;
+            }
+
             //
             // FIXME: currently this is the slow O(kn) variant with a worst case
             // complexity of O(n^2) (I think). Can be done in O(n).
@@ -103,17 +103,30 @@ public:
     /// Flush file contents
     void Flush() override;
 
+    // -------------------------------------------------------------------
+    /// @brief  Maps the whole file read-only into memory.
+    /// @return Pointer to the first byte of the file, nullptr if the
+    ///         platform or the file does not support mapping. The
+    ///         mapping stays valid until the stream is closed.
+    const char *Map();
+
 private:
+    void Unmap();
+
     FILE* mFile;
     std::string mFilename;
     mutable size_t mCachedSize;
+    void *mMappedData;
+    size_t mMappedSize;
 };
 
 // ----------------------------------------------------------------------------------
 AI_FORCE_INLINE DefaultIOStream::DefaultIOStream() AI_NO_EXCEPT :
         mFile(nullptr),
         mFilename(),
-        mCachedSize(SIZE_MAX) {
+        mCachedSize(SIZE_MAX),
+        mMappedData(nullptr),
+        mMappedSize(0) {
     // empty
 }
 
@@ -121,7 +134,9 @@ AI_FORCE_INLINE DefaultIOStream::DefaultIOStream() AI_NO_EXCEPT :
 AI_FORCE_INLINE DefaultIOStream::DefaultIOStream (FILE* pFile, const std::string &strFilename) :
         mFile(pFile),
         mFilename(strFilename),
-        mCachedSize(SIZE_MAX) {
+        mCachedSize(SIZE_MAX),
+        mMappedData(nullptr),
+        mMappedSize(0) {
     // empty
 }
 
@@ -246,7 +246,24 @@ AI_FORCE_INLINE bool IOStreamBuffer<T>::getNextDataLine(std::vector<T> &buffer,
 
     size_t i = 0;
     for (;;) {
-        if (continuationToken == m_cache[m_cachePos] && IsLineEnd(m_cache[m_cachePos + 1])) {
+        if (continuationToken == m_cache[m_cachePos] && m_cachePos + 1 == m_cacheSize && m_filePos < m_filesize) {
+            // The token ends the block, the next one tells whether it continues the line
+            if (!readNextBlock()) {
+                return false;
+            }
+            if (!IsLineEnd(m_cache[m_cachePos])) {
+                buffer[i] = continuationToken;
+                ++i;
+                if (i == buffer.size()) {
+                    buffer.resize(buffer.size() * 2);
+                }
+                continue;
+            }
+            while (m_cache[m_cachePos] != '\n') {
+                ++m_cachePos;
+            }
+            ++m_cachePos;
+        } else if (continuationToken == m_cache[m_cachePos] && m_cachePos + 1 < m_cacheSize && IsLineEnd(m_cache[m_cachePos + 1])) {
             ++m_cachePos;
             while (m_cache[m_cachePos] != '\n') {
                 ++m_cachePos;
@@ -232,6 +232,16 @@ public:
      */
     virtual bool DeleteFile(const std::string &file);
 
+    // -------------------------------------------------------------------
+    /**
+     *  @brief  Will rename the given file, replacing the target file if
+     *          the platform allows it.
+     *  @param from     [in] The current filename
+     *  @param to       [in] The new filename
+     *  @return true, if the file was renamed, false if not.
+     */
+    virtual bool RenameFile(const std::string &from, const std::string &to);
+
 private:
     std::vector<std::string> m_pathStack;
 };
@@ -334,6 +344,15 @@ AI_FORCE_INLINE bool IOSystem::DeleteFile( const std::string &file ) {
     const int retCode( ::remove( file.c_str() ) );
     return ( 0 == retCode );
 }
+
+// ----------------------------------------------------------------------------
+AI_FORCE_INLINE bool IOSystem::RenameFile( const std::string &from, const std::string &to ) {
+    if ( from.empty() || to.empty() ) {
+        return false;
+    }
+    const int retCode( ::rename( from.c_str(), to.c_str() ) );
+    return ( 0 == retCode );
+}
 } //!ns Assimp
 
 #endif //AI_IOSYSTEM_H_INC
@@ -56,7 +56,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cstddef>
 #include <cstdint>
 #include <list>
-#include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 struct aiScene;
@@ -137,6 +138,12 @@ struct NodeAttachmentInfo {
  */
 #define AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES_IF_NECESSARY 0x10
 
+/** @def AI_INT_MERGE_SCENE_PARALLEL
+ * Copy and rename the contents of the input scenes on all
+ * hardware threads. The output is the same as without the flag.
+ */
+#define AI_INT_MERGE_SCENE_PARALLEL 0x20
+
 typedef std::pair<aiBone *, unsigned int> BoneSrcIndex;
 
 // ---------------------------------------------------------------------------
@@ -175,7 +182,7 @@ struct SceneHelper {
     unsigned int idlen;
 
     // hash table to quickly check whether a name is contained in the scene
-    std::set<unsigned int> hashes;
+    std::unordered_set<unsigned int> hashes;
 };
 
 // ---------------------------------------------------------------------------
@@ -320,8 +327,37 @@ public:
      *
      *  @param dest Receives a pointer to the destination scene
      *  @param src Source scene - remains unmodified.
+     *  @param shareArrays If true, the vertex, face, bone weight and
+     *    texture data arrays are not copied but shared by source and
+     *    destination scene. Shared arrays are reference counted and are
+     *    copied by the first post-processing step run on either scene,
+     *    see UnshareScene().
+     */
+    static void CopyScene(aiScene **dest, const aiScene *source, bool allocate = true,
+            bool shareArrays = false);
+
+    // -------------------------------------------------------------------
+    /** Give a scene its own copy of all arrays it shares with other
+     *  scenes. If no other scene references them anymore, the arrays
+     *  are taken over without copying.
+     *
+     *  Every post-processing step calls this before it runs, and
+     *  MergeScenes() calls it for all input scenes. Code which writes
+     *  to a scene copied with shared arrays outside of a step, moves
+     *  its meshes or textures to another scene or deletes or replaces
+     *  any of their arrays must call it first.
+     *  @param scene Scene to be modified
+     */
+    static void UnshareScene(aiScene *scene);
+
+    // -------------------------------------------------------------------
+    /** Drop the references of a scene to shared arrays without copying
+     *  them. The pointers to arrays still used by other scenes are reset
+     *  to nullptr, the last user of an array keeps it to free it.
+     *  Called by the scene destructor.
+     *  @param scene Scene to be deleted
      */
-    static void CopyScene(aiScene **dest, const aiScene *source, bool allocate = true);
+    static void ReleaseSharedArrays(aiScene *scene);
 
     // -------------------------------------------------------------------
     /** Get a flat copy of a scene
@@ -362,17 +398,19 @@ private:
     // Same as AddNodePrefixes, but with an additional check
     static void AddNodePrefixesChecked(aiNode *node, const char *prefix,
             unsigned int len,
-            std::vector<SceneHelper> &input,
-            unsigned int cur);
+            const std::unordered_map<unsigned int, unsigned int> &hashCounts,
+            const SceneHelper &cur);
 
     // -------------------------------------------------------------------
     // Add node identifiers to a hashing set
-    static void AddNodeHashes(aiNode *node, std::set<unsigned int> &hashes);
+    static void AddNodeHashes(aiNode *node, std::unordered_set<unsigned int> &hashes);
 
     // -------------------------------------------------------------------
-    // Search for duplicate names
+    // Search for duplicate names. hashCounts holds the number of input
+    // scenes containing each name hash.
     static bool FindNameMatch(const aiString &name,
-            std::vector<SceneHelper> &input, unsigned int cur);
+            const std::unordered_map<unsigned int, unsigned int> &hashCounts,
+            const SceneHelper &cur);
 };
 
 } // namespace Assimp
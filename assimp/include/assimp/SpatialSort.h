@@ -50,6 +50,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <assimp/types.h>
+#include <cstdint>
 #include <vector>
 #include <limits>
 
@@ -61,7 +62,10 @@ namespace Assimp {
  * by their indices and sorts them by their distance to an arbitrary chosen plane.
  * You can then query the instance for all vertices close to a given position in an average O(log n)
  * time, with O(n) worst case complexity when all vertices lay on the plane. The plane is chosen
- * so that it avoids common planes in usual data sets. */
+ * so that it avoids common planes in usual data sets.
+ * If many positions share about the same distance to the plane, as in large or flat meshes,
+ * a uniform grid is built on top of the sorted positions, which brings FindPositions() with
+ * small radii down to O(1). Both ways return the same results in the same order. */
 // ------------------------------------------------------------------------------------------------
 class SpatialSort {
 public:
@@ -146,6 +150,17 @@ protected:
     /** Return the distance to the sorting plane. */
     ai_real CalculateDistance(const aiVector3D &pPosition) const;
 
+    /** Builds the grid if the positions are crowded along the sorting plane. */
+    void BuildGrid();
+
+    /** Return the key of the grid cell containing the given position. */
+    uint64_t CalculateCellKey(const aiVector3D &pPosition) const;
+
+    /** Same as FindPositions(), but searches the grid. Returns false if the query sphere
+     *  spans too many grid cells. */
+    bool FindPositionsInGrid(const aiVector3D &pPosition, ai_real pRadius,
+            std::vector<unsigned int> &poResults) const;
+
 protected:
     /** Normal of the sorting plane, normalized.
      */
@@ -181,6 +196,16 @@ protected:
     // all positions, sorted by distance to the sorting plane
     std::vector<Entry> mPositions;
 
+    /** Optional grid over the positions, as pairs of cell key and index into mPositions,
+     *  sorted by cell key. Empty if only the sorting plane is used. */
+    std::vector<std::pair<uint64_t, unsigned int>> mGrid;
+
+    /** Minimum corner of the grid. */
+    aiVector3D mGridOrigin;
+
+    /** Inverse edge length of the grid cells. */
+    ai_real mGridScale;
+
     /// false until the Finalize method is called.
     bool mFinalized;
 };
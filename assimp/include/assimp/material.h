@@ -920,6 +920,22 @@ public:
     static void CopyPropertyList(aiMaterial *pcDest,
             const aiMaterial *pcSrc);
 
+    // ------------------------------------------------------------------------------
+    /** @brief Builds a hash index over the property list.
+     *
+     *  Lookups with an explicit type and index use the index instead of
+     *  scanning all properties. Materials with only a few properties get
+     *  no index. Adding or removing properties drops the index again, so
+     *  call this once the material is complete. */
+    void BuildPropertyIndex();
+
+    // ------------------------------------------------------------------------------
+    /** @brief Drops the property index.
+     *
+     *  Should be called after modifying #mProperties directly, lookups
+     *  through a stale index are safe but may be slower. */
+    void ClearPropertyIndex();
+
 #endif
 
     /** List of all material properties loaded. */
@@ -930,6 +946,14 @@ public:
 
     /** Storage allocated */
     unsigned int mNumAllocated;
+
+    /** Open-addressing hash table over the properties, NULL if it hasn't
+     *  been built. Each slot is a pair of the property hash and the
+     *  property index plus one, zero marks an empty slot. */
+    unsigned int *mPropertyIndex;
+
+    /** Number of slots in #mPropertyIndex, always a power of two. */
+    unsigned int mNumPropertyIndexSlots;
 };
 
 // Go back to extern "C" again
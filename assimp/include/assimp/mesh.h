@@ -589,6 +589,61 @@ enum aiMorphingMethod {
 #endif
 }; //! enum aiMorphingMethod
 
+// ---------------------------------------------------------------------------
+/** @brief A meshlet is a small cluster of triangles of a mesh, sized for
+ *  GPU mesh shaders and for culling triangles cluster by cluster.
+ *
+ *  The vertices of a meshlet are stored in aiMesh::mMeshletVertices as
+ *  indices into the vertex arrays of the mesh. Its triangles are stored in
+ *  aiMesh::mMeshletTriangles as three 8-bit indices each, which index the
+ *  vertices of the meshlet.
+ */
+struct aiMeshlet {
+    //! Index of the first vertex of the meshlet in aiMesh::mMeshletVertices.
+    unsigned int mVertexOffset;
+
+    //! Index of the first triangle of the meshlet in aiMesh::mMeshletTriangles,
+    //! the local indices of the triangle start at mTriangleOffset * 3.
+    unsigned int mTriangleOffset;
+
+    //! Number of vertices of the meshlet, at most 256.
+    unsigned int mVertexCount;
+
+    //! Number of triangles of the meshlet.
+    unsigned int mTriangleCount;
+
+    //! Center of the bounding sphere of the meshlet.
+    aiVector3D mCenter;
+
+    //! Radius of the bounding sphere of the meshlet.
+    ai_real mRadius;
+
+    //! Apex of the normal cone of the meshlet.
+    aiVector3D mConeApex;
+
+    //! Axis of the normal cone of the meshlet, zero if the triangles face
+    //! too many directions for a useful cone.
+    aiVector3D mConeAxis;
+
+    //! Cutoff of the normal cone. All triangles of the meshlet face away from
+    //! a camera at position p if dot(normalize(mConeApex - p), mConeAxis) >= mConeCutoff.
+    ai_real mConeCutoff;
+
+#ifdef __cplusplus
+
+    //! @brief Default constructor
+    aiMeshlet() AI_NO_EXCEPT
+            : mVertexOffset(0),
+              mTriangleOffset(0),
+              mVertexCount(0),
+              mTriangleCount(0),
+              mRadius(0.0f),
+              mConeCutoff(1.0f) {
+        // empty
+    }
+#endif // __cplusplus
+}; // struct aiMeshlet
+
 // ---------------------------------------------------------------------------
 /** @brief A mesh represents a geometry or model with a single material.
  *
@@ -789,6 +844,52 @@ struct aiMesh {
      */
     aiString **mTextureCoordsNames;
 
+    /**
+     * The number of meshlets of this mesh. Meshlets are only generated
+     * on request, see the #AI_CONFIG_PP_GBB_MESHLETS property.
+     */
+    unsigned int mNumMeshlets;
+
+    /**
+     * The meshlets of this mesh. The array is mNumMeshlets in size.
+     */
+    aiMeshlet *mMeshlets;
+
+    /**
+     * The number of vertex indices referenced by all meshlets.
+     */
+    unsigned int mNumMeshletVertices;
+
+    /**
+     * The vertices of all meshlets, as indices into the vertex arrays of
+     * this mesh. The array is mNumMeshletVertices in size.
+     */
+    unsigned int *mMeshletVertices;
+
+    /**
+     * The number of triangles of all meshlets.
+     */
+    unsigned int mNumMeshletTriangles;
+
+    /**
+     * The triangles of all meshlets, as three indices into the vertices of
+     * their meshlet each. The array is mNumMeshletTriangles * 3 in size.
+     */
+    unsigned char *mMeshletTriangles;
+
+    /**
+     * The number of levels of detail of this mesh.
+     */
+    unsigned int mNumLODs;
+
+    /**
+     * Simplified versions of this mesh, from the most to the least detailed.
+     * They are only generated on request, see the #AI_CONFIG_PP_LOD_GENERATE
+     * property, and are not part of aiScene::mMeshes. The array is mNumLODs
+     * in size.
+     */
+    aiMesh **mLODs;
+
 #ifdef __cplusplus
 
     //! The default class constructor.
@@ -810,7 +911,15 @@ struct aiMesh {
               mAnimMeshes(nullptr),
               mMethod(aiMorphingMethod_UNKNOWN),
               mAABB(),
-              mTextureCoordsNames(nullptr) {
+              mTextureCoordsNames(nullptr),
+              mNumMeshlets(0),
+              mMeshlets(nullptr),
+              mNumMeshletVertices(0),
+              mMeshletVertices(nullptr),
+              mNumMeshletTriangles(0),
+              mMeshletTriangles(nullptr),
+              mNumLODs(0),
+              mLODs(nullptr) {
         // empty
     }
 
@@ -849,6 +958,16 @@ struct aiMesh {
         }
 
         delete[] mFaces;
+        delete[] mMeshlets;
+        delete[] mMeshletVertices;
+        delete[] mMeshletTriangles;
+
+        if (mNumLODs && mLODs) {
+            for (unsigned int a = 0; a < mNumLODs; a++) {
+                delete mLODs[a];
+            }
+            delete[] mLODs;
+        }
     }
 
     //! @brief Check whether the mesh contains positions. Provided no special
@@ -908,6 +1027,18 @@ struct aiMesh {
         return mBones != nullptr && mNumBones > 0;
     }
 
+    //! @brief Check whether the mesh has been split into meshlets.
+    //! @return true, if meshlets are stored.
+    bool HasMeshlets() const {
+        return mMeshlets != nullptr && mNumMeshlets > 0;
+    }
+
+    //! @brief Check whether levels of detail have been generated for the mesh.
+    //! @return true, if levels of detail are stored.
+    bool HasLODs() const {
+        return mLODs != nullptr && mNumLODs > 0;
+    }
+
     //! @brief  Check whether the mesh contains a texture coordinate set name
     //! @param pIndex Index of the texture coordinates set
     //! @return true, if texture coordinates for the index exists.
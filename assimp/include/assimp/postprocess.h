@@ -247,6 +247,20 @@ enum aiPostProcessSteps
     */
     aiProcess_LimitBoneWeights = 0x200,
 
+    // -------------------------------------------------------------------------
+    /** <hr>Reorders triangles for better vertex cache locality.
+     *
+     * The step tries to improve the ACMR (average post-transform vertex cache
+     * miss ratio) for all meshes. The implementation uses Tom Forsyth's
+     * linear-speed vertex cache optimisation, the vertices are renumbered
+     * in the order of their first use afterwards.
+     *
+     * If you intend to render huge models in hardware, this step might
+     * be of interest to you. The <tt>#AI_CONFIG_PP_ICL_PTCACHE_SIZE</tt>
+     * importer property can be used to fine-tune the cache optimization.
+     */
+    aiProcess_ImproveCacheLocality = 0x800,
+
     // -------------------------------------------------------------------------
     /** <hr>Searches for redundant/unreferenced materials and removes them.
      *
@@ -557,7 +571,12 @@ enum aiPostProcessSteps
     aiProcess_DropNormals = 0x40000000,
 
     // -------------------------------------------------------------------------
-    /**
+    /** <hr>Generates the axis-aligned bounding box of each mesh (aiMesh::mAABB).
+     *
+     * If the <tt>#AI_CONFIG_PP_GBB_MESHLETS</tt> importer property is set, the
+     * triangles of each mesh are also partitioned into meshlets with bounding
+     * spheres and normal cones for cluster culling (aiMesh::mMeshlets).
+     * Specify #aiProcess_Triangulate as well, only triangle meshes are split.
      */
     aiProcess_GenBoundingBoxes = 0x80000000
 };
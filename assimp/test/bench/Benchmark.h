@@ -0,0 +1,82 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  Benchmark.h
+ *  @brief Timing helpers shared by the benchmarks.
+ *
+ *  Every benchmark takes an optional scale factor as its only argument. The default of one keeps
+ *  the inputs small enough for ctest, larger values reproduce the sizes the optimizations target.
+ */
+#pragma once
+#ifndef AI_BENCHMARK_H_INC
+#define AI_BENCHMARK_H_INC
+
+#include "UnitTest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace Assimp {
+namespace Bench {
+
+// ------------------------------------------------------------------------------------------------
+/** Reads the scale factor from the command line, defaults to one. */
+inline unsigned int GetScale(int argc, char *argv[]) {
+    const int scale = argc > 1 ? std::atoi(argv[1]) : 1;
+    return scale > 0 ? static_cast<unsigned int>(scale) : 1u;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Runs func once and prints its wall clock time, returns the time in milliseconds. */
+template <typename Func>
+double Measure(const char *name, Func func) {
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-48s %10.2f ms\n", name, ms);
+    return ms;
+}
+
+} // namespace Bench
+} // namespace Assimp
+
+#endif // AI_BENCHMARK_H_INC
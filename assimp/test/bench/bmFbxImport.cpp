@@ -0,0 +1,249 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  bmFbxImport.cpp
+ *  @brief Times the import of a binary FBX file made of many small objects, which is dominated by
+ *  tokenizing and building the DOM.
+ */
+
+#include "Benchmark.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace Assimp;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Node record of a binary FBX file, properties are stored already encoded
+struct Node {
+    std::string name;
+    std::string properties;
+    uint32_t numProperties = 0;
+    std::vector<Node> children;
+
+    explicit Node(const char *nodeName) :
+            name(nodeName) {}
+};
+
+// ------------------------------------------------------------------------------------------------
+template <typename T>
+void Append(std::string &out, T value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// ------------------------------------------------------------------------------------------------
+Node &AddInt(Node &node, int32_t value) {
+    node.properties += 'I';
+    Append(node.properties, value);
+    ++node.numProperties;
+    return node;
+}
+
+// ------------------------------------------------------------------------------------------------
+Node &AddLong(Node &node, int64_t value) {
+    node.properties += 'L';
+    Append(node.properties, value);
+    ++node.numProperties;
+    return node;
+}
+
+// ------------------------------------------------------------------------------------------------
+Node &AddDouble(Node &node, double value) {
+    node.properties += 'D';
+    Append(node.properties, value);
+    ++node.numProperties;
+    return node;
+}
+
+// ------------------------------------------------------------------------------------------------
+Node &AddString(Node &node, const std::string &value) {
+    node.properties += 'S';
+    Append(node.properties, static_cast<uint32_t>(value.size()));
+    node.properties += value;
+    ++node.numProperties;
+    return node;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Uncompressed array property of doubles ('d') or ints ('i')
+template <typename T>
+Node &AddArray(Node &node, char type, const std::vector<T> &values) {
+    node.properties += type;
+    Append(node.properties, static_cast<uint32_t>(values.size()));
+    Append(node.properties, static_cast<uint32_t>(0));
+    Append(node.properties, static_cast<uint32_t>(values.size() * sizeof(T)));
+    node.properties.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+    ++node.numProperties;
+    return node;
+}
+
+// ------------------------------------------------------------------------------------------------
+Node &AddChild(Node &node, const char *name) {
+    node.children.emplace_back(name);
+    return node.children.back();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Writes a node record of FBX 7.4, which uses 32 bit offsets
+void Write(std::string &out, const Node &node) {
+    const size_t start = out.size();
+    Append(out, static_cast<uint32_t>(0));
+    Append(out, node.numProperties);
+    Append(out, static_cast<uint32_t>(node.properties.size()));
+    out += static_cast<char>(node.name.size());
+    out += node.name;
+    out += node.properties;
+    for (const Node &child : node.children) {
+        Write(out, child);
+    }
+    if (!node.children.empty()) {
+        out.append(13, '\0');
+    }
+    const uint32_t end = static_cast<uint32_t>(out.size());
+    std::memcpy(&out[start], &end, sizeof(end));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Adds a Properties70 entry with a vector value
+void AddVectorProperty(Node &properties, const char *name, const char *type, double x, double y, double z) {
+    Node &p = AddChild(properties, "P");
+    AddString(p, name);
+    AddString(p, type);
+    AddString(p, "");
+    AddString(p, "A");
+    AddDouble(p, x);
+    AddDouble(p, y);
+    AddDouble(p, z);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Builds a binary FBX file with one model, geometry and material per object
+std::string MakeBinaryFbx(unsigned int numObjects, unsigned int numTriangles) {
+    Node header("FBXHeaderExtension");
+    AddInt(AddChild(header, "FBXHeaderVersion"), 1003);
+    AddInt(AddChild(header, "FBXVersion"), 7400);
+
+    Node objects("Objects");
+    Node connections("Connections");
+    std::vector<double> vertices, normals;
+    std::vector<int32_t> indices;
+    for (unsigned int t = 0; t < numTriangles; ++t) {
+        const double corners[9] = { 0, 0, 0, 1, 0, 0, 0, 1, 0 };
+        for (unsigned int c = 0; c < 9; ++c) {
+            vertices.push_back(corners[c] + t);
+            normals.push_back(c % 3 == 2 ? 1.0 : 0.0);
+        }
+        indices.push_back(3 * t);
+        indices.push_back(3 * t + 1);
+        indices.push_back(-static_cast<int32_t>(3 * t + 2) - 1);
+    }
+
+    for (unsigned int o = 0; o < numObjects; ++o) {
+        const int64_t geometryId = 1000 + o * 10, modelId = geometryId + 1, materialId = geometryId + 2;
+        const std::string index = std::to_string(o);
+
+        Node &geometry = AddChild(objects, "Geometry");
+        AddString(AddString(AddLong(geometry, geometryId), "mesh" + index + std::string("\0\1Geometry", 10)), "Mesh");
+        AddArray(AddChild(geometry, "Vertices"), 'd', vertices);
+        AddArray(AddChild(geometry, "PolygonVertexIndex"), 'i', indices);
+        AddInt(AddChild(geometry, "GeometryVersion"), 124);
+        Node &normalLayer = AddInt(AddChild(geometry, "LayerElementNormal"), 0);
+        AddInt(AddChild(normalLayer, "Version"), 101);
+        AddString(AddChild(normalLayer, "Name"), "");
+        AddString(AddChild(normalLayer, "MappingInformationType"), "ByPolygonVertex");
+        AddString(AddChild(normalLayer, "ReferenceInformationType"), "Direct");
+        AddArray(AddChild(normalLayer, "Normals"), 'd', normals);
+        Node &layer = AddInt(AddChild(geometry, "Layer"), 0);
+        AddInt(AddChild(layer, "Version"), 100);
+        Node &layerElement = AddChild(layer, "LayerElement");
+        AddString(AddChild(layerElement, "Type"), "LayerElementNormal");
+        AddInt(AddChild(layerElement, "TypedIndex"), 0);
+
+        Node &model = AddChild(objects, "Model");
+        AddString(AddString(AddLong(model, modelId), "model" + index + std::string("\0\1Model", 7)), "Mesh");
+        AddInt(AddChild(model, "Version"), 232);
+        AddVectorProperty(AddChild(model, "Properties70"), "Lcl Translation", "Lcl Translation", o * 10.0, 0, 0);
+
+        Node &material = AddChild(objects, "Material");
+        AddString(AddString(AddLong(material, materialId), "mat" + index + std::string("\0\1Material", 10)), "");
+        AddInt(AddChild(material, "Version"), 102);
+        AddString(AddChild(material, "ShadingModel"), "phong");
+        AddVectorProperty(AddChild(material, "Properties70"), "DiffuseColor", "Color", 0.5, 0.5, 0.5);
+
+        AddLong(AddLong(AddString(AddChild(connections, "C"), "OO"), modelId), 0);
+        AddLong(AddLong(AddString(AddChild(connections, "C"), "OO"), geometryId), modelId);
+        AddLong(AddLong(AddString(AddChild(connections, "C"), "OO"), materialId), modelId);
+    }
+
+    std::string fbx("Kaydara FBX Binary  \0\x1a\0", 23);
+    Append(fbx, static_cast<uint32_t>(7400));
+    Write(fbx, header);
+    Write(fbx, objects);
+    Write(fbx, connections);
+    fbx.append(13 + 160, '\0');
+    return fbx;
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+int main(int argc, char *argv[]) {
+    const unsigned int scale = Bench::GetScale(argc, argv);
+    const unsigned int numObjects = 2000 * scale;
+    const std::string fbx = MakeBinaryFbx(numObjects, 16);
+    std::printf("binary FBX file of %u KB with %u objects\n", static_cast<unsigned int>(fbx.size() >> 10), numObjects);
+
+    const aiScene *scene = nullptr;
+    Importer importer;
+    Bench::Measure("FBX tokenizer, parser and converter", [&]() {
+        scene = importer.ReadFileFromMemory(fbx.data(), fbx.size(), 0, "fbx");
+    });
+
+    AI_TEST_CHECK(nullptr != scene);
+    AI_TEST_CHECK(nullptr != scene && numObjects == scene->mNumMeshes);
+    return Test::Failures() ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  bmMaterialLookup.cpp
+ *  @brief Times property lookups on many materials, scanning the property list and using the
+ *  property index. Lookups of missing keys fall back to the scan, so they are timed apart.
+ */
+
+#include "Benchmark.h"
+
+#include <assimp/material.h>
+
+#include <memory>
+#include <vector>
+
+using namespace Assimp;
+
+namespace {
+
+// Properties per material and lookups per material, about as many as a material translation does
+const unsigned int NumProperties = 48;
+const unsigned int NumLookups = 40;
+
+// ------------------------------------------------------------------------------------------------
+std::string GetKey(unsigned int i) {
+    return "$bench.property" + std::to_string(i);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Looks up NumLookups keys starting at the given one, returns the sum of all values found
+double LookUpAll(const std::vector<std::unique_ptr<aiMaterial>> &materials, const std::vector<std::string> &keys,
+        unsigned int first) {
+    double sum = 0;
+    for (const auto &material : materials) {
+        for (unsigned int i = first; i < first + NumLookups; ++i) {
+            float value = 0.f;
+            if (AI_SUCCESS == material->Get(keys[i].c_str(), 0, 0, value)) {
+                sum += value + 1;
+            }
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+int main(int argc, char *argv[]) {
+    const unsigned int scale = Bench::GetScale(argc, argv);
+    const unsigned int numMaterials = 10000 * scale;
+
+    // the first NumProperties keys exist, the last NumLookups ones don't
+    std::vector<std::string> keys;
+    for (unsigned int i = 0; i < NumProperties + NumLookups; ++i) {
+        keys.push_back(GetKey(i));
+    }
+    std::vector<std::unique_ptr<aiMaterial>> materials;
+    for (unsigned int m = 0; m < numMaterials; ++m) {
+        materials.emplace_back(new aiMaterial);
+        for (unsigned int i = 0; i < NumProperties; ++i) {
+            const float value = static_cast<float>(i);
+            materials.back()->AddProperty(&value, 1, keys[i].c_str(), 0, 0);
+        }
+    }
+
+    double scanned[2] = {}, indexed[2] = {};
+    Bench::Measure("aiMaterial::Get hits scanning the properties", [&]() {
+        scanned[0] = LookUpAll(materials, keys, 0);
+    });
+    Bench::Measure("aiMaterial::Get misses scanning the properties", [&]() {
+        scanned[1] = LookUpAll(materials, keys, NumProperties);
+    });
+    Bench::Measure("aiMaterial::BuildPropertyIndex", [&]() {
+        for (const auto &material : materials) {
+            material->BuildPropertyIndex();
+        }
+    });
+    Bench::Measure("aiMaterial::Get hits using the property index", [&]() {
+        indexed[0] = LookUpAll(materials, keys, 0);
+    });
+    Bench::Measure("aiMaterial::Get misses using the property index", [&]() {
+        indexed[1] = LookUpAll(materials, keys, NumProperties);
+    });
+
+    AI_TEST_CHECK(nullptr != materials[0]->mPropertyIndex);
+    AI_TEST_CHECK(0 != scanned[0] && scanned[0] == indexed[0]);
+    AI_TEST_CHECK(0 == scanned[1] && 0 == indexed[1]);
+    return Test::Failures() ? 1 : 0;
+}
@@ -0,0 +1,103 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  bmObjImport.cpp
+ *  @brief Times the OBJ import of a large file on one thread, in parallel chunks and streamed.
+ *
+ *  The peak heap usage of the streamed import is checked by utObjStreaming.
+ */
+
+#include "Benchmark.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <thread>
+
+using namespace Assimp;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Total number of faces, to check the imports against each other
+unsigned int CountFaces(const aiScene *scene) {
+    unsigned int numFaces = 0;
+    for (unsigned int i = 0; nullptr != scene && i < scene->mNumMeshes; ++i) {
+        numFaces += scene->mMeshes[i]->mNumFaces;
+    }
+    return numFaces;
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+int main(int argc, char *argv[]) {
+    const unsigned int scale = Bench::GetScale(argc, argv);
+    const std::string obj = Test::MakeGridObj(32 * scale, 64);
+    std::printf("OBJ file of %u MB\n", static_cast<unsigned int>(obj.size() >> 20));
+
+    // at least two threads, so the chunked parser runs on single core machines as well
+    const int numThreads = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+
+    unsigned int numFaces[3] = {};
+    Bench::Measure("ObjFileParser on one thread", [&]() {
+        Importer importer;
+        numFaces[0] = CountFaces(importer.ReadFileFromMemory(obj.data(), obj.size(), 0, "obj"));
+    });
+    char name[64];
+    std::snprintf(name, sizeof(name), "ObjFileParser in chunks on %d threads", numThreads);
+    Bench::Measure(name, [&]() {
+        Importer importer;
+        importer.SetPropertyInteger(AI_CONFIG_IMPORT_OBJ_NUM_THREADS, numThreads);
+        numFaces[1] = CountFaces(importer.ReadFileFromMemory(obj.data(), obj.size(), 0, "obj"));
+    });
+    Bench::Measure("ObjFileImporter streaming its meshes", [&]() {
+        Importer importer;
+        importer.SetPropertyBool(AI_CONFIG_IMPORT_OBJ_STREAMING, true);
+        numFaces[2] = CountFaces(importer.ReadFileFromMemory(obj.data(), obj.size(), 0, "obj"));
+    });
+
+    AI_TEST_CHECK(0 != numFaces[0]);
+    AI_TEST_CHECK(numFaces[0] == numFaces[1] && numFaces[0] == numFaces[2]);
+    return Test::Failures() ? 1 : 0;
+}
@@ -0,0 +1,171 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  bmPostProcessing.cpp
+ *  @brief Times the post-processing steps on the large inputs they were optimized for: many
+ *  instanced meshes, levels of detail, normals of flat meshes and polygons with many vertices.
+ */
+
+#include "Benchmark.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <cmath>
+
+using namespace Assimp;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Objects which all use the faces of the same size x size grid
+std::string MakeInstancedObj(unsigned int numObjects, unsigned int size) {
+    std::string obj, faces;
+    char line[128];
+    for (unsigned int y = 0; y <= size; ++y) {
+        for (unsigned int x = 0; x <= size; ++x) {
+            std::snprintf(line, sizeof(line), "v %u %u 0\n", x, y);
+            obj += line;
+        }
+    }
+    for (unsigned int y = 0; y < size; ++y) {
+        for (unsigned int x = 0; x < size; ++x) {
+            const unsigned int v = 1 + y * (size + 1) + x;
+            std::snprintf(line, sizeof(line), "f %u %u %u %u\n", v, v + 1, v + size + 2, v + size + 1);
+            faces += line;
+        }
+    }
+    for (unsigned int o = 0; o < numObjects; ++o) {
+        std::snprintf(line, sizeof(line), "o instance%u\n", o);
+        obj += line;
+        obj += faces;
+    }
+    return obj;
+}
+
+// ------------------------------------------------------------------------------------------------
+// A single star shaped, and thus concave, polygon. Close to one, the inner radius gives a round
+// outline with small teeth, smaller values give long spikes whose ears span large bounding boxes.
+std::string MakeStarObj(unsigned int numVertices, double innerRadius) {
+    std::string obj, face = "f";
+    char line[128];
+    for (unsigned int i = 0; i < numVertices; ++i) {
+        const double angle = 2.0 * 3.14159265358979 * i / numVertices;
+        const double radius = (i & 1) ? innerRadius : 1.0;
+        std::snprintf(line, sizeof(line), "v %f %f 0\n", radius * std::cos(angle), radius * std::sin(angle));
+        obj += line;
+        face += ' ' + std::to_string(i + 1);
+    }
+    return obj + face + '\n';
+}
+
+// ------------------------------------------------------------------------------------------------
+// Imports obj without post-processing and times the given steps on it
+const aiScene *MeasureSteps(Importer &importer, const char *name, const std::string &obj, unsigned int steps) {
+    const aiScene *scene = importer.ReadFileFromMemory(obj.data(), obj.size(), 0, "obj");
+    AI_TEST_CHECK(nullptr != scene);
+    if (nullptr == scene) {
+        return nullptr;
+    }
+    Bench::Measure(name, [&]() {
+        scene = importer.ApplyPostProcessing(steps);
+    });
+    AI_TEST_CHECK(nullptr != scene);
+    return scene;
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeasureFindInstances(unsigned int scale) {
+    Importer importer;
+    const unsigned int numObjects = 5000 * scale;
+    const aiScene *scene = MeasureSteps(importer, "FindInstances on identical meshes",
+            MakeInstancedObj(numObjects, 4), aiProcess_FindInstances);
+    if (nullptr != scene) {
+        // all nodes refer to the first mesh
+        AI_TEST_CHECK(1 == scene->mNumMeshes);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeasureLODs(unsigned int scale) {
+    Importer importer;
+    importer.SetPropertyBool(AI_CONFIG_PP_LOD_GENERATE, true);
+    importer.SetPropertyString(AI_CONFIG_PP_LOD_RATIOS, "0.5 0.25 0.125");
+    const aiScene *scene = MeasureSteps(importer, "GenLODs with three levels",
+            Test::MakeGridObj(8 * scale, 64), aiProcess_JoinIdenticalVertices | aiProcess_Triangulate);
+    if (nullptr != scene) {
+        AI_TEST_CHECK(3 == scene->mMeshes[0]->mNumLODs);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeasureFlatNormals(unsigned int scale) {
+    Importer importer;
+    const aiScene *scene = MeasureSteps(importer, "GenSmoothNormals on flat grids",
+            Test::MakeGridObj(4 * scale, 128), aiProcess_GenSmoothNormals);
+    if (nullptr != scene) {
+        AI_TEST_CHECK(scene->mMeshes[0]->HasNormals());
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeasureLargePolygon(const char *name, unsigned int numVertices, double innerRadius) {
+    Importer importer;
+    const aiScene *scene = MeasureSteps(importer, name, MakeStarObj(numVertices, innerRadius), aiProcess_Triangulate);
+    if (nullptr != scene) {
+        AI_TEST_CHECK(numVertices - 2 == scene->mMeshes[0]->mNumFaces);
+    }
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+int main(int argc, char *argv[]) {
+    const unsigned int scale = Bench::GetScale(argc, argv);
+    MeasureFindInstances(scale);
+    MeasureLODs(scale);
+    MeasureFlatNormals(scale);
+    MeasureLargePolygon("Triangulate a round polygon with small teeth", 20000 * scale, 0.99);
+    MeasureLargePolygon("Triangulate a star with long spikes", 20000 * scale, 0.5);
+    return Test::Failures() ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  bmSceneCombiner.cpp
+ *  @brief Times SceneCombiner::MergeScenes on thousands of small tiles with colliding names.
+ */
+
+#include "Benchmark.h"
+
+#include <assimp/SceneCombiner.h>
+#include <assimp/scene.h>
+
+#include <memory>
+#include <vector>
+
+using namespace Assimp;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// A tile with one triangle below a named node, every tile uses the same names
+aiScene *MakeTile() {
+    aiScene *scene = new aiScene;
+    scene->mRootNode = new aiNode("tile");
+    aiNode *part = new aiNode("part");
+    scene->mRootNode->addChildren(1, &part);
+    part->mNumMeshes = 1;
+    part->mMeshes = new unsigned int[1]{ 0 };
+
+    aiMesh *mesh = new aiMesh;
+    mesh->mName.Set("mesh");
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    mesh->mNumVertices = 3;
+    mesh->mVertices = new aiVector3D[3]{ aiVector3D(0, 0, 0), aiVector3D(1, 0, 0), aiVector3D(0, 1, 0) };
+    mesh->mNumFaces = 1;
+    mesh->mFaces = new aiFace[1];
+    mesh->mFaces[0].mNumIndices = 3;
+    mesh->mFaces[0].mIndices = new unsigned int[3]{ 0, 1, 2 };
+    scene->mNumMeshes = 1;
+    scene->mMeshes = new aiMesh *[1]{ mesh };
+
+    aiMaterial *material = new aiMaterial;
+    const aiString name("material");
+    material->AddProperty(&name, AI_MATKEY_NAME);
+    scene->mNumMaterials = 1;
+    scene->mMaterials = new aiMaterial *[1]{ material };
+    return scene;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Merges numTiles copies of the tile, returns the number of nodes below the root of the result
+unsigned int MeasureMerge(const char *name, const aiScene *tile, unsigned int numTiles, unsigned int flags) {
+    std::vector<aiScene *> tiles(numTiles, nullptr);
+    for (aiScene *&copy : tiles) {
+        SceneCombiner::CopyScene(&copy, tile);
+    }
+
+    aiScene *merged = nullptr;
+    Bench::Measure(name, [&]() {
+        SceneCombiner::MergeScenes(&merged, tiles, flags);
+    });
+    const std::unique_ptr<aiScene> result(merged);
+    AI_TEST_CHECK(nullptr != merged && numTiles == merged->mNumMeshes);
+    return nullptr != merged ? merged->mRootNode->mNumChildren : 0;
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+int main(int argc, char *argv[]) {
+    const unsigned int scale = Bench::GetScale(argc, argv);
+    const unsigned int numTiles = 10000 * scale;
+    const std::unique_ptr<aiScene> tile(MakeTile());
+
+    const unsigned int flags = AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES | AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES_IF_NECESSARY;
+    const unsigned int serial = MeasureMerge("SceneCombiner::MergeScenes", tile.get(), numTiles, flags);
+    const unsigned int parallel = MeasureMerge("SceneCombiner::MergeScenes in parallel", tile.get(), numTiles,
+            flags | AI_INT_MERGE_SCENE_PARALLEL);
+
+    AI_TEST_CHECK(numTiles == serial && serial == parallel);
+    return Test::Failures() ? 1 : 0;
+}
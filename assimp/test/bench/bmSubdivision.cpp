@@ -0,0 +1,107 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  bmSubdivision.cpp
+ *  @brief Times Catmull-Clark subdivision of many patches, one mesh at a time and all meshes in
+ *  a single call. The single call refines the meshes as one surface, so shared edges of
+ *  neighbouring meshes are smoothed as well.
+ */
+
+#include "Benchmark.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/Subdivision.h>
+#include <assimp/scene.h>
+
+#include <memory>
+#include <vector>
+
+using namespace Assimp;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Deletes the meshes and returns their total number of faces
+unsigned int ReleaseMeshes(std::vector<aiMesh *> &meshes) {
+    unsigned int numFaces = 0;
+    for (aiMesh *mesh : meshes) {
+        numFaces += nullptr != mesh ? mesh->mNumFaces : 0;
+        delete mesh;
+    }
+    meshes.clear();
+    return numFaces;
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+int main(int argc, char *argv[]) {
+    const unsigned int scale = Bench::GetScale(argc, argv);
+    const unsigned int levels = 2;
+
+    // without joining vertices the OBJ importer returns meshes in verbose format
+    const std::string obj = Test::MakeGridObj(256 * scale, 8);
+    Importer importer;
+    const aiScene *scene = importer.ReadFileFromMemory(obj.data(), obj.size(), 0, "obj");
+    AI_TEST_CHECK(nullptr != scene);
+    if (nullptr == scene) {
+        return 1;
+    }
+
+    std::unique_ptr<Subdivider> subdivider(Subdivider::Create(Subdivider::CATMULL_CLARKE));
+    std::vector<aiMesh *> out(scene->mNumMeshes, nullptr);
+    Bench::Measure("Subdivider one mesh at a time", [&]() {
+        for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+            subdivider->Subdivide(scene->mMeshes[i], out[i], levels);
+        }
+    });
+    const unsigned int numFaces = ReleaseMeshes(out);
+
+    out.resize(scene->mNumMeshes, nullptr);
+    Bench::Measure("Subdivider all meshes in one call", [&]() {
+        subdivider->Subdivide(scene->mMeshes, scene->mNumMeshes, out.data(), levels);
+    });
+
+    // every level splits each quad into four
+    AI_TEST_CHECK(scene->mNumMeshes * 8 * 8 * 16 == numFaces);
+    AI_TEST_CHECK(numFaces == ReleaseMeshes(out));
+    return Test::Failures() ? 1 : 0;
+}
@@ -0,0 +1,104 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  UnitTest.h
+ *  @brief Minimal checks shared by the unit tests.
+ */
+#pragma once
+#ifndef AI_UNITTEST_H_INC
+#define AI_UNITTEST_H_INC
+
+#include <cstdio>
+#include <string>
+
+namespace Assimp {
+namespace Test {
+
+// ------------------------------------------------------------------------------------------------
+/** Number of failed checks, returned by main(). */
+inline int &Failures() {
+    static int failures = 0;
+    return failures;
+}
+
+// ------------------------------------------------------------------------------------------------
+inline void Check(bool condition, const char *expression, const char *file, int line) {
+    if (!condition) {
+        std::fprintf(stderr, "%s(%d): check failed: %s\n", file, line, expression);
+        ++Failures();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Builds an OBJ file with a grid of size x size quads per object. */
+inline std::string MakeGridObj(unsigned int numObjects, unsigned int size) {
+    std::string obj;
+    char line[128];
+    unsigned int base = 1;
+    for (unsigned int o = 0; o < numObjects; ++o) {
+        std::snprintf(line, sizeof(line), "o grid%u\n", o);
+        obj += line;
+        for (unsigned int y = 0; y <= size; ++y) {
+            for (unsigned int x = 0; x <= size; ++x) {
+                // a gentle bump, so the simplifier has something to keep
+                const float h = static_cast<float>((x * 7 + y * 13) % 5) * 0.01f;
+                std::snprintf(line, sizeof(line), "v %u %u %f\n", x + o * (size + 2), y, h);
+                obj += line;
+            }
+        }
+        for (unsigned int y = 0; y < size; ++y) {
+            for (unsigned int x = 0; x < size; ++x) {
+                const unsigned int v = base + y * (size + 1) + x;
+                std::snprintf(line, sizeof(line), "f %u %u %u %u\n", v, v + 1, v + size + 2, v + size + 1);
+                obj += line;
+            }
+        }
+        base += (size + 1) * (size + 1);
+    }
+    return obj;
+}
+
+} // namespace Test
+} // namespace Assimp
+
+#define AI_TEST_CHECK(expression) ::Assimp::Test::Check((expression), #expression, __FILE__, __LINE__)
+
+#endif // AI_UNITTEST_H_INC
@@ -0,0 +1,148 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  utGenLODs.cpp
+ *  @brief Checks the levels of detail generated with AI_CONFIG_PP_LOD_GENERATE.
+ */
+
+#include "UnitTest.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <vector>
+
+using namespace Assimp;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Face and vertex counts plus a coordinate sum of every level of every mesh
+std::vector<double> GetLODSignature(const aiScene *scene) {
+    std::vector<double> signature;
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        const aiMesh *mesh = scene->mMeshes[i];
+        signature.push_back(mesh->mNumLODs);
+        for (unsigned int l = 0; l < mesh->mNumLODs; ++l) {
+            const aiMesh *lod = mesh->mLODs[l];
+            signature.push_back(lod->mNumFaces);
+            signature.push_back(lod->mNumVertices);
+            double sum = 0;
+            for (unsigned int v = 0; v < lod->mNumVertices; ++v) {
+                sum += lod->mVertices[v].x + 2 * lod->mVertices[v].y + 3 * lod->mVertices[v].z;
+            }
+            signature.push_back(sum);
+        }
+    }
+    return signature;
+}
+
+// ------------------------------------------------------------------------------------------------
+void TestDisabledByDefault(const std::string &obj) {
+    Importer importer;
+    const aiScene *scene = importer.ReadFileFromMemory(obj.data(), obj.size(),
+            aiProcess_JoinIdenticalVertices | aiProcess_Triangulate, "obj");
+    AI_TEST_CHECK(nullptr != scene);
+    if (nullptr == scene) {
+        return;
+    }
+    AI_TEST_CHECK(2 == scene->mNumMeshes);
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        AI_TEST_CHECK(!scene->mMeshes[i]->HasLODs());
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void TestLODsStayOutOfMeshList(const std::string &obj) {
+    Importer importer;
+    importer.SetPropertyBool(AI_CONFIG_PP_LOD_GENERATE, true);
+    importer.SetPropertyString(AI_CONFIG_PP_LOD_RATIOS, "0.5 0.25");
+    const aiScene *scene = importer.ReadFileFromMemory(obj.data(), obj.size(),
+            aiProcess_JoinIdenticalVertices | aiProcess_Triangulate, "obj");
+    AI_TEST_CHECK(nullptr != scene);
+    if (nullptr == scene) {
+        return;
+    }
+
+    AI_TEST_CHECK(2 == scene->mNumMeshes);
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        const aiMesh *mesh = scene->mMeshes[i];
+        AI_TEST_CHECK(2 == mesh->mNumLODs);
+        if (2 != mesh->mNumLODs) {
+            continue;
+        }
+        AI_TEST_CHECK(mesh->mLODs[0]->mNumFaces < mesh->mNumFaces);
+        AI_TEST_CHECK(mesh->mLODs[1]->mNumFaces < mesh->mLODs[0]->mNumFaces);
+        AI_TEST_CHECK(!mesh->mLODs[0]->HasLODs() && !mesh->mLODs[1]->HasLODs());
+        AI_TEST_CHECK(mesh->mLODs[0]->mMaterialIndex == mesh->mMaterialIndex);
+    }
+    const std::vector<double> signature = GetLODSignature(scene);
+
+    // running the post-processing again must not build levels of levels
+    scene = importer.ApplyPostProcessing(aiProcess_Triangulate);
+    AI_TEST_CHECK(nullptr != scene);
+    if (nullptr == scene) {
+        return;
+    }
+    AI_TEST_CHECK(2 == scene->mNumMeshes);
+    AI_TEST_CHECK(GetLODSignature(scene) == signature);
+
+    // the property alone requests the step
+    scene = importer.ApplyPostProcessing(0);
+    AI_TEST_CHECK(nullptr != scene);
+    if (nullptr == scene) {
+        return;
+    }
+    AI_TEST_CHECK(2 == scene->mNumMeshes);
+    AI_TEST_CHECK(GetLODSignature(scene) == signature);
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+int main() {
+    const std::string obj = Test::MakeGridObj(2, 24);
+    TestDisabledByDefault(obj);
+    TestLODsStayOutOfMeshList(obj);
+    return Test::Failures() ? 1 : 0;
+}
@@ -0,0 +1,244 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2022, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  utObjStreaming.cpp
+ *  @brief Checks that AI_CONFIG_IMPORT_OBJ_STREAMING produces the same meshes as a regular
+ *  OBJ import and that it lowers the peak heap usage of the import.
+ */
+
+#include "UnitTest.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
+#include <assimp/scene.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+using namespace Assimp;
+
+namespace {
+
+// Bytes currently allocated through the global operator new, and their maximum
+size_t gHeapSize = 0;
+size_t gHeapPeak = 0;
+
+// Keeps the size in front of every block, padded to the strictest alignment
+constexpr size_t HeaderSize = alignof(std::max_align_t);
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+void *operator new(size_t size) {
+    char *block = static_cast<char *>(std::malloc(size + HeaderSize));
+    if (nullptr == block) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t *>(block) = size;
+    gHeapSize += size;
+    if (gHeapSize > gHeapPeak) {
+        gHeapPeak = gHeapSize;
+    }
+    return block + HeaderSize;
+}
+
+// ------------------------------------------------------------------------------------------------
+void operator delete(void *ptr) noexcept {
+    if (nullptr == ptr) {
+        return;
+    }
+    char *block = static_cast<char *>(ptr) - HeaderSize;
+    gHeapSize -= *reinterpret_cast<size_t *>(block);
+    std::free(block);
+}
+
+// ------------------------------------------------------------------------------------------------
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+// ------------------------------------------------------------------------------------------------
+void operator delete[](void *ptr) noexcept {
+    operator delete(ptr);
+}
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+const aiScene *ReadObj(Importer &importer, const std::string &obj, bool streaming) {
+    importer.SetPropertyBool(AI_CONFIG_IMPORT_OBJ_STREAMING, streaming);
+    return importer.ReadFileFromMemory(obj.data(), obj.size(), 0, "obj");
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SameVectors(const aiVector3D *a, const aiVector3D *b, unsigned int count) {
+    if (nullptr == a || nullptr == b) {
+        return a == b;
+    }
+    for (unsigned int i = 0; i < count; ++i) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void CheckSameMeshes(const aiScene *expected, const aiScene *actual) {
+    AI_TEST_CHECK(expected->mNumMeshes == actual->mNumMeshes);
+    if (expected->mNumMeshes != actual->mNumMeshes) {
+        return;
+    }
+    for (unsigned int i = 0; i < expected->mNumMeshes; ++i) {
+        const aiMesh *a = expected->mMeshes[i];
+        const aiMesh *b = actual->mMeshes[i];
+        AI_TEST_CHECK(a->mName == b->mName);
+        AI_TEST_CHECK(a->mMaterialIndex == b->mMaterialIndex);
+        AI_TEST_CHECK(a->mPrimitiveTypes == b->mPrimitiveTypes);
+        AI_TEST_CHECK(a->mNumVertices == b->mNumVertices);
+        AI_TEST_CHECK(a->mNumFaces == b->mNumFaces);
+        if (a->mNumVertices != b->mNumVertices || a->mNumFaces != b->mNumFaces) {
+            continue;
+        }
+        AI_TEST_CHECK(SameVectors(a->mVertices, b->mVertices, a->mNumVertices));
+        AI_TEST_CHECK(SameVectors(a->mNormals, b->mNormals, a->mNumVertices));
+        AI_TEST_CHECK(SameVectors(a->mTextureCoords[0], b->mTextureCoords[0], a->mNumVertices));
+        AI_TEST_CHECK(a->mNumUVComponents[0] == b->mNumUVComponents[0]);
+        for (unsigned int f = 0; f < a->mNumFaces; ++f) {
+            const aiFace &fa = a->mFaces[f];
+            const aiFace &fb = b->mFaces[f];
+            AI_TEST_CHECK(fa.mNumIndices == fb.mNumIndices);
+            for (unsigned int n = 0; n < fa.mNumIndices && n < fb.mNumIndices; ++n) {
+                AI_TEST_CHECK(fa.mIndices[n] == fb.mIndices[n]);
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// The first object is complete before any normal or 2D texture coordinate is read, the second
+// one refers to a normal defined after it and the third one uses both.
+void TestLateNormalsAndUVDimension() {
+    static const std::string obj =
+            "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+            "vt 0\nvt 0.25\nvt 0.5\nvt 1\n"
+            "o flat\n"
+            "f 1/1 2/2 3/3 4/4\n"
+            "g forward\n"
+            "f 1/1/1 2/2/1 3/3/1\n"
+            "vn 0 0 1\n"
+            "vt 0.5 0.5\n"
+            "o volume\n"
+            "f 1/5/1 3/1/1 4/4/1\n";
+
+    Importer regular, streamed;
+    const aiScene *expected = ReadObj(regular, obj, false);
+    const aiScene *actual = ReadObj(streamed, obj, true);
+    AI_TEST_CHECK(nullptr != expected && nullptr != actual);
+    if (nullptr == expected || nullptr == actual) {
+        return;
+    }
+    AI_TEST_CHECK(3 == expected->mNumMeshes);
+    CheckSameMeshes(expected, actual);
+}
+
+// ------------------------------------------------------------------------------------------------
+// The streaming import reads the file in blocks of 1 MB, a line continuation may end the first one
+void TestContinuationAtBlockEnd() {
+    const size_t blockSize = 1024 * 1024;
+    const std::string continued = "vn 0 0 \\\n1\n";
+    const std::string padding = "# padding padding padding padding padding padding padding padding\n";
+    const size_t length = blockSize - 1 - continued.find('\\');
+
+    std::string obj = "v 0 0 0\nv 1 0 0\nv 1 1 0\n";
+    while (obj.size() + padding.size() + 2 <= length) {
+        obj += padding;
+    }
+    obj += '#';
+    obj.append(length - obj.size() - 1, ' ');
+    obj += '\n';
+    obj += continued;
+    obj += "f 1//1 2//1 3//1\n";
+
+    Importer regular, streamed;
+    const aiScene *expected = ReadObj(regular, obj, false);
+    const aiScene *actual = ReadObj(streamed, obj, true);
+    AI_TEST_CHECK(nullptr != expected && nullptr != actual);
+    if (nullptr == expected || nullptr == actual) {
+        return;
+    }
+    AI_TEST_CHECK(1 == expected->mNumMeshes && expected->mMeshes[0]->HasNormals());
+    AI_TEST_CHECK(aiVector3D(0, 0, 1) == expected->mMeshes[0]->mNormals[0]);
+    CheckSameMeshes(expected, actual);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Peak heap usage of an import, the scene itself stays alive until the importer is destroyed
+size_t MeasurePeakHeap(const std::string &obj, bool streaming) {
+    Importer importer;
+    const size_t before = gHeapSize;
+    gHeapPeak = gHeapSize;
+    AI_TEST_CHECK(nullptr != ReadObj(importer, obj, streaming));
+    return gHeapPeak - before;
+}
+
+// ------------------------------------------------------------------------------------------------
+void TestPeakHeap() {
+    const std::string obj = Test::MakeGridObj(256, 32);
+    const size_t regular = MeasurePeakHeap(obj, false);
+    const size_t streamed = MeasurePeakHeap(obj, true);
+    std::printf("peak heap of a %u KiB OBJ import: %u KiB regular, %u KiB streamed\n",
+            static_cast<unsigned int>(obj.size() / 1024),
+            static_cast<unsigned int>(regular / 1024),
+            static_cast<unsigned int>(streamed / 1024));
+    AI_TEST_CHECK(streamed < regular);
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+int main() {
+    TestLateNormalsAndUVDimension();
+    TestContinuationAtBlockEnd();
+    TestPeakHeap();
+    return Test::Failures() ? 1 : 0;
+}